@@ -0,0 +1,99 @@
+Import('env')
+import os
+import re
+
+# WLEDMM expand all built-in gradient palettes (wled00/palettes.h) into ready-to-use CRGBPalette16 tables.
+# Segment::loadPalette() then only needs a 48 byte memcpy_P instead of loadDynamicGradientPalette() on every frame.
+# The expansion replicates FastLED CRGBPalette16::loadDynamicGradientPalette() and fill_gradient_RGB().
+
+SOURCE_FILE = "wled00/palettes.h"
+OUTPUT_FILE = "wled00/palettes_expanded.h"
+MAX_GRADIENT_BYTES = 72  # Segment::loadPalette() copies at most 72 bytes (18 entries)
+
+
+def parse_palettes(text):
+    text = re.sub(r"//[^\n]*", "", text)  # strip comments
+    arrays = {}
+    for name, body in re.findall(r"const\s+byte\s+(\w+)\s*\[\]\s*PROGMEM\s*=\s*\{(.*?)\}\s*;", text, re.S):
+        arrays[name] = [int(v, 0) for v in re.findall(r"0x[0-9a-fA-F]+|\d+", body)]
+    table = re.search(r"gGradientPalettes\s*\[\]\s*PROGMEM\s*=\s*\{(.*?)\}\s*;", text, re.S)
+    order = re.findall(r"(\w+)", table.group(1))
+    return arrays, order
+
+
+def fill_gradient_rgb(entries, startpos, startcolor, endpos, endcolor):
+    if endpos < startpos:
+        startpos, endpos = endpos, startpos
+        startcolor, endcolor = endcolor, startcolor
+    divisor = (endpos - startpos) or 1
+    deltas = []
+    for c in range(3):
+        distance87 = (endcolor[c] - startcolor[c]) << 7
+        deltas.append(int(distance87 / divisor) * 2)  # C integer division truncates towards zero
+    acc = [startcolor[c] << 8 for c in range(3)]
+    for i in range(startpos, endpos + 1):
+        entries[i] = [(acc[c] >> 8) & 0xFF for c in range(3)]
+        acc = [(acc[c] + deltas[c]) & 0xFFFF for c in range(3)]
+
+
+def expand_gradient(data, name):
+    data = data[:MAX_GRADIENT_BYTES]
+    stops = [data[i:i + 4] for i in range(0, len(data) - 3, 4)]
+    count = 0
+    for stop in stops:
+        count += 1
+        if stop[0] == 255:
+            break
+    else:
+        raise ValueError(f"palette {name}: no end marker within {MAX_GRADIENT_BYTES} bytes")
+
+    entries = [[0, 0, 0] for _ in range(16)]
+    last_slot_used = -1
+    rgbstart = stops[0][1:4]
+    indexstart = 0
+    n = 0
+    while indexstart < 255:
+        n += 1
+        indexend = stops[n][0]
+        rgbend = stops[n][1:4]
+        istart8 = indexstart // 16
+        iend8 = indexend // 16
+        if count < 16:
+            if istart8 <= last_slot_used and last_slot_used < 15:
+                istart8 = last_slot_used + 1
+                if iend8 < istart8:
+                    iend8 = istart8
+            last_slot_used = iend8
+        fill_gradient_rgb(entries, istart8, rgbstart, iend8, rgbend)
+        indexstart = indexend
+        rgbstart = rgbend
+    return entries
+
+
+def generate():
+    with open(SOURCE_FILE, "r") as f:
+        arrays, order = parse_palettes(f.read())
+
+    lines = [
+        "// Generated by pio-scripts/build-palettes.py from palettes.h - do not edit.",
+        "// Built-in gradient palettes, expanded to CRGBPalette16 entries (16 x RGB).",
+        "#pragma once",
+        "",
+        f"#define WLED_EXPANDED_PALETTE_COUNT {len(order)}",
+        "",
+        "static const uint8_t gExpandedPalettes[WLED_EXPANDED_PALETTE_COUNT][48] PROGMEM = {",
+    ]
+    for idx, name in enumerate(order):
+        entries = expand_gradient(arrays[name], name)
+        values = ",".join(str(v) for rgb in entries for v in rgb)
+        lines.append(f"  {{{values}}}, // {idx + 13} {name}")
+    lines.append("};")
+    lines.append("")
+
+    with open(OUTPUT_FILE, "w") as f:
+        f.write("\n".join(lines))
+    print(f"*** expanded {len(order)} gradient palettes into {OUTPUT_FILE} ***")
+
+
+if not os.path.exists(OUTPUT_FILE) or os.path.getmtime(SOURCE_FILE) > os.path.getmtime(OUTPUT_FILE):
+    generate()
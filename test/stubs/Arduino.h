@@ -0,0 +1,29 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/*
+ * WLEDMM minimal Arduino.h for host unit tests (pio test -e native): just enough for Arduino-free sources
+ * like wled_math.cpp to compile on the host. Not used by any firmware build.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#define PI        3.1415926535897932384626433832795
+#define HALF_PI   1.5707963267948966192313216916398
+#define TWO_PI    6.283185307179586476925286766559
+
+#define PROGMEM
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define memcpy_P memcpy
+
+using std::min;
+using std::max;
+
+#endif
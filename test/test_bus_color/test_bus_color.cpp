@@ -0,0 +1,121 @@
+// WLEDMM host tests for wled00/bus_color.h: the precomputed paths must give the same results as the old per-pixel code,
+// run with: pio test -e native
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "bus_color.h"
+
+#define MAX_MAPPINGS 10 // WLED_MAX_COLOR_ORDER_MAPPINGS
+
+struct Entry { uint16_t start, len; uint8_t colorOrder; };
+
+// same interface as ColorOrderMap (bus_manager.h)
+struct MockMap {
+  Entry e[MAX_MAPPINGS];
+  uint8_t n = 0;
+  uint8_t count() const { return n; }
+  const Entry* get(uint8_t i) const { return &e[i]; }
+  void add(uint16_t start, uint16_t len, uint8_t co) { if (n < MAX_MAPPINGS && len) e[n++] = {start, len, co}; }
+
+  // the old ColorOrderMap::getPixelColorOrder(), called for every pixel with the physical index pix + bus start
+  uint8_t getPixelColorOrder(uint32_t pix, uint8_t defaultColorOrder) const {
+    if (n == 0) return defaultColorOrder;
+    uint8_t swapW = defaultColorOrder >> 4;
+    for (uint8_t i = 0; i < n; i++)
+      if (pix >= e[i].start && pix < uint32_t(e[i].start + e[i].len)) return e[i].colorOrder | (swapW << 4);
+    return defaultColorOrder;
+  }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// every product of two 8 bit values, as in colorBalanceFromKelvin()
+void test_div255_exhaustive(void) {
+  for (uint32_t a = 0; a < 256; a++)
+    for (uint32_t b = 0; b < 256; b++)
+      if (div255(a * b) != a * b / 255) TEST_FAIL_MESSAGE("div255 differs from x/255");
+  for (uint32_t x = 0; x <= 255 * 255; x++)
+    if (div255(x) != x / 255) TEST_FAIL_MESSAGE("div255 differs from x/255");
+}
+
+static void checkPlan(const MockMap &map, uint32_t busStart, uint16_t busLen, uint8_t defaultOrder) {
+  ColorOrderRange plan[MAX_MAPPINGS];
+  uint8_t n = buildColorOrderPlan(map, busStart, busLen, defaultOrder & 0xF0, plan, MAX_MAPPINGS);
+  TEST_ASSERT_TRUE(n <= map.count());
+  for (uint32_t pix = 0; pix < busLen; pix++) {
+    uint8_t expected = map.getPixelColorOrder(pix + busStart, defaultOrder);
+    if (colorOrderInPlan(plan, n, pix, defaultOrder) != expected) {
+      char msg[96];
+      snprintf(msg, sizeof(msg), "bus %u+%u pixel %u: expected order 0x%02X", unsigned(busStart), busLen, unsigned(pix), expected);
+      TEST_FAIL_MESSAGE(msg);
+    }
+  }
+}
+
+void test_plan_examples(void) {
+  MockMap map;
+  checkPlan(map, 0, 100, 0x31);           // no mappings: default incl. W swap
+  map.add(50, 100, 4);                    // starts inside, ends past the bus
+  map.add(0, 60, 2);                      // overlaps the first one: first match wins
+  map.add(200, 10, 5);                    // other bus only
+  checkPlan(map, 0, 100, 0x10);
+  checkPlan(map, 100, 100, 0x21);         // mapping 0 covers the start of the second bus only
+  checkPlan(map, 205, 3, 0x00);           // bus inside a mapping
+  checkPlan(map, 300, 50, 0x00);          // no mapping covers the bus
+}
+
+// random maps and busses (incl. sacrificial pixels, which are part of the physical length)
+void test_plan_random(void) {
+  srand(4);
+  for (int round = 0; round < 3000; round++) {
+    MockMap map;
+    int mappings = rand() % (MAX_MAPPINGS + 1);
+    for (int i = 0; i < mappings; i++) map.add(rand() % 1200, rand() % 300, rand() % 6);
+    uint32_t start = rand() % 1000;
+    uint16_t len = 1 + rand() % 400;
+    uint8_t def = (rand() % 6) | ((rand() % 4) << 4);
+    checkPlan(map, start, len, def);
+  }
+}
+
+void test_plan_capacity(void) {
+  MockMap map;
+  for (int i = 0; i < MAX_MAPPINGS; i++) map.add(i * 10, 10, i % 6);
+  ColorOrderRange plan[3];
+  TEST_ASSERT_EQUAL(3, buildColorOrderPlan(map, 0, 1000, 0, plan, 3)); // never writes past the plan
+}
+
+// host only: ns per pixel lookup with 10 mappings, 4 of them on this bus (not ESP32 numbers)
+static volatile uint32_t sink;
+void test_benchmark(void) {
+  MockMap map;
+  for (int i = 0; i < MAX_MAPPINGS; i++) map.add(i * 250, 100, i % 6);
+  const uint32_t busStart = 1250, busLen = 1000;
+  ColorOrderRange plan[MAX_MAPPINGS];
+  uint8_t n = buildColorOrderPlan(map, busStart, busLen, 0, plan, MAX_MAPPINGS);
+  const int rounds = 2000;
+  uint32_t acc = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) for (uint32_t p = 0; p < busLen; p++) acc += map.getPixelColorOrder(p + busStart, 1);
+  auto t1 = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) for (uint32_t p = 0; p < busLen; p++) acc += colorOrderInPlan(plan, n, p, 1);
+  auto t2 = std::chrono::steady_clock::now();
+  sink = acc;
+  char msg[120];
+  snprintf(msg, sizeof(msg), "host: color order lookup, map scan %.2f ns, plan %.2f ns per pixel",
+           std::chrono::duration<double, std::nano>(t1 - t0).count() / (double(rounds) * busLen),
+           std::chrono::duration<double, std::nano>(t2 - t1).count() / (double(rounds) * busLen));
+  TEST_MESSAGE(msg);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_div255_exhaustive);
+  RUN_TEST(test_plan_examples);
+  RUN_TEST(test_plan_random);
+  RUN_TEST(test_plan_capacity);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,150 @@
+// WLEDMM host tests and benchmark for the bus pixel range table (wled00/bus_ranges.h), run with: pio test -e native
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "bus_ranges.h"
+
+struct MockBus {
+  pixidx_t start, len;
+  pixidx_t getStart() { return start; }
+  uint16_t getLength() { return len; }
+};
+
+#define MAX_MOCK 10
+typedef BusRangeTable<MockBus, MAX_MOCK> Table;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// the loop BusManager used before the table (and still uses for overlapping busses): first matching bus wins
+static MockBus* linearScan(MockBus* const *busses, size_t count, pixidx_t pix) {
+  for (size_t i = 0; i < count; i++) {
+    MockBus* b = busses[i];
+    if (pix < b->start || pix >= b->start + b->len) continue;
+    return b;
+  }
+  return nullptr;
+}
+
+static MockBus* tableLookup(Table &t, pixidx_t pix) {
+  int r = t.lookup(pix);
+  return r < 0 ? nullptr : t[r].bus;
+}
+
+// every pixel must resolve to the same bus as the linear scan, in any lookup order
+static void checkAgainstLinear(MockBus* const *busses, size_t count) {
+  Table t;
+  t.rebuild(busses, count);
+  TEST_ASSERT_FALSE(t.overlapping());
+  for (unsigned pix = 0; pix < 700; pix++) TEST_ASSERT_TRUE(tableLookup(t, pix) == linearScan(busses, count, pix));
+  srand(1);
+  for (int n = 0; n < 5000; n++) {
+    pixidx_t pix = rand() % 700;
+    TEST_ASSERT_TRUE(tableLookup(t, pix) == linearScan(busses, count, pix));
+  }
+}
+
+void test_sorted_contiguous(void) {
+  MockBus b[3] = {{0, 100}, {100, 50}, {150, 200}};
+  MockBus* p[3] = {&b[0], &b[1], &b[2]};
+  checkAgainstLinear(p, 3);
+}
+
+void test_unsorted_with_gaps(void) {
+  MockBus b[4] = {{400, 10}, {20, 30}, {300, 1}, {100, 100}};
+  MockBus* p[4] = {&b[0], &b[1], &b[2], &b[3]};
+  checkAgainstLinear(p, 4);
+  Table t;
+  t.rebuild(p, 4);
+  TEST_ASSERT_EQUAL(4, t.size());
+  TEST_ASSERT_EQUAL(20, t[0].start);
+  TEST_ASSERT_EQUAL(400, t[3].start);
+  TEST_ASSERT_EQUAL(-1, t.find(0));    // before the first bus
+  TEST_ASSERT_EQUAL(-1, t.find(50));   // end is exclusive
+  TEST_ASSERT_EQUAL(-1, t.find(410));  // past the last bus
+}
+
+void test_empty_busses_skipped(void) {
+  MockBus b[3] = {{0, 0}, {0, 10}, {10, 0}};
+  MockBus* p[3] = {&b[0], &b[1], &b[2]};
+  Table t;
+  t.rebuild(p, 3);
+  TEST_ASSERT_EQUAL(1, t.size());
+  TEST_ASSERT_FALSE(t.overlapping());
+  TEST_ASSERT_TRUE(tableLookup(t, 9) == &b[1]);
+  t.rebuild(p, 0);
+  TEST_ASSERT_EQUAL(0, t.size());
+  TEST_ASSERT_EQUAL(-1, t.find(0));
+}
+
+void test_overlap_detected(void) {
+  MockBus b[2] = {{0, 100}, {99, 10}};
+  MockBus* p[2] = {&b[0], &b[1]};
+  Table t;
+  t.rebuild(p, 2);
+  TEST_ASSERT_TRUE(t.overlapping());
+  b[1].start = 100;
+  t.rebuild(p, 2);
+  TEST_ASSERT_FALSE(t.overlapping());
+}
+
+// the last-hit cache must not return a stale bus after a rebuild
+void test_rebuild_resets_cache(void) {
+  MockBus b[2] = {{0, 100}, {100, 100}};
+  MockBus* p[2] = {&b[0], &b[1]};
+  Table t;
+  t.rebuild(p, 2);
+  TEST_ASSERT_TRUE(tableLookup(t, 150) == &b[1]);
+  b[1].start = 300;
+  t.rebuild(p, 2);
+  TEST_ASSERT_EQUAL(-1, t.find(150));
+}
+
+// host only benchmark: table vs. the old linear scan, for 1, 4 and 10 busses of equal length
+// (sequential = effect rendering order, random = mapped 2D layouts). Numbers are for the build host, not an ESP32.
+static volatile uintptr_t sink;
+
+static double nsPerLookup(MockBus* const *busses, size_t count, const pixidx_t *order, size_t n, bool table) {
+  Table t;
+  t.rebuild(busses, count);
+  uintptr_t acc = 0;
+  const int rounds = 200;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int k = 0; k < rounds; k++) {
+    if (table) for (size_t i = 0; i < n; i++) acc += uintptr_t(tableLookup(t, order[i]));
+    else       for (size_t i = 0; i < n; i++) acc += uintptr_t(linearScan(busses, count, order[i]));
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  sink = acc;
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double(rounds) * n);
+}
+
+void test_benchmark(void) {
+  const size_t total = 4000;   // pixels spread over all busses
+  static pixidx_t seq[total], rnd[total];
+  srand(2);
+  for (size_t i = 0; i < total; i++) { seq[i] = i; rnd[i] = rand() % total; }
+  const size_t counts[] = {1, 4, 10};
+  for (size_t c : counts) {
+    MockBus b[MAX_MOCK];
+    MockBus* p[MAX_MOCK];
+    for (size_t i = 0; i < c; i++) { b[i] = {pixidx_t(i * (total / c)), pixidx_t(total / c)}; p[i] = &b[i]; }
+    char msg[160];
+    snprintf(msg, sizeof(msg), "host: %2u busses  sequential: linear %.2f ns, table %.2f ns  random: linear %.2f ns, table %.2f ns",
+             unsigned(c), nsPerLookup(p, c, seq, total, false), nsPerLookup(p, c, seq, total, true),
+             nsPerLookup(p, c, rnd, total, false), nsPerLookup(p, c, rnd, total, true));
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sorted_contiguous);
+  RUN_TEST(test_unsorted_with_gaps);
+  RUN_TEST(test_empty_busses_skipped);
+  RUN_TEST(test_overlap_detected);
+  RUN_TEST(test_rebuild_resets_cache);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
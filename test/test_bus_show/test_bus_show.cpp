@@ -0,0 +1,160 @@
+// WLEDMM host tests for the two phase bus show (wled00/bus_show.h) with mock busses on a simulated clock,
+// run with: pio test -e native
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bus_show.h"
+
+// simulated time in us; idle() is one pass of the main loop's yield()
+struct SimClock {
+  unsigned long t = 0;
+  unsigned long idleStep = 100;
+  unsigned long now() { return t; }
+  void idle() { t += idleStep; }
+};
+
+// a bus whose previous transfer runs until busyUntil; show() blocks until then like NeoPixelBus does,
+// costs showCost us of CPU time to start and then transfers for transferUs in the background
+struct MockBus {
+  SimClock *clock;
+  MockBus(SimClock *c = nullptr) : clock(c) {}
+  unsigned long busyUntil = 0, showCost = 50, transferUs = 3000;
+  unsigned long started = 0;
+  bool stuck = false;  // never finishes (broken driver), show() returns at once
+  int shows = 0;
+  bool canShow() { return !stuck && clock->t >= busyUntil; }
+  void show() {
+    shows++;
+    if (stuck) return;
+    if (clock->t < busyUntil) clock->t = busyUntil;
+    started = clock->t;
+    clock->t += showCost;
+    busyUntil = clock->t + transferUs;
+  }
+};
+
+// the old BusManager::show(): each bus in turn
+static void showSequential(MockBus* const *busses, size_t count) {
+  for (size_t i = 0; i < count; i++) busses[i]->show();
+}
+
+static unsigned long skew(MockBus* const *busses, size_t count) {
+  unsigned long lo = busses[0]->started, hi = lo;
+  for (size_t i = 1; i < count; i++) {
+    if (busses[i]->started < lo) lo = busses[i]->started;
+    if (busses[i]->started > hi) hi = busses[i]->started;
+  }
+  return hi - lo;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// busses still busy for different times: all start together once the slowest is done
+void test_busses_start_together(void) {
+  SimClock clock;
+  MockBus b[3] = {{&clock}, {&clock}, {&clock}};
+  MockBus* p[3] = {&b[0], &b[1], &b[2]};
+  uint16_t waitUs[3] = {0}, showUs[3] = {0};
+  b[0].busyUntil = 3000; b[1].busyUntil = 1000; b[2].busyUntil = 5000;
+  showAllBusses(p, 3, clock, waitUs, showUs);
+  for (int i = 0; i < 3; i++) TEST_ASSERT_EQUAL(1, b[i].shows);
+  TEST_ASSERT_GREATER_OR_EQUAL(5000, b[0].started);
+  TEST_ASSERT_TRUE(skew(p, 3) <= 2 * b[0].showCost);
+
+  // same situation in sequence: the first bus starts as soon as it is free, the last one 2ms later
+  SimClock clock2;
+  MockBus s[3] = {{&clock2}, {&clock2}, {&clock2}};
+  MockBus* q[3] = {&s[0], &s[1], &s[2]};
+  s[0].busyUntil = 3000; s[1].busyUntil = 1000; s[2].busyUntil = 5000;
+  showSequential(q, 3);
+  TEST_ASSERT_EQUAL(2000, skew(q, 3));
+}
+
+// one timeout for all busses together, not one per bus
+void test_shared_deadline(void) {
+  SimClock clock;
+  MockBus b[4] = {{&clock}, {&clock}, {&clock}, {&clock}};
+  MockBus* p[4] = {&b[0], &b[1], &b[2], &b[3]};
+  uint16_t waitUs[4] = {0}, showUs[4] = {0};
+  for (int i = 0; i < 4; i++) b[i].stuck = true;
+  showAllBusses(p, 4, clock, waitUs, showUs);
+  TEST_ASSERT_TRUE(clock.t <= BUS_SHOW_MAX_WAIT + clock.idleStep);
+  for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL(1, b[i].shows); // stalled busses are still shown (and block there)
+}
+
+// a stalled bus must not delay the ones after it beyond the shared deadline
+void test_stalled_bus_then_busy_bus(void) {
+  SimClock clock;
+  MockBus b[2] = {{&clock}, {&clock}};
+  MockBus* p[2] = {&b[0], &b[1]};
+  uint16_t waitUs[2] = {0}, showUs[2] = {0};
+  b[0].stuck = true;
+  b[1].busyUntil = 100000;
+  showAllBusses(p, 2, clock, waitUs, showUs, 20000);
+  TEST_ASSERT_TRUE(waitUs[0] >= (20000 >> 3) - 20 && waitUs[0] <= (20100 >> 3));
+  TEST_ASSERT_EQUAL(0, waitUs[1]);             // deadline already passed, no extra wait
+  TEST_ASSERT_EQUAL(100000, b[1].started);     // so its show() blocks, as before
+}
+
+void test_timing_ema(void) {
+  TEST_ASSERT_EQUAL(100, busTimingEMA(0, 800));
+  TEST_ASSERT_EQUAL(65535 >> 3, busTimingEMA(0, 1000000)); // saturated
+  uint16_t avg = 0;
+  for (int i = 0; i < 100; i++) avg = busTimingEMA(avg, 800);
+  TEST_ASSERT_TRUE(avg >= 792 && avg <= 800);
+
+  SimClock clock;
+  MockBus b = {&clock};
+  MockBus* p[1] = {&b};
+  uint16_t waitUs[1] = {0}, showUs[1] = {0};
+  b.showCost = 120;
+  for (int frame = 0; frame < 100; frame++) {
+    b.busyUntil = clock.t + 1000; // previous transfer needs 1ms more
+    showAllBusses(p, 1, clock, waitUs, showUs);
+  }
+  TEST_ASSERT_TRUE(waitUs[0] >= 990 && waitUs[0] <= 1000);
+  TEST_ASSERT_TRUE(showUs[0] >= 112 && showUs[0] <= 120);
+}
+
+// simulated (not measured) skew between the first and the last bus start, old sequential vs two phase,
+// for busses whose previous transfers end at random times within one 4ms frame
+void test_simulated_skew(void) {
+  const size_t counts[] = {2, 4, 8};
+  srand(3);
+  for (size_t n : counts) {
+    unsigned long seqSkew = 0, newSkew = 0;
+    const int frames = 1000;
+    for (int f = 0; f < frames; f++) {
+      unsigned long ends[8];
+      for (size_t i = 0; i < n; i++) ends[i] = rand() % 4000;
+      SimClock c1, c2;
+      MockBus a[8], b[8];
+      MockBus *pa[8], *pb[8];
+      uint16_t waitUs[8] = {0}, showUs[8] = {0};
+      for (size_t i = 0; i < n; i++) {
+        a[i].clock = &c1; a[i].busyUntil = ends[i]; pa[i] = &a[i];
+        b[i].clock = &c2; b[i].busyUntil = ends[i]; pb[i] = &b[i];
+      }
+      showSequential(pa, n);
+      showAllBusses(pb, n, c2, waitUs, showUs);
+      seqSkew += skew(pa, n);
+      newSkew += skew(pb, n);
+    }
+    char msg[120];
+    snprintf(msg, sizeof(msg), "simulated: %u busses, mean start skew sequential %lu us, two phase %lu us",
+             unsigned(n), seqSkew / frames, newSkew / frames);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(newSkew <= seqSkew);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_busses_start_together);
+  RUN_TEST(test_shared_deadline);
+  RUN_TEST(test_stalled_bus_then_busy_bus);
+  RUN_TEST(test_timing_ema);
+  RUN_TEST(test_simulated_skew);
+  return UNITY_END();
+}
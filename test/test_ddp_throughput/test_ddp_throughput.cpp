@@ -0,0 +1,169 @@
+// WLEDMM host test and UDP loopback benchmark of the DDP packetizer (wled00/net_packets.h), run with: pio test -e native
+// The benchmark compares the current packetizer (one socket, packet built in one buffer, one send per packet) with a model
+// of the old one (socket opened and closed per frame, every channel byte passed through its own write() call).
+// Numbers are for the build host and its loopback interface; they say nothing absolute about an ESP32 on WiFi.
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "net_packets.h"
+
+static uint16_t getU16(const uint8_t *p) { return (p[0] << 8) | p[1]; }
+static uint32_t getU32(const uint8_t *p) { return (uint32_t(getU16(p)) << 16) | getU16(p + 2); }
+
+static int rxSock = -1;
+static sockaddr_in rxAddr;
+static uint8_t netPacket[DDP_HEADER_LEN + DDP_CHANNELS_PER_PACKET];
+static uint8_t rxBuf[2048];
+
+static bool openListener() {
+  rxSock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (rxSock < 0) return false;
+  memset(&rxAddr, 0, sizeof(rxAddr));
+  rxAddr.sin_family = AF_INET;
+  rxAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(rxAddr);
+  if (bind(rxSock, (sockaddr*)&rxAddr, sizeof(rxAddr)) || getsockname(rxSock, (sockaddr*)&rxAddr, &len)) { close(rxSock); rxSock = -1; return false; }
+  int size = 4 << 20;
+  setsockopt(rxSock, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  timeval tv = {1, 0};
+  setsockopt(rxSock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  return true;
+}
+
+static size_t packetCount(size_t channels) { return (channels + DDP_CHANNELS_PER_PACKET - 1) / DDP_CHANNELS_PER_PACKET; }
+
+// current packetizer, same steps as realtimeSendPacket() case 0 for every packet of a frame
+static bool sendFrameNew(int sock, const uint8_t *buffer, size_t channels, uint8_t bri, bool rgbw, uint8_t &seq) {
+  for (size_t channel = 0; channel < channels; channel += DDP_CHANNELS_PER_PACKET) {
+    size_t packetSize = channels - channel < DDP_CHANNELS_PER_PACKET ? channels - channel : DDP_CHANNELS_PER_PACKET;
+    if (seq > 15) seq = 0;
+    ddpDataHeader(netPacket, channel + packetSize >= channels, seq++, rgbw, channel, packetSize);
+    netFillChannels(netPacket + DDP_HEADER_LEN, buffer + channel, packetSize, bri);
+    if (sendto(sock, netPacket, DDP_HEADER_LEN + packetSize, 0, (sockaddr*)&rxAddr, sizeof(rxAddr)) < 0) return false;
+  }
+  return true;
+}
+
+// model of the old code: a new socket per frame and WiFiUDP::write(uint8_t) for every byte (a call per byte into the packet buffer)
+static size_t oldLen;
+__attribute__((noinline)) static void oldWrite(uint8_t b) { netPacket[oldLen++] = b; }
+
+static bool sendFrameOld(const uint8_t *buffer, size_t channels, uint8_t bri, bool rgbw, uint8_t &seq) {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0) return false;
+  bool ok = true;
+  for (size_t channel = 0; channel < channels && ok; channel += DDP_CHANNELS_PER_PACKET) {
+    size_t packetSize = channels - channel < DDP_CHANNELS_PER_PACKET ? channels - channel : DDP_CHANNELS_PER_PACKET;
+    if (seq > 15) seq = 0;
+    oldLen = 0;
+    oldWrite(channel + packetSize >= channels ? DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH : DDP_FLAGS1_VER1);
+    oldWrite(seq++ & 0x0F);
+    oldWrite(rgbw ? DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
+    oldWrite(DDP_ID_DISPLAY);
+    oldWrite(0xFF & (channel >> 24)); oldWrite(0xFF & (channel >> 16)); oldWrite(0xFF & (channel >> 8)); oldWrite(0xFF & channel);
+    oldWrite(0xFF & (packetSize >> 8)); oldWrite(0xFF & packetSize);
+    for (size_t i = channel; i < channel + packetSize; i++) oldWrite((uint16_t(buffer[i]) * (uint16_t(bri) + 1)) >> 8);
+    ok = sendto(sock, netPacket, oldLen, 0, (sockaddr*)&rxAddr, sizeof(rxAddr)) >= 0;
+  }
+  close(sock);
+  return ok;
+}
+
+// listener: receives one frame, checks every DDP header and reassembles the channels
+static bool receiveFrame(uint8_t *frame, size_t channels, bool rgbw) {
+  size_t packets = packetCount(channels), expectOffset = 0;
+  for (size_t n = 0; n < packets; n++) {
+    ssize_t len = recv(rxSock, rxBuf, sizeof(rxBuf), 0);
+    if (len < DDP_HEADER_LEN) return false;
+    bool last = n == packets - 1;
+    if ((rxBuf[0] & DDP_FLAGS1_VER) != DDP_FLAGS1_VER1) return false;
+    if (bool(rxBuf[0] & DDP_FLAGS1_PUSH) != last) return false;             // push only with the last packet
+    if (rxBuf[2] != (rgbw ? DDP_TYPE_RGBW32 : DDP_TYPE_RGB24) || rxBuf[3] != DDP_ID_DISPLAY) return false;
+    uint32_t offset = getU32(rxBuf + 4);
+    uint16_t dataLen = getU16(rxBuf + 8);
+    if (offset != expectOffset || dataLen != len - DDP_HEADER_LEN || offset + dataLen > channels) return false;
+    memcpy(frame + offset, rxBuf + DDP_HEADER_LEN, dataLen);
+    expectOffset += dataLen;
+  }
+  return expectOffset == channels;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const size_t MAX_CHANNELS = 4096 * 4;
+static uint8_t pixels[MAX_CHANNELS], received[MAX_CHANNELS], expected[MAX_CHANNELS];
+
+void test_frames_arrive_intact(void) {
+  if (!openListener()) { TEST_MESSAGE("no UDP loopback on this host, skipped"); return; }
+  for (size_t i = 0; i < MAX_CHANNELS; i++) pixels[i] = i * 31 + 7;
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  TEST_ASSERT_TRUE(sock >= 0);
+  const size_t sizes[] = {3, 1440, 1443, 4096 * 3};
+  const uint8_t bris[] = {255, 128, 0};
+  uint8_t seq = 0;
+  for (size_t channels : sizes) for (uint8_t bri : bris) for (int rgbw = 0; rgbw < 2; rgbw++) {
+    for (size_t i = 0; i < channels; i++) expected[i] = (pixels[i] * (bri + 1)) >> 8; // FastLED scale8()
+    memset(received, 0, channels);
+    TEST_ASSERT_TRUE(sendFrameNew(sock, pixels, channels, bri, rgbw, seq));
+    TEST_ASSERT_TRUE(receiveFrame(received, channels, rgbw));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, received, channels);
+    memset(received, 0, channels);
+    TEST_ASSERT_TRUE(sendFrameOld(pixels, channels, bri, rgbw, seq));  // the model sends the same bytes
+    TEST_ASSERT_TRUE(receiveFrame(received, channels, rgbw));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, received, channels);
+  }
+  close(sock);
+}
+
+void test_push_packet(void) {
+  uint8_t p[DDP_SYNCPACKET_LEN];
+  TEST_ASSERT_EQUAL(DDP_SYNCPACKET_LEN, ddpPushPacket(p));
+  TEST_ASSERT_EQUAL_HEX8(DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH, p[0]);
+  TEST_ASSERT_EQUAL(DDP_ID_DISPLAY, p[3]);
+  TEST_ASSERT_EQUAL(0, getU32(p + 4));
+  TEST_ASSERT_EQUAL(0, getU16(p + 8)); // no data
+}
+
+static double framesPerSecond(bool useNew, size_t channels, uint8_t bri) {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  uint8_t seq = 0;
+  const int frames = 2000;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int f = 0; f < frames; f++) {
+    bool ok = useNew ? sendFrameNew(sock, pixels, channels, bri, false, seq) : sendFrameOld(pixels, channels, bri, false, seq);
+    if (!ok || !receiveFrame(received, channels, false)) { close(sock); return 0; }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  close(sock);
+  return frames / std::chrono::duration<double>(t1 - t0).count();
+}
+
+void test_loopback_benchmark(void) {
+  if (rxSock < 0) { TEST_MESSAGE("no UDP loopback on this host, skipped"); return; }
+  const size_t leds[] = {170, 1000, 4096};
+  const uint8_t bris[] = {255, 128};
+  for (size_t n : leds) for (uint8_t bri : bris) {
+    size_t channels = n * 3;
+    double fpsOld = framesPerSecond(false, channels, bri), fpsNew = framesPerSecond(true, channels, bri);
+    TEST_ASSERT_TRUE(fpsOld > 0 && fpsNew > 0);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "host loopback: %4u RGB LEDs (%u packets) bri %3u: old %7.0f fps, new %7.0f fps (%.1f MB/s payload)",
+             unsigned(n), unsigned(packetCount(channels)), bri, fpsOld, fpsNew, fpsNew * channels / 1e6);
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_frames_arrive_intact);
+  RUN_TEST(test_push_packet);
+  RUN_TEST(test_loopback_benchmark);
+  if (rxSock >= 0) close(rxSock);
+  return UNITY_END();
+}
@@ -0,0 +1,339 @@
+// WLEDMM host tests and benchmark of the GIF decoder (wled00/gif_decoder.h), run with: pio test -e native
+// The test writes its own GIF files (LZW encoder below) and checks every decoded pixel against the source image.
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <vector>
+#include "gif_decoder.h"
+
+typedef std::vector<uint8_t> bytes_t;
+
+struct MemReader {
+  const bytes_t &d;
+  size_t ofs;
+  MemReader(const bytes_t &data, size_t start = 0) : d(data), ofs(start) {}
+  int read() { return ofs < d.size() ? d[ofs++] : -1; }
+};
+
+static void putU16(bytes_t &out, uint16_t v) { out.push_back(v & 0xFF); out.push_back(v >> 8); }
+
+// GIF LZW encoder. fullTable: what to do when all 4096 codes are used, true = keep going with the full table
+// (deferred clear), false = send a clear code. Returns the number of codes added to the table.
+static int lzwEncode(bytes_t &out, const uint8_t *idx, size_t n, int minCodeSize, bool fullTable) {
+  bytes_t data;
+  uint32_t bits = 0; int nBits = 0;
+  auto emit = [&](int code, int size) {
+    bits |= uint32_t(code) << nBits; nBits += size;
+    while (nBits >= 8) { data.push_back(bits & 0xFF); bits >>= 8; nBits -= 8; }
+  };
+  const int clearCode = 1 << minCodeSize, eoiCode = clearCode + 1;
+  std::map<std::pair<int, uint8_t>, int> dict;
+  int codeSize = minCodeSize + 1, next = eoiCode + 1, added = 0;
+  emit(clearCode, codeSize);
+  int prefix = idx[0];
+  for (size_t i = 1; i < n; i++) {
+    auto it = dict.find({prefix, idx[i]});
+    if (it != dict.end()) { prefix = it->second; continue; }
+    emit(prefix, codeSize);
+    if (next < GIF_MAX_CODES) {
+      dict[{prefix, idx[i]}] = next++;
+      added++;
+      if (next > (1 << codeSize) && codeSize < 12) codeSize++;
+    } else if (!fullTable) {
+      emit(clearCode, codeSize);
+      dict.clear();
+      codeSize = minCodeSize + 1; next = eoiCode + 1;
+    }
+    prefix = idx[i];
+  }
+  emit(prefix, codeSize);
+  emit(eoiCode, codeSize);
+  if (nBits) data.push_back(bits & 0xFF);
+  out.push_back(minCodeSize);
+  for (size_t i = 0; i < data.size(); i += 255) {
+    size_t len = data.size() - i < 255 ? data.size() - i : 255;
+    out.push_back(len);
+    out.insert(out.end(), data.begin() + i, data.begin() + i + len);
+  }
+  out.push_back(0);
+  return added;
+}
+
+// screen header with a global color table of 2^bits colors: color i = (i, 255 - i, i * 7)
+static void gifHeader(bytes_t &out, uint16_t w, uint16_t h, int bits) {
+  const char *sig = "GIF89a";
+  out.insert(out.end(), sig, sig + 6);
+  putU16(out, w); putU16(out, h);
+  out.push_back(0x80 | 0x70 | (bits - 1)); out.push_back(0); out.push_back(0);
+  for (int i = 0; i < (1 << bits); i++) { out.push_back(i); out.push_back(255 - i); out.push_back(i * 7); }
+}
+
+// one frame; idx holds w x h color indexes in normal row order (reordered here when interlaced)
+static int gifFrame(bytes_t &out, uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t *idx, int bits,
+                    bool interlaced = false, int transparent = -1, uint16_t delay = 10, bool fullTable = true) {
+  out.push_back(0x21); out.push_back(0xF9); out.push_back(4);
+  out.push_back(transparent >= 0 ? 0x09 : 0x08); putU16(out, delay); out.push_back(transparent >= 0 ? transparent : 0); out.push_back(0);
+  out.push_back(0x2C);
+  putU16(out, x); putU16(out, y); putU16(out, w); putU16(out, h);
+  out.push_back(interlaced ? 0x40 : 0);
+  std::vector<uint8_t> rows(idx, idx + size_t(w) * h);
+  if (interlaced) {
+    size_t r = 0;
+    static const int start[] = {0, 4, 2, 1}, step[] = {8, 8, 4, 2};
+    for (int pass = 0; pass < 4; pass++)
+      for (int row = start[pass]; row < h; row += step[pass], r++) memcpy(&rows[r * w], idx + size_t(row) * w, w);
+  }
+  return lzwEncode(out, rows.data(), rows.size(), bits < 2 ? 2 : bits, fullTable);
+}
+
+// decoded screen: 0xFFFFFFFF = never plotted
+struct Canvas {
+  uint16_t w, h;
+  std::vector<uint32_t> px;
+  int plots = 0;
+  Canvas(uint16_t width, uint16_t height) : w(width), h(height), px(size_t(width) * height, 0xFFFFFFFF) {}
+  void operator()(uint16_t x, uint16_t y, const uint8_t *rgb) {
+    if (x >= w || y >= h) TEST_FAIL_MESSAGE("plotted outside of the clip area");
+    px[size_t(y) * w + x] = (rgb[0] << 16) | (rgb[1] << 8) | rgb[2];
+    plots++;
+  }
+};
+static uint32_t colorOf(uint8_t i) { return (i << 16) | ((255 - i) << 8) | uint8_t(i * 7); }
+
+static gif_lzw_t lzw;
+
+// decodes the single frame of gif into a canvas of the clip size
+static bool decodeOnly(const bytes_t &gif, const gif_clip_t &clip, Canvas &c, size_t *endOfs = nullptr) {
+  MemReader r(gif);
+  uint16_t w, h, gctSize; uint8_t gct[768], lct[768];
+  gif_frame_t f;
+  if (!gifReadHeader(r, w, h, gct, gctSize) || gifReadFrame(r, f, lct) != GIF_FRAME) return false;
+  bool ok = gifDecodeImage(r, lzw, f, clip, f.numColors ? lct : gct, f.numColors ? f.numColors : gctSize, std::ref(c));
+  if (endOfs) *endOfs = r.ofs;
+  return ok;
+}
+
+static void randomImage(std::vector<uint8_t> &img, size_t n, int colors, unsigned seed) {
+  srand(seed);
+  img.resize(n);
+  for (auto &v : img) v = rand() % colors;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_plain_frame(void) {
+  std::vector<uint8_t> img;
+  randomImage(img, 20 * 13, 16, 1);
+  bytes_t gif; gifHeader(gif, 20, 13, 4); gifFrame(gif, 0, 0, 20, 13, img.data(), 4); gif.push_back(0x3B);
+  Canvas c(20, 13);
+  TEST_ASSERT_TRUE(decodeOnly(gif, {0, 0, 20, 13}, c));
+  for (size_t i = 0; i < img.size(); i++) TEST_ASSERT_EQUAL_HEX32(colorOf(img[i]), c.px[i]);
+}
+
+// runs of one color produce the KwKwK case (code that is defined by the code itself)
+void test_uniform_frame(void) {
+  std::vector<uint8_t> img(64 * 64, 3);
+  bytes_t gif; gifHeader(gif, 64, 64, 2); gifFrame(gif, 0, 0, 64, 64, img.data(), 2); gif.push_back(0x3B);
+  Canvas c(64, 64);
+  TEST_ASSERT_TRUE(decodeOnly(gif, {0, 0, 64, 64}, c));
+  for (size_t i = 0; i < img.size(); i++) TEST_ASSERT_EQUAL_HEX32(colorOf(3), c.px[i]);
+}
+
+void test_interlaced_frame(void) {
+  const uint16_t sizes[][2] = {{17, 23}, {8, 1}, {5, 2}, {9, 5}, {31, 64}};
+  for (auto &s : sizes) {
+    std::vector<uint8_t> img;
+    randomImage(img, size_t(s[0]) * s[1], 256, s[1]);
+    bytes_t gif; gifHeader(gif, s[0], s[1], 8); gifFrame(gif, 0, 0, s[0], s[1], img.data(), 8, true); gif.push_back(0x3B);
+    Canvas c(s[0], s[1]);
+    TEST_ASSERT_TRUE(decodeOnly(gif, {0, 0, s[0], s[1]}, c));
+    for (size_t i = 0; i < img.size(); i++) TEST_ASSERT_EQUAL_HEX32(colorOf(img[i]), c.px[i]);
+  }
+}
+
+// frame at an offset, partly outside of the segment (clip area), plain and interlaced, and with a sprite window
+void test_clipping(void) {
+  std::vector<uint8_t> img;
+  randomImage(img, 12 * 10, 16, 7);
+  for (int interlaced = 0; interlaced < 2; interlaced++) {
+    bytes_t gif; gifHeader(gif, 16, 16, 4); gifFrame(gif, 6, 4, 12, 10, img.data(), 4, interlaced); gif.push_back(0x3B);
+    const gif_clip_t clips[] = {{0, 0, 16, 16}, {0, 0, 8, 8}, {0, 0, 3, 3}, {7, 6, 4, 5}, {0, 12, 16, 4}};
+    for (const gif_clip_t &clip : clips) {
+      Canvas c(clip.width, clip.height);
+      size_t end = 0;
+      TEST_ASSERT_TRUE(decodeOnly(gif, clip, c, &end));
+      TEST_ASSERT_EQUAL(gif.size() - 1, end);  // reader is behind the image, at the trailer
+      int expectedPlots = 0;
+      for (int y = 0; y < clip.height; y++) for (int x = 0; x < clip.width; x++) {
+        int sx = x + clip.left - 6, sy = y + clip.top - 4;  // position in the frame
+        bool inFrame = sx >= 0 && sx < 12 && sy >= 0 && sy < 10;
+        uint32_t expected = inFrame ? colorOf(img[sy * 12 + sx]) : 0xFFFFFFFF;
+        expectedPlots += inFrame;
+        TEST_ASSERT_EQUAL_HEX32(expected, c.px[size_t(y) * clip.width + x]);
+      }
+      TEST_ASSERT_EQUAL(expectedPlots, c.plots);
+    }
+  }
+}
+
+void test_transparency(void) {
+  std::vector<uint8_t> img;
+  randomImage(img, 10 * 10, 4, 3);
+  bytes_t gif; gifHeader(gif, 10, 10, 2); gifFrame(gif, 0, 0, 10, 10, img.data(), 2, false, 2); gif.push_back(0x3B);
+  Canvas c(10, 10);
+  TEST_ASSERT_TRUE(decodeOnly(gif, {0, 0, 10, 10}, c));
+  for (size_t i = 0; i < img.size(); i++) TEST_ASSERT_EQUAL_HEX32(img[i] == 2 ? 0xFFFFFFFF : colorOf(img[i]), c.px[i]);
+}
+
+// enough noise to use all 4096 codes: with a full table (deferred clear) and with clear codes
+void test_full_code_table(void) {
+  std::vector<uint8_t> img;
+  randomImage(img, 160 * 120, 256, 11);
+  for (int fullTable = 0; fullTable < 2; fullTable++) {
+    bytes_t gif; gifHeader(gif, 160, 120, 8);
+    int added = gifFrame(gif, 0, 0, 160, 120, img.data(), 8, false, -1, 10, fullTable);
+    gif.push_back(0x3B);
+    TEST_ASSERT_TRUE(added >= GIF_MAX_CODES - 258);  // table filled at least once
+    Canvas c(160, 120);
+    TEST_ASSERT_TRUE(decodeOnly(gif, {0, 0, 160, 120}, c));
+    for (size_t i = 0; i < img.size(); i++) if (c.px[i] != colorOf(img[i])) TEST_FAIL_MESSAGE("pixel differs after the code table was full");
+  }
+}
+
+// two frames, read until the trailer and then again from the first frame like the player does when it loops
+void test_loop(void) {
+  std::vector<uint8_t> a, b;
+  randomImage(a, 8 * 8, 4, 5);
+  randomImage(b, 4 * 4, 4, 6);
+  bytes_t gif; gifHeader(gif, 8, 8, 2);
+  gif.insert(gif.end(), {0x21, 0xFF, 3, 'a', 'b', 'c', 0});   // application extension is skipped
+  gifFrame(gif, 0, 0, 8, 8, a.data(), 2, false, -1, 20);
+  gifFrame(gif, 2, 2, 4, 4, b.data(), 2, false, 1, 30);
+  gif.push_back(0x3B);
+
+  MemReader r(gif);
+  uint16_t w, h, gctSize; uint8_t gct[768], lct[768];
+  TEST_ASSERT_TRUE(gifReadHeader(r, w, h, gct, gctSize));
+  const size_t firstFrameOfs = r.ofs;
+  Canvas c(8, 8);
+  for (int loop = 0; loop < 3; loop++) {
+    gif_frame_t f;
+    TEST_ASSERT_EQUAL(GIF_FRAME, gifReadFrame(r, f, lct));
+    TEST_ASSERT_EQUAL(20, f.delay);
+    TEST_ASSERT_TRUE(gifDecodeImage(r, lzw, f, {0, 0, 8, 8}, gct, gctSize, std::ref(c)));
+    TEST_ASSERT_EQUAL(GIF_FRAME, gifReadFrame(r, f, lct));
+    TEST_ASSERT_EQUAL(30, f.delay);
+    TEST_ASSERT_EQUAL(1, f.transparent);
+    TEST_ASSERT_TRUE(gifDecodeImage(r, lzw, f, {0, 0, 8, 8}, gct, gctSize, std::ref(c)));
+    TEST_ASSERT_EQUAL(GIF_TRAILER, gifReadFrame(r, f, lct));
+    for (int y = 0; y < 8; y++) for (int x = 0; x < 8; x++) {
+      bool second = x >= 2 && x < 6 && y >= 2 && y < 6 && b[(y - 2) * 4 + x - 2] != 1;
+      TEST_ASSERT_EQUAL_HEX32(colorOf(second ? b[(y - 2) * 4 + x - 2] : a[y * 8 + x]), c.px[y * 8 + x]);
+    }
+    r.ofs = firstFrameOfs;
+  }
+}
+
+void test_corrupt_data(void) {
+  bytes_t notGif = {'P', 'N', 'G', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  MemReader r(notGif);
+  uint16_t w, h, gctSize; uint8_t gct[768];
+  TEST_ASSERT_FALSE(gifReadHeader(r, w, h, gct, gctSize));
+
+  std::vector<uint8_t> img;
+  randomImage(img, 32 * 32, 16, 9);
+  bytes_t gif; gifHeader(gif, 32, 32, 4); gifFrame(gif, 0, 0, 32, 32, img.data(), 4); gif.push_back(0x3B);
+  for (size_t cut = 0; cut < gif.size(); cut += 7) { // truncated file: never crashes, fails or ends early
+    bytes_t part(gif.begin(), gif.begin() + cut);
+    Canvas c(32, 32);
+    decodeOnly(part, {0, 0, 32, 32}, c);
+  }
+  bytes_t bad = gif;
+  size_t data = bad.size() - 1;                   // find the first data byte of the image: after "min code size, block length"
+  while (data > 0 && bad[data - 1] != 0x2C) data--;
+  data += 9 + 2;
+  for (int i = 0; i < 20; i++) bad[data + 3 + i] = 0xFF;  // codes pointing beyond the table
+  Canvas c(32, 32);
+  TEST_ASSERT_FALSE(decodeOnly(bad, {0, 0, 32, 32}, c));
+}
+
+void test_frame_cache(void) {
+  GifFrameCache cache;
+  TEST_ASSERT_TRUE(cache.append(10) == nullptr);  // not started
+  cache.start(1000, 300);
+  TEST_ASSERT_TRUE(cache.filling());
+  for (int i = 0; i < 3; i++) {
+    uint8_t *f = cache.append(10 + i);
+    TEST_ASSERT_TRUE(f != nullptr);
+    memset(f, i, 300);
+  }
+  cache.complete();
+  TEST_ASSERT_TRUE(cache.ready());
+  TEST_ASSERT_EQUAL(3, cache.frames());
+  TEST_ASSERT_EQUAL(900, cache.bytes());
+  uint16_t delay;
+  TEST_ASSERT_EQUAL(2, cache.frame(2, delay)[299]);
+  TEST_ASSERT_EQUAL(12, delay);
+  TEST_ASSERT_TRUE(cache.append(10) == nullptr);  // complete: no more frames
+
+  cache.start(1000, 300);                          // 4th frame does not fit: cache is dropped
+  for (int i = 0; i < 3; i++) TEST_ASSERT_TRUE(cache.append(10) != nullptr);
+  TEST_ASSERT_TRUE(cache.append(10) == nullptr);
+  TEST_ASSERT_EQUAL(0, cache.bytes());
+  cache.complete();
+  TEST_ASSERT_FALSE(cache.ready());
+
+  cache.start(1 << 20, 1);                         // frame count limit
+  for (int i = 0; i < GIF_CACHE_MAX_FRAMES; i++) TEST_ASSERT_TRUE(cache.append(1) != nullptr);
+  TEST_ASSERT_TRUE(cache.append(1) == nullptr);
+  TEST_ASSERT_FALSE(cache.filling());
+}
+
+// host only: decode time of one full frame against a copy from the frame cache (not ESP32 numbers, no file system)
+static volatile uint32_t sink;
+void test_benchmark(void) {
+  const uint16_t sizes[] = {16, 32, 64, 128};
+  for (uint16_t s : sizes) {
+    std::vector<uint8_t> img(size_t(s) * s);
+    for (size_t i = 0; i < img.size(); i++) img[i] = ((i % s) / 4 + (i / s) / 4 + (rand() % 3)) & 0x3F; // pixel art like, 64 colors
+    bytes_t gif; gifHeader(gif, s, s, 6); gifFrame(gif, 0, 0, s, s, img.data(), 6); gif.push_back(0x3B);
+    std::vector<uint8_t> rgb(size_t(s) * s * 3), copy(rgb.size());
+    const int rounds = 2000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      MemReader r(gif);
+      uint16_t w, h, gctSize; uint8_t gct[768], lct[768];
+      gif_frame_t f;
+      gifReadHeader(r, w, h, gct, gctSize);
+      gifReadFrame(r, f, lct);
+      gifDecodeImage(r, lzw, f, {0, 0, s, s}, gct, gctSize, [&](uint16_t x, uint16_t y, const uint8_t *c) { memcpy(&rgb[(size_t(y) * s + x) * 3], c, 3); });
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) { memcpy(copy.data(), rgb.data(), rgb.size()); sink += copy[i % copy.size()]; }
+    auto t2 = std::chrono::steady_clock::now();
+    char msg[128];
+    snprintf(msg, sizeof(msg), "host: %3ux%-3u frame (%5u bytes GIF): decode %7.1f us, from frame cache %5.2f us",
+             s, s, unsigned(gif.size()), std::chrono::duration<double, std::micro>(t1 - t0).count() / rounds,
+             std::chrono::duration<double, std::micro>(t2 - t1).count() / rounds);
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_plain_frame);
+  RUN_TEST(test_uniform_frame);
+  RUN_TEST(test_interlaced_frame);
+  RUN_TEST(test_clipping);
+  RUN_TEST(test_transparency);
+  RUN_TEST(test_full_code_table);
+  RUN_TEST(test_loop);
+  RUN_TEST(test_corrupt_data);
+  RUN_TEST(test_frame_cache);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,196 @@
+// WLEDMM host tests for the realtime output packet layouts (wled00/net_packets.h): a minimal E1.31 listener
+// receives them over UDP loopback and validates them against ANSI E1.31-2018, run with: pio test -e native
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "net_packets.h"
+
+static const uint8_t CID[E131_CID_LEN] = {'W','L','E','D','0','1','2','3','4','5','6','7','8','9','a','b'};
+
+static uint16_t getU16(const uint8_t *p) { return (p[0] << 8) | p[1]; }
+static uint32_t getU32(const uint8_t *p) { return (uint32_t(getU16(p)) << 16) | getU16(p + 2); }
+
+// UDP loopback: the sender writes packets to a socket the listener reads from (falls back to a plain copy without sockets)
+struct Loopback {
+  int rx = -1, tx = -1;
+  sockaddr_in addr;
+  bool open() {
+    rx = socket(AF_INET, SOCK_DGRAM, 0);
+    tx = socket(AF_INET, SOCK_DGRAM, 0);
+    if (rx < 0 || tx < 0) return false;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (bind(rx, (sockaddr*)&addr, sizeof(addr)) || getsockname(rx, (sockaddr*)&addr, &len)) return false;
+    timeval tv = {1, 0};
+    setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return true;
+  }
+  ~Loopback() { if (rx >= 0) close(rx); if (tx >= 0) close(tx); }
+  // sends p and returns what the listener received (or p itself without sockets)
+  ssize_t roundTrip(const uint8_t *p, size_t len, uint8_t *out, size_t outLen) {
+    if (rx < 0) { memcpy(out, p, len); return len; }
+    if (sendto(tx, p, len, 0, (sockaddr*)&addr, sizeof(addr)) != ssize_t(len)) return -1;
+    return recv(rx, out, outLen, 0);
+  }
+};
+
+struct E131Data {
+  uint16_t universe, syncUniverse;
+  uint8_t sequence, priority;
+  size_t channels;
+  const uint8_t *data;
+  char source[E131_SOURCE_LEN];
+};
+
+// flags (0x7) and PDU length of the layer starting at ofs, which extends to the end of the packet
+static bool layerLength(const uint8_t *p, size_t len, size_t ofs) {
+  uint16_t v = getU16(p + ofs);
+  return (v >> 12) == 0x7 && (v & 0x0FFF) == len - ofs;
+}
+
+static bool commonRoot(const uint8_t *p, size_t len, uint32_t vector) {
+  return getU16(p) == 0x0010 && getU16(p + 2) == 0 && memcmp(p + E131_ROOT_ID, "ASC-E1.17\0\0\0", 12) == 0
+      && layerLength(p, len, E131_ROOT_FLENGTH) && getU32(p + E131_ROOT_VECTOR) == vector
+      && memcmp(p + E131_ROOT_CID, CID, E131_CID_LEN) == 0 && layerLength(p, len, E131_FRAME_FLENGTH);
+}
+
+static bool parseData(const uint8_t *p, size_t len, E131Data &d) {
+  if (len < E131_OUT_HEADER_LEN || len > E131_OUT_HEADER_LEN + 512) return false;
+  if (!commonRoot(p, len, 0x00000004) || getU32(p + E131_FRAME_VECTOR) != 0x00000002) return false;
+  if (p[E131_FRAME_SOURCE + E131_SOURCE_LEN - 1] != 0) return false;    // null terminated
+  if (p[E131_FRAME_OPT] != 0) return false;                             // no preview/terminate
+  if (!layerLength(p, len, E131_DMP_FLENGTH) || p[E131_DMP_VECTOR] != 0x02 || p[E131_DMP_TYPE] != 0xA1) return false;
+  if (getU16(p + E131_DMP_ADDR_FIRST) != 0 || getU16(p + E131_DMP_ADDR_INC) != 1) return false;
+  if (getU16(p + E131_DMP_COUNT) != len - E131_DMP_DATA || p[E131_DMP_DATA] != 0) return false; // DMX start code 0
+  d.universe = getU16(p + E131_FRAME_UNIVERSE);
+  if (d.universe < 1 || d.universe > E131_MAX_UNIVERSE) return false;
+  d.syncUniverse = getU16(p + E131_FRAME_RESERVED);
+  d.sequence = p[E131_FRAME_SEQ];
+  d.priority = p[E131_FRAME_PRIORITY];
+  d.channels = len - E131_OUT_HEADER_LEN;
+  d.data = p + E131_OUT_HEADER_LEN;
+  memcpy(d.source, p + E131_FRAME_SOURCE, E131_SOURCE_LEN);
+  return true;
+}
+
+static bool parseSync(const uint8_t *p, size_t len, uint8_t &sequence, uint16_t &syncUniverse) {
+  if (len != E131_SYNC_PACKET_LEN || !commonRoot(p, len, 0x00000008) || getU32(p + E131_FRAME_VECTOR) != 0x00000001) return false;
+  if (getU16(p + 47) != 0) return false; // reserved
+  sequence = p[E131_SYNC_SEQ];
+  syncUniverse = getU16(p + E131_SYNC_UNIVERSE);
+  return true;
+}
+
+// receiver side sequence check (E1.31 6.7.2): a packet is out of order if it is 1..20 behind the last one
+static bool inSequence(uint8_t last, uint8_t now) {
+  int8_t diff = int8_t(now - last);
+  return !(diff <= 0 && diff > -20);
+}
+
+static Loopback net;
+static uint8_t rxBuf[1500];
+
+// one frame of one output, split into universes like realtimeSendPacket() does
+static void sendFrame(const uint8_t *pixels, size_t channels, size_t perUniverse, uint16_t startUniverse, uint8_t sequence,
+                      uint16_t syncUniverse, uint8_t *received, uint8_t *lastSeq) {
+  uint8_t header[E131_OUT_HEADER_LEN], packet[E131_OUT_HEADER_LEN + 512];
+  e131DataHeader(header, CID, "WLED living room", 100, syncUniverse);
+  for (size_t ch = 0, n = 0; ch < channels; ch += perUniverse, n++) {
+    size_t count = channels - ch < perUniverse ? channels - ch : perUniverse;
+    memcpy(packet, header, E131_OUT_HEADER_LEN);
+    size_t len = e131DataPacket(packet, startUniverse + n, sequence, count);
+    memcpy(packet + E131_OUT_HEADER_LEN, pixels + ch, count);
+    ssize_t got = net.roundTrip(packet, len, rxBuf, sizeof(rxBuf));
+    TEST_ASSERT_EQUAL(len, got);
+    E131Data d;
+    TEST_ASSERT_TRUE(parseData(rxBuf, got, d));
+    TEST_ASSERT_EQUAL(startUniverse + n, d.universe);
+    TEST_ASSERT_EQUAL(syncUniverse, d.syncUniverse);
+    TEST_ASSERT_EQUAL(100, d.priority);
+    TEST_ASSERT_EQUAL(0, strcmp(d.source, "WLED living room"));
+    TEST_ASSERT_TRUE(inSequence(lastSeq[n], d.sequence));
+    lastSeq[n] = d.sequence;
+    memcpy(received + ch, d.data, d.channels);
+  }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_loopback_available(void) {
+  if (!net.open()) { net.rx = -1; TEST_MESSAGE("no UDP loopback on this host, packets are parsed from memory"); }
+}
+
+// 300 RGB pixels = 900 channels in universes of 510: two packets starting at the configured universe
+void test_frame_reassembled(void) {
+  uint8_t pixels[900], received[900];
+  for (size_t i = 0; i < sizeof(pixels); i++) pixels[i] = i * 7 + 3;
+  memset(received, 0, sizeof(received));
+  uint8_t lastSeq[2] = {0, 0};
+  sendFrame(pixels, sizeof(pixels), 510, 17, 1, 0, received, lastSeq);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(pixels, received, sizeof(pixels));
+}
+
+// full universe (512 channels, RGBW) and the highest valid universe
+void test_limits(void) {
+  uint8_t pixels[512], received[512];
+  for (size_t i = 0; i < sizeof(pixels); i++) pixels[i] = 255 - i;
+  uint8_t lastSeq[1] = {0};
+  sendFrame(pixels, sizeof(pixels), 512, E131_MAX_UNIVERSE, 9, 0, received, lastSeq);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(pixels, received, sizeof(pixels));
+  uint8_t header[E131_OUT_HEADER_LEN];
+  char longName[100];
+  memset(longName, 'x', sizeof(longName) - 1); longName[sizeof(longName) - 1] = 0;
+  e131DataHeader(header, CID, longName, 200, 0);
+  TEST_ASSERT_EQUAL('x', header[E131_FRAME_SOURCE + E131_SOURCE_LEN - 2]);
+  TEST_ASSERT_EQUAL(0, header[E131_FRAME_SOURCE + E131_SOURCE_LEN - 1]);  // truncated, still terminated
+}
+
+// two outputs with their own counters: each receiver sees its sequence advance by exactly one per frame
+// (a shared counter jumped whenever another output sent a frame, which receivers count as lost packets)
+void test_per_output_sequence(void) {
+  uint8_t pixels[600], received[600];
+  memset(pixels, 0x40, sizeof(pixels));
+  uint8_t seqA = 0, seqB = 0, lastA[2] = {0, 0}, lastB[2] = {0, 0};
+  for (int frame = 0; frame < 300; frame++) {
+    sendFrame(pixels, 600, 510, 1, ++seqA, 0, received, lastA);
+    if (frame % 3 == 0) sendFrame(pixels, 300, 510, 5, ++seqB, 0, received, lastB);
+  }
+  TEST_ASSERT_EQUAL(uint8_t(300), lastA[0]);
+  TEST_ASSERT_EQUAL(uint8_t(300), lastA[1]);
+  TEST_ASSERT_EQUAL(uint8_t(100), lastB[0]);
+}
+
+void test_sync_packet(void) {
+  uint8_t packet[E131_SYNC_PACKET_LEN + 8];
+  size_t len = e131SyncPacket(packet, CID, 42, 7000);
+  ssize_t got = net.roundTrip(packet, len, rxBuf, sizeof(rxBuf));
+  TEST_ASSERT_EQUAL(E131_SYNC_PACKET_LEN, got);
+  uint8_t seq = 0; uint16_t uni = 0;
+  TEST_ASSERT_TRUE(parseSync(rxBuf, got, seq, uni));
+  TEST_ASSERT_EQUAL(42, seq);
+  TEST_ASSERT_EQUAL(7000, uni);
+
+  // data packets announce the same sync universe, so receivers hold them until the sync arrives
+  uint8_t pixels[30], received[30];
+  memset(pixels, 1, sizeof(pixels));
+  uint8_t lastSeq[1] = {0};
+  sendFrame(pixels, sizeof(pixels), 510, 3, 42, 7000, received, lastSeq);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_loopback_available);
+  RUN_TEST(test_frame_reassembled);
+  RUN_TEST(test_limits);
+  RUN_TEST(test_per_output_sequence);
+  RUN_TEST(test_sync_packet);
+  return UNITY_END();
+}
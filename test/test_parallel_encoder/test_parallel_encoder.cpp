@@ -0,0 +1,160 @@
+// WLEDMM host tests and benchmark of the parallel output encoder (wled00/parallel_encoder.h), run with: pio test -e native
+// The encoder is checked against a plain bit-by-bit reference, and a model of a WS281x receiver decodes every lane again.
+// Benchmark numbers are for the build host; they say nothing absolute about an ESP32.
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "parallel_encoder.h"
+
+// reference: one bit of one lane at a time
+template <typename WORD>
+static void referenceEncode(const uint8_t *const *data, const size_t *len, size_t size, WORD *out) {
+  const int lanes = sizeof(WORD) * 8;
+  for (size_t pos = 0; pos < size; pos++)
+    for (int bit = 7; bit >= 0; bit--) {
+      WORD high = 0, value = 0;
+      for (int l = 0; l < lanes; l++) {
+        if (!data[l] || pos >= len[l]) continue;
+        high |= WORD(1) << l;
+        if ((data[l][pos] >> bit) & 1) value |= WORD(1) << l;
+      }
+      *out++ = high; *out++ = value; *out++ = 0;
+    }
+}
+
+// WS281x receiver model on one lane: a bit starts with a rising edge, it is 1 if the line is still high in the middle slot.
+// Returns false if a bit does not end low or the lane does not end on a byte boundary.
+template <typename WORD>
+static bool receive(const WORD *samples, size_t n, int lane, std::vector<uint8_t> &bytes) {
+  uint8_t b = 0; int nBits = 0;
+  bytes.clear();
+  for (size_t i = 0; i + 2 < n; i += PAR_SLOTS_PER_BIT) {
+    if (!((samples[i] >> lane) & 1)) continue;              // line stays low: no bit
+    if ((samples[i + 2] >> lane) & 1) return false;
+    b = (b << 1) | ((samples[i + 1] >> lane) & 1);
+    if (++nBits == 8) { bytes.push_back(b); nBits = 0; }
+  }
+  return nBits == 0;
+}
+
+static void fillRandom(std::vector<uint8_t> &v, size_t n) { v.resize(n); for (auto &b : v) b = rand(); }
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_transpose(void) {
+  srand(1);
+  for (int i = 0; i < 1000; i++) {
+    uint64_t x = (uint64_t(rand()) << 40) ^ (uint64_t(rand()) << 20) ^ rand(), t = parTranspose8(x);
+    for (int r = 0; r < 8; r++) for (int c = 0; c < 8; c++)
+      TEST_ASSERT_EQUAL((x >> (8 * r + c)) & 1, (t >> (8 * c + r)) & 1);
+    TEST_ASSERT_TRUE(parTranspose8(t) == x);  // transposing twice gives the input
+  }
+}
+
+// 8 lanes of 300 RGB LEDs: same samples as the reference, and every lane is received unchanged
+void test_8_lanes_rgb(void) {
+  std::vector<uint8_t> lanes[8];
+  const uint8_t *data[8]; size_t len[8];
+  ParallelEncoder<uint8_t> enc;
+  for (int l = 0; l < 8; l++) { fillRandom(lanes[l], 300 * 3); data[l] = lanes[l].data(); len[l] = lanes[l].size(); enc.setLane(l, data[l], len[l]); }
+  TEST_ASSERT_EQUAL(900, enc.size());
+  std::vector<uint8_t> out(enc.samples(enc.size())), ref(out.size());
+  TEST_ASSERT_EQUAL(900, enc.encode(0, enc.size(), out.data()));
+  referenceEncode<uint8_t>(data, len, enc.size(), ref.data());
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(ref.data(), out.data(), out.size());
+  std::vector<uint8_t> got;
+  for (int l = 0; l < 8; l++) {
+    TEST_ASSERT_TRUE(receive(out.data(), out.size(), l, got));
+    TEST_ASSERT_TRUE(got == lanes[l]);
+  }
+}
+
+// 16 lanes: RGB and RGBW strips of different lengths and unused lanes; short lanes stay low after their data
+void test_16_lanes_mixed(void) {
+  std::vector<uint8_t> lanes[16];
+  const uint8_t *data[16] = {}; size_t len[16] = {};
+  ParallelEncoder<uint16_t> enc;
+  for (int l = 0; l < 16; l++) {
+    if (l == 3 || l == 12) continue;  // unused
+    fillRandom(lanes[l], (l % 2 ? 4 : 3) * (50 + 17 * l));
+    data[l] = lanes[l].data(); len[l] = lanes[l].size();
+    TEST_ASSERT_TRUE(enc.setLane(l, data[l], len[l]));
+  }
+  TEST_ASSERT_FALSE(enc.setLane(16, data[0], len[0]));
+  TEST_ASSERT_EQUAL(4 * (50 + 17 * 15), enc.size());
+  std::vector<uint16_t> out(enc.samples(enc.size())), ref(out.size());
+  enc.encode(0, enc.size(), out.data());
+  referenceEncode<uint16_t>(data, len, enc.size(), ref.data());
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(ref.data(), out.data(), out.size());
+  std::vector<uint8_t> got;
+  for (int l = 0; l < 16; l++) {
+    TEST_ASSERT_TRUE(receive(out.data(), out.size(), l, got));
+    TEST_ASSERT_TRUE(got == lanes[l]);
+  }
+}
+
+// encoding in DMA buffer sized chunks gives the same samples as one pass
+void test_chunks(void) {
+  std::vector<uint8_t> a, b;
+  fillRandom(a, 100 * 3); fillRandom(b, 77 * 4);
+  ParallelEncoder<uint16_t> enc;
+  enc.setLane(0, a.data(), a.size());
+  enc.setLane(9, b.data(), b.size());
+  std::vector<uint16_t> whole(enc.samples(enc.size())), chunked(whole.size());
+  enc.encode(0, enc.size(), whole.data());
+  size_t ofs = 0, n;
+  while ((n = enc.encode(ofs, 64, chunked.data() + enc.samples(ofs))) > 0) ofs += n;
+  TEST_ASSERT_EQUAL(enc.size(), ofs);
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(whole.data(), chunked.data(), whole.size());
+  TEST_ASSERT_EQUAL(0, enc.encode(enc.size(), 64, chunked.data()));
+
+  enc.setLane(0, nullptr, 0);   // lanes can be removed again
+  enc.setLane(9, nullptr, 0);
+  TEST_ASSERT_EQUAL(0, enc.size());
+}
+
+// host only: encode time of one frame, reference against transposing, with the time the frame takes on the wire
+static volatile uint32_t sink;
+template <typename WORD>
+static void benchmark(size_t leds) {
+  const int lanes = sizeof(WORD) * 8;
+  std::vector<uint8_t> buf[16];
+  const uint8_t *data[16]; size_t len[16];
+  ParallelEncoder<WORD> enc;
+  for (int l = 0; l < lanes; l++) { fillRandom(buf[l], leds * 3); data[l] = buf[l].data(); len[l] = buf[l].size(); enc.setLane(l, data[l], len[l]); }
+  std::vector<WORD> out(enc.samples(enc.size()));
+  const int rounds = 200;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) { referenceEncode<WORD>(data, len, enc.size(), out.data()); sink += out[i]; }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) { enc.encode(0, enc.size(), out.data()); sink += out[i]; }
+  auto t2 = std::chrono::steady_clock::now();
+  double refUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / rounds;
+  double encUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / rounds;
+  double wireUs = 1e6 * enc.samples(enc.size()) / PAR_SAMPLE_HZ;
+  char msg[160];
+  snprintf(msg, sizeof(msg), "host: %2d lanes x %4u RGB LEDs: reference %7.1f us, transposed %6.1f us (%4.1fx), wire time %6.0f us",
+           lanes, unsigned(leds), refUs, encUs, refUs / encUs, wireUs);
+  TEST_MESSAGE(msg);
+}
+
+void test_benchmark(void) {
+  benchmark<uint8_t>(256);
+  benchmark<uint8_t>(1024);
+  benchmark<uint16_t>(256);
+  benchmark<uint16_t>(1024);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_transpose);
+  RUN_TEST(test_8_lanes_rgb);
+  RUN_TEST(test_16_lanes_mixed);
+  RUN_TEST(test_chunks);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
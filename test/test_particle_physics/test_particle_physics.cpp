@@ -0,0 +1,182 @@
+// WLEDMM host tests and benchmark of the particle engine physics (wled00/particle_physics.h), run with: pio test -e native
+// Trajectories are compared with the float code the effects used before (pos += vel; vel += gravity).
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <algorithm>
+#include <stdlib.h>
+#include "particle_physics.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static ps_particle_t pool[256];
+
+void test_capacity(void) {
+  TEST_ASSERT_EQUAL(21, ParticlePhysics::capacityFor(30, 8, 21, 42));   // short strip: minimum
+  TEST_ASSERT_EQUAL(37, ParticlePhysics::capacityFor(300, 8, 21, 42));
+  TEST_ASSERT_EQUAL(42, ParticlePhysics::capacityFor(4096, 8, 21, 42)); // long strip: maximum
+  TEST_ASSERT_EQUAL(42, ParticlePhysics::capacityFor(100, 0, 21, 42));  // no division by 0
+}
+
+void test_emit(void) {
+  memset(pool, 0, sizeof(pool));
+  ParticlePhysics ps(pool, 4, 100);
+  pool[0].state = PS_STATE_RESTING;
+  ps_particle_t *p = ps.emit(5, 0, 7, 0, 33);
+  TEST_ASSERT_TRUE(p == &pool[1]);                 // first free slot
+  TEST_ASSERT_EQUAL(PS_STATE_MOVING, p->state);
+  TEST_ASSERT_EQUAL(33, p->colIndex);
+  TEST_ASSERT_EQUAL(255, p->bri);
+  TEST_ASSERT_TRUE(ps.emit(0, 0, 0, 0, 0, 2) == nullptr); // nothing free below maxUsed
+  TEST_ASSERT_TRUE(ps.emit(0, 0, 0, 0, 0) == &pool[2]);
+  TEST_ASSERT_TRUE(ps.emit(0, 0, 0, 0, 0) == &pool[3]);
+  TEST_ASSERT_TRUE(ps.emit(0, 0, 0, 0, 0) == nullptr); // pool full
+}
+
+// one step: position moves with the old velocity, then gravity and friction change the velocity
+void test_update_order(void) {
+  memset(pool, 0, sizeof(pool));
+  ParticlePhysics ps(pool, 2, 100);
+  ps.gravityX = -100;
+  ps.emit(10 * PS_ONE, 0, 1000, 0, 0);
+  pool[1] = pool[0];
+  pool[1].state = PS_STATE_RESTING;                // not moved
+  ps.update();
+  TEST_ASSERT_EQUAL(10 * PS_ONE + 1000, pool[0].x);
+  TEST_ASSERT_EQUAL(900, pool[0].vx);
+  TEST_ASSERT_EQUAL(10 * PS_ONE, pool[1].x);
+  ps.friction = 128;
+  ps.update();
+  TEST_ASSERT_EQUAL(10 * PS_ONE + 1900, pool[0].x);
+  TEST_ASSERT_EQUAL(400, pool[0].vx);              // (900 - 100) * (1 - 128/256)
+  TEST_ASSERT_EQUAL(0, pool[0].y);                 // 1D: y untouched
+}
+
+// popcorn like throw on strips of different length: less than one pixel from the float code while both are in the air,
+// landing at most one frame apart (gravity is rounded to 1/PS_ONE pixel per frame, the error grows with the flight time)
+void test_trajectory_matches_float(void) {
+  const int lengths[] = {30, 144, 300, 1000};
+  for (int len : lengths) for (int speed = 0; speed < 256; speed += 51) {
+    float gravity = (-0.0001f - speed/200000.0f) * len;
+    float pos = 0.01f, vel = sqrtf(-2.0f * gravity * (len * 3 / 4));
+    memset(pool, 0, sizeof(pool));
+    ParticlePhysics ps(pool, 1, len);
+    ps.gravityX = psFixed(gravity);
+    ps.edge = PS_EDGE_FREE;
+    ps.emit(psFixed(0.01f), 0, psFixed(vel), 0, 0);
+    int frames = 0, landedFloat = 0, landedFixed = 0;
+    float maxDiff = 0.0f;
+    while ((!landedFloat || !landedFixed) && frames < 10000) {
+      pos += vel; vel += gravity;
+      ps.update();
+      frames++;
+      if (!landedFloat && pos < 0.0f) landedFloat = frames;
+      if (!landedFixed && pool[0].state == PS_STATE_FREE) landedFixed = frames;
+      if (!landedFloat && !landedFixed) maxDiff = std::max(maxDiff, fabsf(pos - float(pool[0].x) / PS_ONE));
+    }
+    if (abs(landedFloat - landedFixed) > 1 || maxDiff >= 1.0f) {
+      char msg[112];
+      snprintf(msg, sizeof(msg), "length %d speed %d: landed in frame %d instead of %d, up to %.2f pixels off", len, speed, landedFixed, landedFloat, maxDiff);
+      TEST_FAIL_MESSAGE(msg);
+    }
+  }
+}
+
+void test_edges(void) {
+  memset(pool, 0, sizeof(pool));
+  ParticlePhysics ps(pool, 1, 10);
+  ps.emit(9 * PS_ONE, 0, PS_ONE * 2, 0, 0);
+  ps.edge = PS_EDGE_CLAMP;
+  ps.update();
+  TEST_ASSERT_EQUAL(10 * PS_ONE - 1, pool[0].x);   // last pixel
+  TEST_ASSERT_EQUAL(PS_ONE * 2, pool[0].vx);       // velocity kept
+  ps.edge = PS_EDGE_BOUNCE;
+  ps.bounce = 128;
+  ps.update();
+  TEST_ASSERT_EQUAL(-PS_ONE, pool[0].vx);          // reflected at half speed
+  TEST_ASSERT_EQUAL(10 * PS_ONE - 1, pool[0].x);
+  ps.update();
+  TEST_ASSERT_EQUAL(9 * PS_ONE - 1, pool[0].x);
+  ps.edge = PS_EDGE_NONE;                          // leaves and comes back
+  ps.gravityX = PS_ONE / 4;
+  pool[0].vx = -4 * PS_ONE;
+  for (int i = 0; i < 4; i++) ps.update();
+  TEST_ASSERT_TRUE(pool[0].x < 0);
+  TEST_ASSERT_EQUAL(PS_STATE_MOVING, pool[0].state);
+  for (int i = 0; i < 40 && pool[0].x < 0; i++) ps.update();
+  TEST_ASSERT_TRUE(pool[0].x >= 0);
+  ps.edge = PS_EDGE_FREE;
+  for (int i = 0; i < 40 && pool[0].state != PS_STATE_FREE; i++) ps.update();
+  TEST_ASSERT_EQUAL(PS_STATE_FREE, pool[0].state);
+}
+
+void test_2d(void) {
+  memset(pool, 0, sizeof(pool));
+  ParticlePhysics ps(pool, 1, 16, 8);
+  ps.gravityY = -PS_ONE / 8;
+  ps.edge = PS_EDGE_BOUNCE;
+  ps.emit(2 * PS_ONE, 7 * PS_ONE, PS_ONE, 0, 0);
+  ps.update();
+  TEST_ASSERT_EQUAL(3 * PS_ONE, pool[0].x);
+  TEST_ASSERT_EQUAL(7 * PS_ONE, pool[0].y);
+  TEST_ASSERT_EQUAL(-PS_ONE / 8, pool[0].vy);
+  for (int i = 0; i < 100; i++) {
+    ps.update();
+    TEST_ASSERT_TRUE(pool[0].x >= 0 && pool[0].x < ps.maxX);
+    TEST_ASSERT_TRUE(pool[0].y >= 0 && pool[0].y < ps.maxY);
+  }
+}
+
+// the float particle the effects used before (Spark in FX.cpp, padded to 20 bytes)
+struct FloatSpark { float pos, posX, vel, velX; uint16_t col; uint8_t colIndex; };
+static FloatSpark sparks[256];
+
+// host only: ns per physics step of a pool, popcorn style (1D, gravity, released below 0); not ESP32 numbers
+static volatile int32_t sink;
+void test_benchmark(void) {
+  const int sizes[] = {21, 42, 128, 256};
+  const int frames = 200000;
+  const float gravity = -0.0003f * 300;
+  for (int n : sizes) {
+    for (int i = 0; i < n; i++) { sparks[i] = {float(i), 0, 5.0f + i % 7, 0, 0, 0}; }
+    auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+      for (int i = 0; i < n; i++) {
+        if (sparks[i].pos >= 0.0f) { sparks[i].pos += sparks[i].vel; sparks[i].vel += gravity; }
+        else { sparks[i].pos = 0.01f; sparks[i].vel = 5.0f; }
+      }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    memset(pool, 0, sizeof(pool));
+    ParticlePhysics ps(pool, n, 300);
+    ps.gravityX = psFixed(gravity);
+    for (int i = 0; i < n; i++) ps.emit(i * PS_ONE, 0, (5 + i % 7) * PS_ONE, 0, 0);
+    auto t2 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+      ps.update();
+      for (int i = 0; i < n; i++) if (pool[i].state == PS_STATE_FREE) { pool[i].x = PS_ONE/100; pool[i].vx = 5 * PS_ONE; pool[i].state = PS_STATE_MOVING; }
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    sink = int32_t(sparks[0].pos) + pool[0].x;
+    char msg[120];
+    snprintf(msg, sizeof(msg), "host: %3d particles, physics per frame: float %.0f ns, fixed point %.0f ns", n,
+             std::chrono::duration<double, std::nano>(t1 - t0).count() / frames,
+             std::chrono::duration<double, std::nano>(t3 - t2).count() / frames);
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_capacity);
+  RUN_TEST(test_emit);
+  RUN_TEST(test_update_order);
+  RUN_TEST(test_trajectory_matches_float);
+  RUN_TEST(test_edges);
+  RUN_TEST(test_2d);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
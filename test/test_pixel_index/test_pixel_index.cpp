@@ -0,0 +1,40 @@
+// WLEDMM host tests for the pixel index types and virtual strip packing (const.h), default build
+#include <unity.h>
+#include <stdint.h>
+#include "const.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_default_types(void) {
+  TEST_ASSERT_EQUAL(2, sizeof(pixidx_t));
+  TEST_ASSERT_EQUAL(1, sizeof(rowidx_t));
+  TEST_ASSERT_TRUE(MAX_LEDS - 1 <= pixidx_t(-1));
+  TEST_ASSERT_EQUAL(0xFFFF, PIXIDX_NONE);
+}
+
+// the packing must stay identical to the old "i | (vStrip << 16)" so existing effects behave the same
+void test_vstrip_packing_unchanged(void) {
+  TEST_ASSERT_EQUAL(16, VSTRIP_SHIFT);
+  for (int vStrip = 0; vStrip <= 256; vStrip++)
+    for (int i = 0; i < MAX_LEDS; i += 127) {
+      int packed = VSTRIP_PACK(i, vStrip);
+      TEST_ASSERT_EQUAL(i | (vStrip << 16), packed);
+      TEST_ASSERT_EQUAL(vStrip, VSTRIP_OF(packed));
+      TEST_ASSERT_EQUAL(i, VSTRIP_INDEX(packed));
+    }
+}
+
+// negative indexes keep failing the range check in Segment::setPixelColor()
+void test_negative_index(void) {
+  TEST_ASSERT_EQUAL(-1, VSTRIP_OF(-1));
+  TEST_ASSERT_TRUE(VSTRIP_INDEX(-1) >= MAX_LEDS);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_default_types);
+  RUN_TEST(test_vstrip_packing_unchanged);
+  RUN_TEST(test_negative_index);
+  return UNITY_END();
+}
@@ -0,0 +1,61 @@
+// WLEDMM host tests for the pixel index types and virtual strip packing (const.h), -D WLED_LARGE_INSTALLATION build
+#include <unity.h>
+#include <stdint.h>
+#define WLED_LARGE_INSTALLATION
+#include "const.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_large_types(void) {
+  TEST_ASSERT_EQUAL(4, sizeof(pixidx_t));
+  TEST_ASSERT_EQUAL(2, sizeof(rowidx_t));
+  TEST_ASSERT_TRUE(MAX_LEDS > 65536);
+  TEST_ASSERT_TRUE(rowidx_t(300) == 300); // more than 255 rows
+}
+
+// 256x256 matrix: 65536 pixels, a 1D effect on "Pixels" mapping uses indexes up to 65535
+void test_matrix_256x256(void) {
+  const pixidx_t vW = 256, vH = 256;
+  pixidx_t count = vW * vH;
+  TEST_ASSERT_EQUAL(65536, count);
+  for (pixidx_t i = 0; i < count; i++) {
+    int packed = VSTRIP_PACK(i, 0);
+    TEST_ASSERT_EQUAL(0, VSTRIP_OF(packed));
+    pixidx_t idx = VSTRIP_INDEX(packed);
+    TEST_ASSERT_EQUAL(i, idx);
+    TEST_ASSERT_TRUE(idx % vW < vW && idx / vW < vH); // M12_Pixels mapping
+  }
+  // last row and column of the "Bar" expansion: every column is a virtual strip of vH pixels
+  for (int vStrip = 1; vStrip <= int(vW); vStrip++) {
+    int packed = VSTRIP_PACK(vH - 1, vStrip);
+    TEST_ASSERT_EQUAL(vStrip, VSTRIP_OF(packed));
+    TEST_ASSERT_EQUAL(vH - 1, VSTRIP_INDEX(packed));
+  }
+}
+
+// 1D strips beyond 16 bit: with the old 0xFFFF mask pixel 70000 landed on pixel 4464
+void test_strip_above_65536(void) {
+  const pixidx_t len = 70000;
+  for (pixidx_t i = 65530; i < len; i++) {
+    TEST_ASSERT_EQUAL(i, VSTRIP_INDEX(VSTRIP_PACK(i, 0)));
+    TEST_ASSERT_EQUAL(i, VSTRIP_INDEX(VSTRIP_PACK(i, 1023)));
+    TEST_ASSERT_EQUAL(1023, VSTRIP_OF(VSTRIP_PACK(i, 1023)));
+  }
+  TEST_ASSERT_TRUE(VSTRIP_INDEX(VSTRIP_PACK(MAX_LEDS - 1, 0)) == MAX_LEDS - 1);
+  TEST_ASSERT_TRUE(pixidx_t(len) != pixidx_t(len & 0xFFFF));
+}
+
+void test_negative_index(void) {
+  TEST_ASSERT_EQUAL(-1, VSTRIP_OF(-1));
+  TEST_ASSERT_TRUE(VSTRIP_INDEX(-1) >= MAX_LEDS);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_large_types);
+  RUN_TEST(test_matrix_256x256);
+  RUN_TEST(test_strip_above_65536);
+  RUN_TEST(test_negative_index);
+  return UNITY_END();
+}
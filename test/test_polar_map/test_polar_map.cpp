@@ -0,0 +1,98 @@
+// WLEDMM host tests and benchmark for the 2 byte polar map (wled00/polar_map.h), run with: pio test -e native
+#include <unity.h>
+#include <stdio.h>
+#include <time.h>
+#include "wled_math.cpp"
+#include "polar_map.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static polar_t polarMap[256 * 256];
+
+static double angleDiff(double a, double b, double circle) {
+  double d = fabs(a - b);
+  return d > circle / 2 ? circle - d : d;
+}
+
+// every entry against float math: angle and radius rounded to the nearest unit (plus 1/32 pixel for the radius)
+static void checkMap(uint16_t cols, uint16_t rows, int cx, int cy) {
+  fillPolarMap(polarMap, cols, rows, cx, cy);
+  const double maxDim = (cols > rows) ? cols : rows;
+  const float rTolerance = 0.5f + POLAR_RADIUS_SCALE / 32.0 / maxDim;
+  for (int y = 0; y < rows; y++)
+    for (int x = 0; x < cols; x++) {
+      const polar_t &p = polarMap[x + y * cols];
+      double a = atan2(y - cy, x - cx) * 256.0 / (2.0 * M_PI);
+      if (a < 0) a += 256.0;
+      double r = hypot(x - cx, y - cy) * POLAR_RADIUS_SCALE / maxDim;
+      TEST_ASSERT_TRUE(angleDiff(p.angle, a, 256.0) <= 0.51);
+      TEST_ASSERT_FLOAT_WITHIN(rTolerance, float(r), float(p.radius));
+    }
+}
+
+void test_map_accuracy(void) {
+  checkMap(16, 16, 8, 8);
+  checkMap(64, 32, 32, 16);
+  checkMap(32, 64, 0, 0);       // centre in a corner: largest radius (sqrt(2) * 128)
+  checkMap(256, 256, 255, 255);
+  checkMap(200, 7, 100, 3);
+}
+
+// Octopus: radius in pixels * mapp, as the original per-segment map (hypotf() * mapp) - within one map unit, rounded
+void test_octopus_radius(void) {
+  const uint16_t sizes[] = {16, 32, 48, 64, 128};
+  for (uint16_t n : sizes) {
+    const uint8_t mapp = 180 / n;
+    fillPolarMap(polarMap, n, n, n / 2, n / 2);
+    const double tolerance = (0.5 + POLAR_RADIUS_SCALE / 32.0 / n) * n / POLAR_RADIUS_SCALE * mapp + 0.5;
+    for (int y = 0; y < n; y++)
+      for (int x = 0; x < n; x++)
+        TEST_ASSERT_TRUE(fabs(double(polarRadius(polarMap[x + y * n], n, mapp)) - hypot(x - n / 2, y - n / 2) * mapp) <= tolerance);
+  }
+}
+
+void test_two_bytes_per_pixel(void) {
+  TEST_ASSERT_EQUAL(2, sizeof(polar_t));
+}
+
+// host timing only: shows the ratio between per-pixel float math and a map lookup, not ESP32 cycles
+static volatile uint32_t sink;
+static double msSince(clock_t start) { return (clock() - start) * 1000.0 / CLOCKS_PER_SEC; }
+
+void test_benchmark(void) {
+  const int frames = 200;
+  const uint16_t sizes[] = {32, 64, 128};
+  for (uint16_t n : sizes) {
+    const int cx = n / 2, cy = n / 2;
+    clock_t t = clock();
+    for (int f = 0; f < frames; f++)
+      for (int y = 0; y < n; y++)
+        for (int x = 0; x < n; x++)
+          sink += uint8_t(40.7436f * atan2f(y - cy, x - cx)) + uint8_t(hypotf(x - cx, y - cy));
+    double msFloat = msSince(t);
+
+    t = clock();
+    fillPolarMap(polarMap, n, n, cx, cy);
+    double msFill = msSince(t);
+    t = clock();
+    for (int f = 0; f < frames; f++) {
+      const polar_t *p = polarMap;
+      for (int i = 0; i < n * n; i++, p++) sink += p->angle + p->radius;
+    }
+    double msMap = msSince(t);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%3ux%-3u: atan2f+hypotf %.1f us/frame, map lookup %.2f us/frame, map build %.1f us, map %u bytes",
+             n, n, msFloat * 1000.0 / frames, msMap * 1000.0 / frames, msFill * 1000.0, unsigned(n * n * sizeof(polar_t)));
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_map_accuracy);
+  RUN_TEST(test_octopus_radius);
+  RUN_TEST(test_two_bytes_per_pixel);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
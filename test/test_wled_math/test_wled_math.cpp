@@ -0,0 +1,87 @@
+// WLEDMM host accuracy tests for the fast math functions in wled00/wled_math.cpp, run with: pio test -e native
+// Limits are the ones documented at the top of wled_math.cpp (max. error vs. libm).
+#include <unity.h>
+#include "wled_math.cpp"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// fixed point: at most 1 LSB off over the whole circle
+void test_sin16_cos16(void) {
+  for (uint32_t t = 0; t < 65536; t++) {
+    double rad = t * (2.0 * M_PI / 65536.0);
+    TEST_ASSERT_FLOAT_WITHIN(1.05f, float(sin(rad) * 32767.0), float(sin16_t(t)));
+    TEST_ASSERT_FLOAT_WITHIN(1.05f, float(cos(rad) * 32767.0), float(cos16_t(t)));
+  }
+  TEST_ASSERT_EQUAL(0, sin16_t(0));
+  TEST_ASSERT_EQUAL(32767, sin16_t(16384));
+  TEST_ASSERT_EQUAL(-32767, sin16_t(49152));
+}
+
+void test_sin_cos(void) {
+  for (float x = -10.0f; x < 10.0f; x += 0.001f) {
+    TEST_ASSERT_FLOAT_WITHIN(8e-5f, sinf(x), sin_t(x));
+    TEST_ASSERT_FLOAT_WITHIN(8e-5f, cosf(x), cos_t(x));
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, sinf(1e6f), sin_t(1e6f)); // large arguments are reduced first
+}
+
+// angles compared on the circle, so -PI and PI are the same
+static double angleDiff(double a, double b, double circle) {
+  double d = fabs(a - b);
+  return d > circle / 2 ? circle - d : d;
+}
+
+void test_atan2(void) {
+  for (float y = -20.0f; y <= 20.0f; y += 0.37f)
+    for (float x = -20.0f; x <= 20.0f; x += 0.29f)
+      TEST_ASSERT_TRUE(angleDiff(atan2_t(y, x), atan2(y, x), 2.0 * M_PI) <= 5e-5);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, atan2_t(0.0f, 0.0f));
+  TEST_ASSERT_FLOAT_WITHIN(5e-5f, float(M_PI / 2), atan2_t(1.0f, 0.0f));
+  TEST_ASSERT_FLOAT_WITHIN(5e-5f, float(-M_PI / 2), atan2_t(-1.0f, 0.0f));
+}
+
+void test_atan2_16(void) {
+  for (int y = -300; y <= 300; y += 7)
+    for (int x = -300; x <= 300; x += 5) {
+      if (x == 0 && y == 0) continue;
+      double ref = atan2(y, x) * (65536.0 / (2.0 * M_PI));
+      if (ref < 0) ref += 65536.0;
+      TEST_ASSERT_TRUE(angleDiff(atan2_16_t(y, x), ref, 65536.0) <= 1.05);
+    }
+  // large vectors are scaled down before the division
+  TEST_ASSERT_TRUE(angleDiff(atan2_16_t(2000000, 1000000), atan2(2.0, 1.0) * (65536.0 / (2.0 * M_PI)), 65536.0) <= 1.05);
+  TEST_ASSERT_EQUAL(0, atan2_16_t(0, 0));
+  TEST_ASSERT_EQUAL(16384, atan2_16_t(5, 0));
+}
+
+void test_sqrt_hypot(void) {
+  for (uint32_t x = 0; x < 200000; x++) {
+    uint32_t r = sqrt32_t(x);
+    TEST_ASSERT_TRUE(r * r <= x && (r + 1) * (r + 1) > x);
+  }
+  TEST_ASSERT_EQUAL(65535, sqrt32_t(0xFFFFFFFFUL));
+  TEST_ASSERT_EQUAL(5, hypot_t(3, -4));
+  TEST_ASSERT_EQUAL(46339, hypot_t(32767, 32767));
+}
+
+void test_exp(void) {
+  for (float x = -80.0f; x < 80.0f; x += 0.01f) {
+    float ref = expf(x);
+    TEST_ASSERT_FLOAT_WITHIN(ref * 1.2e-4f, ref, exp_t(x));
+  }
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, exp_t(-100.0f)); // underflow
+  TEST_ASSERT_TRUE(exp_t(1000.0f) > 1e38f);    // clamped, but not inf
+  TEST_ASSERT_TRUE(exp_t(1000.0f) < INFINITY);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sin16_cos16);
+  RUN_TEST(test_sin_cos);
+  RUN_TEST(test_atan2);
+  RUN_TEST(test_atan2_16);
+  RUN_TEST(test_sqrt_hypot);
+  RUN_TEST(test_exp);
+  return UNITY_END();
+}
@@ -0,0 +1,102 @@
+// WLEDMM host tests for wled00/ws281x_encoder.h, run with: pio test -e native
+#include <unity.h>
+#include <string.h>
+#include "ws281x_encoder.h"
+
+#define COL_ORDER_GRB 0
+#define COL_ORDER_RGB 1
+#define COL_ORDER_BGR 4
+
+// reference items for WS2812X_TIMING at 25ns per tick
+static const uint32_t B0 = 0x00228010; // 16 ticks high (400ns), 34 ticks low (850ns)
+static const uint32_t B1 = 0x00128020; // 32 ticks high (800ns), 18 ticks low (450ns)
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_item_layout(void) {
+  TEST_ASSERT_EQUAL_HEX32(B0, WS281xEncoder::item(WS2812X_TIMING.t0h, WS2812X_TIMING.t0l));
+  TEST_ASSERT_EQUAL_HEX32(B1, WS281xEncoder::item(WS2812X_TIMING.t1h, WS2812X_TIMING.t1l));
+}
+
+void test_grb_waveform(void) {
+  const uint8_t pixels[] = {0x80, 0x01, 0xFF}; // R, G, B
+  WS281xEncoder enc;
+  enc.begin(pixels, 1, COL_ORDER_GRB, 255, false, WS2812X_TIMING);
+  uint32_t items[24];
+  TEST_ASSERT_EQUAL(3, enc.encode(0, 3, items));
+  const uint32_t expected[24] = {
+    B0, B0, B0, B0, B0, B0, B0, B1, // G = 0x01
+    B1, B0, B0, B0, B0, B0, B0, B0, // R = 0x80
+    B1, B1, B1, B1, B1, B1, B1, B1, // B = 0xFF
+  };
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(expected, items, 24);
+}
+
+void test_color_orders(void) {
+  const uint8_t pixels[] = {0x11, 0x22, 0x33};
+  WS281xEncoder enc;
+  enc.begin(pixels, 1, COL_ORDER_RGB, 255, false, WS2812X_TIMING);
+  TEST_ASSERT_EQUAL_HEX8(0x11, enc.wireByte(0));
+  TEST_ASSERT_EQUAL_HEX8(0x22, enc.wireByte(1));
+  TEST_ASSERT_EQUAL_HEX8(0x33, enc.wireByte(2));
+  enc.begin(pixels, 1, COL_ORDER_BGR, 255, false, WS2812X_TIMING);
+  TEST_ASSERT_EQUAL_HEX8(0x33, enc.wireByte(0));
+  TEST_ASSERT_EQUAL_HEX8(0x22, enc.wireByte(1));
+  TEST_ASSERT_EQUAL_HEX8(0x11, enc.wireByte(2));
+}
+
+void test_brightness_matches_npb_dim(void) {
+  const uint8_t pixels[] = {255, 128, 1};
+  WS281xEncoder enc;
+  enc.begin(pixels, 1, COL_ORDER_RGB, 127, false, WS2812X_TIMING);
+  TEST_ASSERT_EQUAL_HEX8((255 * 128) >> 8, enc.wireByte(0));
+  TEST_ASSERT_EQUAL_HEX8((128 * 128) >> 8, enc.wireByte(1));
+  TEST_ASSERT_EQUAL_HEX8(0, enc.wireByte(2));
+  enc.begin(pixels, 1, COL_ORDER_RGB, 0, false, WS2812X_TIMING);
+  TEST_ASSERT_EQUAL_HEX8(0, enc.wireByte(0));
+}
+
+void test_reversed(void) {
+  const uint8_t pixels[] = {1, 2, 3, 4, 5, 6};
+  WS281xEncoder enc;
+  enc.begin(pixels, 2, COL_ORDER_RGB, 255, true, WS2812X_TIMING);
+  TEST_ASSERT_EQUAL_HEX8(4, enc.wireByte(0)); // last pixel goes out first
+  TEST_ASSERT_EQUAL_HEX8(3, enc.wireByte(5));
+}
+
+void test_order_ranges(void) {
+  const uint8_t pixels[] = {1, 2, 3, 1, 2, 3, 1, 2, 3};
+  WS281xEncoder enc;
+  enc.begin(pixels, 3, COL_ORDER_RGB, 255, false, WS2812X_TIMING);
+  TEST_ASSERT_TRUE(enc.addColorOrderRange(1, 1, COL_ORDER_GRB));
+  TEST_ASSERT_EQUAL_HEX8(1, enc.wireByte(0));
+  TEST_ASSERT_EQUAL_HEX8(2, enc.wireByte(3)); // second LED is GRB
+  TEST_ASSERT_EQUAL_HEX8(1, enc.wireByte(6));
+}
+
+// the RMT driver asks for the bitstream in chunks of any size: the result must not depend on them
+void test_chunked_encode(void) {
+  uint8_t pixels[3 * 7];
+  for (size_t i = 0; i < sizeof(pixels); i++) pixels[i] = i * 37 + 5;
+  WS281xEncoder enc;
+  enc.begin(pixels, 7, COL_ORDER_GRB, 200, true, WS2812X_TIMING);
+  uint32_t whole[3 * 7 * 8], chunked[3 * 7 * 8 + 8];
+  TEST_ASSERT_EQUAL(sizeof(pixels), enc.encode(0, sizeof(pixels), whole));
+  size_t ofs = 0, step = 1;
+  while (ofs < enc.size()) { ofs += enc.encode(ofs, step, chunked + ofs * 8); step = step % 4 + 1; }
+  TEST_ASSERT_EQUAL_HEX32_ARRAY(whole, chunked, 3 * 7 * 8);
+  TEST_ASSERT_EQUAL(0, enc.encode(enc.size(), 1, chunked)); // nothing past the end
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_item_layout);
+  RUN_TEST(test_grb_waveform);
+  RUN_TEST(test_color_orders);
+  RUN_TEST(test_brightness_matches_npb_dim);
+  RUN_TEST(test_reversed);
+  RUN_TEST(test_order_ranges);
+  RUN_TEST(test_chunked_encode);
+  return UNITY_END();
+}
@@ -24,6 +24,7 @@ class WordClockUsermod : public Usermod
     bool usermodActive = false;
     bool displayItIs = false;
     int ledOffset = 100;
+    OverlayLayer maskLayer; // WLEDMM retained copy of the blanked LEDs
     bool meander = false;
     bool nord = false;
     
@@ -480,17 +481,23 @@ class WordClockUsermod : public Usermod
       // check if usermod is active
       if (usermodActive == true)
       {
-        // loop over all leds
-        for (int x = 0; x < maskSizeLeds; x++)
+        // WLEDMM mask only changes once per minute, rebuild the layer then
+        if (maskLayer.changed(uint32_t(lastTimeMinutes) ^ (uint32_t(ledOffset) << 8)))
         {
-          // check mask
-          if (maskLedsOn[x] == 0)
+          // loop over all leds
+          for (int x = 0; x < maskSizeLeds; x++)
           {
-            // set pixel off
-            strip.setPixelColor(x + ledOffset, RGBW32(0,0,0,0));
+            // check mask
+            if (maskLedsOn[x] == 0)
+            {
+              // set pixel off
+              maskLayer.setPixelColor(x + ledOffset, RGBW32(0,0,0,0));
+            }
           }
         }
+        maskLayer.apply();
       }
+      else maskLayer.invalidate();
     }
 
     /*
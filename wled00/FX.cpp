@@ -34,7 +34,7 @@
 #define PALETTE_SOLID_WRAP   (strip.paletteBlend == 1 || strip.paletteBlend == 3)
 #define PALETTE_MOVING_WRAP !(strip.paletteBlend == 2 || (strip.paletteBlend == 0 && SEGMENT.speed == 0))
 
-#define indexToVStrip(index, stripNr) ((index) | (int((stripNr)+1)<<16))
+#define indexToVStrip(index, stripNr) VSTRIP_PACK(index, (stripNr)+1)
 
 // effect utility functions
 static uint8_t sin_gap(uint16_t in) {
@@ -340,9 +340,10 @@ static const char _data_FX_MODE_DYNAMIC_SMOOTH[] PROGMEM = "Dynamic Smooth@!,!;;
 /*
  * Does the "standby-breathing" of well known i-Devices.
  */
-uint16_t mode_breath(void) {
+uint16_t mode_breath(RenderContext &ctx) { // WLEDMM uses render context
+  Segment &seg = ctx.seg;
   uint16_t var = 0;
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 3) +10));
+  uint16_t counter = (ctx.now * ((seg.speed >> 3) +10));
   counter = (counter >> 2) + (counter >> 4); //0-16384 + 0-2048
   if (counter < 16384) {
     if (counter > 8192) counter = 8192 - (counter - 8192);
@@ -350,8 +351,9 @@ uint16_t mode_breath(void) {
   }
 
   uint8_t lum = 30 + var;
-  for (int i = 0; i < SEGLEN; i++) {
-    SEGMENT.setPixelColor(i, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(i, true, PALETTE_SOLID_WRAP, 0), lum));
+  const uint32_t bgColor = ctx.colors[1];
+  for (int i = 0; i < ctx.vLength; i++) {
+    seg.setPixelColor(i, color_blend(bgColor, seg.color_from_palette(i, true, PALETTE_SOLID_WRAP, 0), lum));
   }
 
   return FRAMETIME;
@@ -362,12 +364,14 @@ static const char _data_FX_MODE_BREATH[] PROGMEM = "Breathe@!;!,!;!;01";
 /*
  * Fades the LEDs between two colors
  */
-uint16_t mode_fade(void) {
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 3) +10));
+uint16_t mode_fade(RenderContext &ctx) { // WLEDMM uses render context
+  Segment &seg = ctx.seg;
+  uint16_t counter = (ctx.now * ((seg.speed >> 3) +10));
   uint8_t lum = triwave16(counter) >> 8;
 
-  for (int i = 0; i < SEGLEN; i++) {
-    SEGMENT.setPixelColor(i, color_blend(SEGCOLOR(1), SEGMENT.color_from_palette(i, true, PALETTE_SOLID_WRAP, 0), lum));
+  const uint32_t bgColor = ctx.colors[1];
+  for (int i = 0; i < ctx.vLength; i++) {
+    seg.setPixelColor(i, color_blend(bgColor, seg.color_from_palette(i, true, PALETTE_SOLID_WRAP, 0), lum));
   }
 
   return FRAMETIME;
@@ -427,14 +431,15 @@ static const char _data_FX_MODE_DUAL_SCAN[] PROGMEM = "Scan Dual@!,# of dots,,,,
 /*
  * Cycles all LEDs at once through a rainbow.
  */
-uint16_t mode_rainbow(void) {
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 2) +2)) & 0xFFFF;
+uint16_t mode_rainbow(RenderContext &ctx) { // WLEDMM uses render context
+  Segment &seg = ctx.seg;
+  uint16_t counter = (ctx.now * ((seg.speed >> 2) +2)) & 0xFFFF;
   counter = counter >> 8;
 
-  if (SEGMENT.intensity < 128){
-    SEGMENT.fill(color_blend(SEGMENT.color_wheel(counter),WHITE,128-SEGMENT.intensity));
+  if (seg.intensity < 128){
+    seg.fill(color_blend(seg.color_wheel(counter),WHITE,128-seg.intensity));
   } else {
-    SEGMENT.fill(SEGMENT.color_wheel(counter));
+    seg.fill(seg.color_wheel(counter));
   }
 
   return FRAMETIME;
@@ -445,14 +450,17 @@ static const char _data_FX_MODE_RAINBOW[] PROGMEM = "Colorloop@!,Saturation;;!;0
 /*
  * Cycles a rainbow over the entire string of LEDs.
  */
-uint16_t mode_rainbow_cycle(void) {
-  uint16_t counter = (strip.now * ((SEGMENT.speed >> 2) +2)) & 0xFFFF;
+uint16_t mode_rainbow_cycle(RenderContext &ctx) { // WLEDMM uses render context
+  Segment &seg = ctx.seg;
+  uint16_t counter = (ctx.now * ((seg.speed >> 2) +2)) & 0xFFFF;
   counter = counter >> 8;
 
-  for (int i = 0; i < SEGLEN; i++) {
+  const uint16_t segLen = ctx.vLength;
+  const unsigned size = 16 << (seg.intensity /29);
+  for (int i = 0; i < segLen; i++) {
     //intensity/29 = 0 (1/16) 1 (1/8) 2 (1/4) 3 (1/2) 4 (1) 5 (2) 6 (4) 7 (8) 8 (16)
-    uint8_t index = (i * (16 << (SEGMENT.intensity /29)) / SEGLEN) + counter;
-    SEGMENT.setPixelColor(i, SEGMENT.color_wheel(index));
+    uint8_t index = (i * size / segLen) + counter;
+    seg.setPixelColor(i, seg.color_wheel(index));
   }
 
   return FRAMETIME;
@@ -2940,7 +2948,7 @@ uint16_t mode_bouncing_balls(void) {
     static void runStrip(size_t stripNr, Ball* balls) {
       // number of balls based on intensity setting to max of 7 (cycles colors)
       // non-chosen color is a random color
-      uint16_t numBalls = (SEGMENT.intensity * (maxNumBalls - 1)) / 255 + 1; // minimum 1 ball
+      uint16_t numBalls = SEGMENT.qualityScaled((SEGMENT.intensity * (maxNumBalls - 1)) / 255 + 1); // minimum 1 ball // WLEDMM fewer balls when over frame budget
       const float gravity = -9.81f; // standard value of gravity
       const bool hasCol2 = SEGCOLOR(2);
       const unsigned long time = strip.now;
@@ -3176,34 +3184,29 @@ uint16_t mode_solid_glitter()
 static const char _data_FX_MODE_SOLID_GLITTER[] PROGMEM = "Solid Glitter@,!;Bg,,Glitter color;;;m12=0";
 
 
-//each needs 19 bytes
-//Spark type is used for popcorn, 1D fireworks, and drip
-typedef struct Spark {
-  float pos, posX;
-  float vel, velX;
-  uint16_t col;
-  uint8_t colIndex;
-} spark;
-
+// WLEDMM popcorn, 1D fireworks and drip use ParticleSystem (FX.h), 20 bytes per particle
 #define maxNumPopcorn 21 // max 21 on 16 segment ESP8266
 /*
 *  POPCORN
 *  modified from https://github.com/kitesurfer1404/WS2812FX/blob/master/src/custom/Popcorn.h
 */
+static uint32_t popcorn_color(const ps_particle_t &p) { // WLEDMM ParticleSystem render callback
+  if (!SEGMENT.palette && p.colIndex < NUM_COLORS) return SEGCOLOR(p.colIndex);
+  return SEGMENT.color_wheel(p.colIndex);
+}
+
 static uint16_t mode_popcorn_core(bool useaudio) {
   if (SEGLEN == 1) return mode_static();
   //allocate segment data
   uint16_t strips = SEGMENT.nrOfVStrips();
-  size_t dataSize = sizeof(spark) * maxNumPopcorn;
-  uint8_t neededPopcorn = maxNumPopcorn; // WLEDMM
+  uint16_t maxPopcorn = ParticleSystem::capacityFor(SEGLEN, 8, maxNumPopcorn, 2*maxNumPopcorn); // WLEDMM more kernels on long strips
+  uint16_t neededPopcorn = maxPopcorn; // WLEDMM
   if (strips > 8) {  // WLEDMM more than 8 virtual strips --> reduce memory requirements to minimum necessary
-    neededPopcorn = (SEGMENT.intensity*maxNumPopcorn)/255;
-    neededPopcorn = min(max(neededPopcorn, uint8_t(2)), uint8_t(maxNumPopcorn));
-    dataSize = sizeof(spark) * neededPopcorn;
+    neededPopcorn = (SEGMENT.intensity*maxPopcorn)/255;
+    neededPopcorn = min(max(neededPopcorn, uint16_t(2)), maxPopcorn);
   }
-  if (!SEGENV.allocateData(dataSize * strips)) return mode_static(); //allocation failed
-
-  Spark* popcorn = reinterpret_cast<Spark*>(SEGENV.data);
+  ps_particle_t* popcorn = ParticleSystem::allocate(SEGMENT, neededPopcorn, strips);
+  if (!popcorn) return mode_static(); //allocation failed
 
   bool hasCol2 = SEGCOLOR(2);
   if (!SEGMENT.check2) SEGMENT.fill(hasCol2 ? BLACK : SEGCOLOR(1));
@@ -3217,63 +3220,62 @@ static uint16_t mode_popcorn_core(bool useaudio) {
   }
 
   struct virtualStrip {
-    static void runStrip(uint16_t stripNr, Spark* popcorn, bool useaudio, um_data_t *um_data) {  // WLEDMM added useaudio and um_data
+    static void runStrip(uint16_t stripNr, ps_particle_t* popcorn, uint16_t poolSize, uint16_t maxPopcorn, bool useaudio, um_data_t *um_data) {  // WLEDMM added useaudio and um_data
       float gravity = -0.0001f - (SEGMENT.speed/200000.0f); // m/s/s
       gravity *= SEGLEN;
 
-      uint8_t numPopcorn = SEGMENT.intensity*maxNumPopcorn/255;
-      if (numPopcorn == 0) numPopcorn = 1;
+      ParticleSystem ps(popcorn, poolSize, SEGLEN);
+      ps.gravityX = min(psFixed(gravity), int32_t(-1));
+      ps.edge = PS_EDGE_FREE; // kernel is done when it falls below 0
+
+      uint16_t numPopcorn = SEGMENT.intensity*maxPopcorn/255;
+      numPopcorn = constrain(numPopcorn, 1, poolSize);
       // WLEDMM audioreactive vars
       float   volumeSmth  = *(float*)   um_data->u_data[0];
       int16_t volumeRaw   = *(int16_t*) um_data->u_data[1];
       uint8_t samplePeak  = *(uint8_t*) um_data->u_data[3];
 
-      for(int i = 0; i < numPopcorn; i++) {
-        if (popcorn[i].pos >= 0.0f) { // if kernel is active, update its position
-          popcorn[i].pos += popcorn[i].vel;
-          popcorn[i].vel += gravity;
-        } else { // if kernel is inactive, randomly pop it
-          bool doPopCorn = false;  // WLEDMM allows to inhibit new pops
-          // WLEDMM begin
-          if (useaudio) {
-            if (  (volumeSmth > 1.0f)                      // no pops in silence
-                &&((samplePeak > 0) || (volumeRaw > 128))  // try to pop at onsets (our peek detector still sucks)
-                &&(random8() < 4) )                        // stay somewhat random
-              doPopCorn = true;
-          } else {         
-            if (random8() < 2) doPopCorn = true; // default POP!!!
-          }
-          // WLEDMM end
-
-          if (doPopCorn) { // POP!!!
-            popcorn[i].pos = 0.01f;
-
-            uint16_t peakHeight = 128 + random8(128); //0-255
-            peakHeight = (peakHeight * (SEGLEN -1)) >> 8;
-            popcorn[i].vel = sqrtf(-2.0f * gravity * peakHeight);
+      ps.update(numPopcorn); // move active kernels
 
-            if (SEGMENT.palette)
-            {
-              popcorn[i].colIndex = random8();
-            } else {
-              byte col = random8(0, NUM_COLORS);
-              if (!SEGCOLOR(2) || !SEGCOLOR(col)) col = 0;
-              popcorn[i].colIndex = col;
-            }
-          }
+      for(int i = 0; i < numPopcorn; i++) {
+        if (popcorn[i].state != PS_STATE_FREE) continue;
+        // kernel is inactive, randomly pop it
+        bool doPopCorn = false;  // WLEDMM allows to inhibit new pops
+        // WLEDMM begin
+        if (useaudio) {
+          if (  (volumeSmth > 1.0f)                      // no pops in silence
+              &&((samplePeak > 0) || (volumeRaw > 128))  // try to pop at onsets (our peek detector still sucks)
+              &&(random8() < 4) )                        // stay somewhat random
+            doPopCorn = true;
+        } else {
+          if (random8() < 2) doPopCorn = true; // default POP!!!
         }
-        if (popcorn[i].pos >= 0.0f) { // draw now active popcorn (either active before or just popped)
-          uint32_t col = SEGMENT.color_wheel(popcorn[i].colIndex);
-          if (!SEGMENT.palette && popcorn[i].colIndex < NUM_COLORS) col = SEGCOLOR(popcorn[i].colIndex);
-          uint16_t ledIndex = popcorn[i].pos;
-          if (ledIndex < SEGLEN) SEGMENT.setPixelColor(indexToVStrip(ledIndex, stripNr), col);
+        // WLEDMM end
+
+        if (doPopCorn) { // POP!!!
+          uint16_t peakHeight = 128 + random8(128); //0-255
+          peakHeight = (peakHeight * (SEGLEN -1)) >> 8;
+          uint8_t colIndex;
+          if (SEGMENT.palette)
+          {
+            colIndex = random8();
+          } else {
+            byte col = random8(0, NUM_COLORS);
+            if (!SEGCOLOR(2) || !SEGCOLOR(col)) col = 0;
+            colIndex = col;
+          }
+          popcorn[i].state = PS_STATE_MOVING;
+          popcorn[i].x  = PS_ONE/100;
+          popcorn[i].vx = psFixed(sqrtf(-2.0f * gravity * peakHeight));
+          popcorn[i].colIndex = colIndex;
         }
       }
+      ps.render(SEGMENT, popcorn_color, stripNr, numPopcorn); // draw active popcorn (either active before or just popped)
     }
   };
 
   for (int stripNr=0; stripNr<strips; stripNr++)
-    virtualStrip::runStrip(stripNr, &popcorn[stripNr * neededPopcorn], useaudio, um_data); // WLEDMM added useaudio and um_data
+    virtualStrip::runStrip(stripNr, &popcorn[stripNr * neededPopcorn], neededPopcorn, maxPopcorn, useaudio, um_data); // WLEDMM added useaudio and um_data
 
   return FRAMETIME;
 }
@@ -3559,10 +3561,10 @@ uint16_t mode_exploding_fireworks(void)
   uint8_t segs = strip.getActiveSegmentsNum();
   if (segs <= (strip.getMaxSegments() /2)) maxData *= 2; //ESP8266: 512 if <= 8 segs ESP32: 1280 if <= 16 segs
   if (segs <= (strip.getMaxSegments() /4)) maxData *= 2; //ESP8266: 1024 if <= 4 segs ESP32: 2560 if <= 8 segs
-  int maxSparks = maxData / sizeof(spark); //ESP8266: max. 21/42/85 sparks/seg, ESP32: max. 53/106/213 sparks/seg
+  int maxSparks = maxData / sizeof(ps_particle_t); //ESP8266: max. 12/25/51 sparks/seg, ESP32: max. 32/64/128 sparks/seg
 
   uint16_t numSparks = min(2 + ((rows*cols) >> 1), maxSparks);
-  uint16_t dataSize = sizeof(spark) * numSparks;
+  uint16_t dataSize = sizeof(ps_particle_t) * numSparks;
   if (!SEGENV.allocateData(dataSize + sizeof(float))) return mode_static(); //allocation failed
   float *dying_gravity = reinterpret_cast<float*>(SEGENV.data + dataSize);
 
@@ -3574,35 +3576,38 @@ uint16_t mode_exploding_fireworks(void)
 
   SEGMENT.fade_out(252);
 
-  Spark* sparks = reinterpret_cast<Spark*>(SEGENV.data);
-  Spark* flare = sparks; //first spark is flare data
+  // WLEDMM shared particle engine: x is the height (rows), y the position across (cols, 2D only); aux is the firing side on 1D
+  ps_particle_t* sparks = reinterpret_cast<ps_particle_t*>(SEGENV.data);
+  ps_particle_t* flare = sparks; //first particle is the flare
 
   float gravity = -0.0004f - (SEGMENT.speed/800000.0f); // m/s/s
   gravity *= rows;
 
   if (SEGENV.aux0 < 2) { //FLARE
+    ParticleSystem launch(flare, 1, rows, cols);
+    launch.gravityX = psFixed(gravity);
+    launch.edge = PS_EDGE_CLAMP;
     if (SEGENV.aux0 == 0) { //init flare
-      flare->pos = 0;
-      flare->posX = strip.isMatrix ? random16(2,cols-3) : (SEGMENT.intensity > random8()); // will enable random firing side on 1D
       uint16_t peakHeight = 75 + random8(180); //0-255
       peakHeight = (peakHeight * (rows -1)) >> 8;
-      flare->vel = sqrtf(-2.0f * gravity * peakHeight);
-      flare->velX = strip.isMatrix ? (random8(9)-4)/32.f : 0; // no X velocity on 1D
-      flare->col = 255; //brightness
+      flare->x  = 0;
+      flare->y  = strip.isMatrix ? int32_t(random16(2,cols-3)) << PS_SHIFT : 0;
+      flare->vx = psFixed(sqrtf(-2.0f * gravity * peakHeight));
+      flare->vy = strip.isMatrix ? (random8(9)-4) * (PS_ONE/32) : 0; // no X velocity on 1D
+      flare->aux = strip.isMatrix ? 0 : (SEGMENT.intensity > random8()); // will enable random firing side on 1D
+      flare->bri = 255; //brightness
+      flare->state = PS_STATE_MOVING;
       SEGENV.aux0 = 1;
     }
 
     // launch
-    if (flare->vel > 12 * gravity) {
+    if (flare->vx > 12 * launch.gravityX) {
       // flare
-      if (strip.isMatrix) SEGMENT.setPixelColorXY(int(flare->posX), rows - uint16_t(flare->pos) - 1, flare->col, flare->col, flare->col);
-      else                SEGMENT.setPixelColor(int(flare->posX) ? rows - int(flare->pos) - 1 : int(flare->pos), flare->col, flare->col, flare->col);
-      flare->pos  += flare->vel;
-      flare->posX += flare->velX;
-      flare->pos  = constrain(flare->pos, 0, rows-1);
-      flare->posX = constrain(flare->posX, 0, cols-strip.isMatrix);
-      flare->vel  += gravity;
-      flare->col  -= 2;
+      int pos = flare->x >> PS_SHIFT;
+      if (strip.isMatrix) SEGMENT.setPixelColorXY(int(flare->y >> PS_SHIFT), rows - pos - 1, flare->bri, flare->bri, flare->bri);
+      else                SEGMENT.setPixelColor(flare->aux ? rows - pos - 1 : pos, flare->bri, flare->bri, flare->bri);
+      launch.update(); // stops at the segment edges
+      flare->bri -= 2;
     } else {
       SEGENV.aux0 = 2;  // ready to explode
     }
@@ -3613,53 +3618,54 @@ uint16_t mode_exploding_fireworks(void)
      * Explosion happens where the flare ended.
      * Size is proportional to the height.
      */
-    int nSparks = flare->pos + random8(4);
-    nSparks = constrain(nSparks, 4, numSparks);
+    ParticleSystem ps(sparks + 1, numSparks - 1, rows, cols);
 
     // initialize sparks
     if (SEGENV.aux0 == 2) {
+      const float flarePos = float(flare->x) / PS_ONE, flarePosX = float(flare->y) / PS_ONE;
+      int nSparks = flarePos + random8(4);
+      nSparks = constrain(nSparks, 4, numSparks);
+      for (int i = 1; i < numSparks; i++) sparks[i].state = PS_STATE_FREE;
       for (int i = 1; i < nSparks; i++) {
-        sparks[i].pos  = flare->pos;
-        sparks[i].posX = flare->posX;
-        sparks[i].vel  = (float(random16(20001)) / 10000.0f) - 0.9f; // from -0.9 to 1.1
-        sparks[i].vel *= rows<32 ? 0.5f : 1; // reduce velocity for smaller strips
-        sparks[i].velX = strip.isMatrix ? (float(random16(10001)) / 10000.0f) - 0.5f : 0; // from -0.5 to 0.5
-        sparks[i].col  = 345;//abs(sparks[i].vel * 750.0); // set colors before scaling velocity to keep them bright
-        //sparks[i].col = constrain(sparks[i].col, 0, 345);
-        sparks[i].colIndex = random8();
-        sparks[i].vel  *= flare->pos/rows; // proportional to height
-        sparks[i].velX *= strip.isMatrix ? flare->posX/cols : 0; // proportional to width
-        sparks[i].vel  *= -gravity *50;
+        float vel  = (float(random16(20001)) / 10000.0f) - 0.9f; // from -0.9 to 1.1
+        vel *= rows<32 ? 0.5f : 1; // reduce velocity for smaller strips
+        float velX = strip.isMatrix ? (float(random16(10001)) / 10000.0f) - 0.5f : 0; // from -0.5 to 0.5
+        vel  *= flarePos/rows; // proportional to height
+        velX *= strip.isMatrix ? flarePosX/cols : 0; // proportional to width
+        vel  *= -gravity *50;
+        ps_particle_t *spark = ps.emit(flare->x, flare->y, psFixed(vel), psFixed(velX), random8());
+        if (spark) spark->aux = flare->aux;
       }
-      //sparks[1].col = 345; // this will be our known spark
+      SEGENV.step = 345; // glow of all sparks, fades from white over the spark color to black
       *dying_gravity = gravity/2;
       SEGENV.aux0 = 3;
     }
 
-    if (sparks[1].col > 4) {//&& sparks[1].pos > 0) { // as long as our known spark is lit, work with all the sparks
-      for (int i = 1; i < nSparks; i++) {
-        sparks[i].pos  += sparks[i].vel;
-        sparks[i].posX += sparks[i].velX;
-        sparks[i].vel  += *dying_gravity;
-        sparks[i].velX += strip.isMatrix ? *dying_gravity : 0;
-        if (sparks[i].col > 3) sparks[i].col -= 4;
-
-        if (sparks[i].pos > 0 && sparks[i].pos < rows) {
-          if (strip.isMatrix && !(sparks[i].posX >= 0 && sparks[i].posX < cols)) continue;
-          uint16_t prog = sparks[i].col;
-          uint32_t spColor = (SEGMENT.palette) ? SEGMENT.color_wheel(sparks[i].colIndex) : SEGCOLOR(0);
-          CRGB c = CRGB::Black; //HeatColor(sparks[i].col);
-          if (prog > 300) { //fade from white to spark color
-            c = CRGB(color_blend(spColor, WHITE, (prog - 300)*5));
-          } else if (prog > 45) { //fade from spark color to black
-            c = CRGB(color_blend(BLACK, spColor, prog - 45));
-            uint8_t cooling = (300 - prog) >> 5;
-            c.g = qsub8(c.g, cooling);
-            c.b = qsub8(c.b, cooling * 2);
-          }
-          if (strip.isMatrix) SEGMENT.setPixelColorXY(int(sparks[i].posX), rows - int(sparks[i].pos) - 1, c.red, c.green, c.blue);
-          else                SEGMENT.setPixelColor(int(sparks[i].posX) ? rows - int(sparks[i].pos) - 1 : int(sparks[i].pos), c.red, c.green, c.blue);
+    if (SEGENV.step > 4) { // as long as the sparks are lit, work with all the sparks
+      ps.gravityX = psFixed(*dying_gravity);
+      ps.gravityY = strip.isMatrix ? ps.gravityX : 0;
+      ps.edge = PS_EDGE_NONE; // not drawn outside, but keep moving
+      ps.update();
+      SEGENV.step -= 4;
+      uint16_t prog = SEGENV.step;
+
+      for (int i = 1; i < numSparks; i++) {
+        const ps_particle_t &spark = sparks[i];
+        if (spark.state == PS_STATE_FREE || spark.x <= 0 || spark.x >= ps.maxX) continue;
+        if (strip.isMatrix && !(spark.y >= 0 && spark.y < ps.maxY)) continue;
+        uint32_t spColor = (SEGMENT.palette) ? SEGMENT.color_wheel(spark.colIndex) : SEGCOLOR(0);
+        CRGB c = CRGB::Black; //HeatColor(prog);
+        if (prog > 300) { //fade from white to spark color
+          c = CRGB(color_blend(spColor, WHITE, (prog - 300)*5));
+        } else if (prog > 45) { //fade from spark color to black
+          c = CRGB(color_blend(BLACK, spColor, prog - 45));
+          uint8_t cooling = (300 - prog) >> 5;
+          c.g = qsub8(c.g, cooling);
+          c.b = qsub8(c.b, cooling * 2);
         }
+        int pos = spark.x >> PS_SHIFT;
+        if (strip.isMatrix) SEGMENT.setPixelColorXY(int(spark.y >> PS_SHIFT), rows - pos - 1, c.red, c.green, c.blue);
+        else                SEGMENT.setPixelColor(spark.aux ? rows - pos - 1 : pos, c.red, c.green, c.blue);
       }
       SEGMENT.blur(16);
       *dying_gravity *= .8f; // as sparks burn out they fall slower
@@ -3689,14 +3695,16 @@ uint16_t mode_drip(void)
   //allocate segment data
   uint16_t strips = SEGMENT.nrOfVStrips();
   const int maxNumDrops = 4;
-  uint16_t dataSize = sizeof(spark) * maxNumDrops;
-  if (!SEGENV.allocateData(dataSize * strips)) return mode_static(); //allocation failed
-  Spark* drops = reinterpret_cast<Spark*>(SEGENV.data);
+  ps_particle_t* drops = ParticleSystem::allocate(SEGMENT, maxNumDrops, strips); // WLEDMM shared particle engine
+  if (!drops) return mode_static(); //allocation failed
 
   if (!SEGMENT.check2) SEGMENT.fill(SEGCOLOR(1));
 
+  // drop state: PS_STATE_FREE (init), PS_STATE_RESTING (forming), DRIP_FALLING, DRIP_BOUNCING
+  constexpr uint8_t DRIP_FALLING  = 2;
+  constexpr uint8_t DRIP_BOUNCING = 5;
   struct virtualStrip {
-    static void runStrip(uint16_t stripNr, Spark* drops) {
+    static void runStrip(uint16_t stripNr, ps_particle_t* drops) {
 
       uint8_t numDrops = 1 + (SEGMENT.intensity >> 6); // 255>>6 = 3
 
@@ -3704,55 +3712,52 @@ uint16_t mode_drip(void)
       gravity *= max(1, SEGLEN-1);
       int sourcedrop = 12;
 
+      ParticleSystem ps(drops, maxNumDrops, SEGLEN);
+      ps.gravityX = min(psFixed(gravity), int32_t(-1));
+      ps.edge = PS_EDGE_CLAMP; // drops stop at the bottom, bouncing is handled below
+      ps.update(numDrops);     // falling and bouncing drops; forming ones are resting
+
       for (int j=0;j<numDrops;j++) {
-        if (drops[j].colIndex == 0) { //init
-          drops[j].pos = SEGLEN-1;    // start at end
-          drops[j].vel = 0;           // speed
-          drops[j].col = sourcedrop;  // brightness
-          drops[j].colIndex = 1;      // drop state (0 init, 1 forming, 2 falling, 5 bouncing)
-          drops[j].velX = SEGMENT.color_from_palette(random8(), false, PALETTE_SOLID_WRAP, 0); // random color
+        ps_particle_t &drop = drops[j];
+        if (drop.state == PS_STATE_FREE) { //init
+          drop.x = int32_t(SEGLEN-1) << PS_SHIFT; // start at end
+          drop.vx = 0;                  // speed
+          drop.bri = sourcedrop;        // brightness
+          drop.state = PS_STATE_RESTING; // forming
+          drop.colIndex = random8();    // random color
         }
-        uint32_t dropColor = drops[j].velX;
+        uint32_t dropColor = SEGMENT.color_from_palette(drop.colIndex, false, PALETTE_SOLID_WRAP, 0);
+        uint16_t dropPos = drop.x >> PS_SHIFT;
 
         SEGMENT.setPixelColor(indexToVStrip(SEGLEN-1, stripNr), color_blend(BLACK,dropColor, sourcedrop));// water source
-        if (drops[j].colIndex==1) {
-          if (drops[j].col>255) drops[j].col=255;
-          SEGMENT.setPixelColor(indexToVStrip(uint16_t(drops[j].pos), stripNr), color_blend(BLACK,dropColor,drops[j].col));
+        if (drop.state == PS_STATE_RESTING) {
+          SEGMENT.setPixelColor(indexToVStrip(dropPos, stripNr), color_blend(BLACK,dropColor,drop.bri));
 
-          drops[j].col += map(SEGMENT.custom1, 0, 255, 1, 6); // swelling
+          drop.bri = qadd8(drop.bri, map(SEGMENT.custom1, 0, 255, 1, 6)); // swelling
 
-          if (random16() <= drops[j].col * SEGMENT.custom1 * SEGMENT.custom1 / 10 / 128) {               // random drop
-            drops[j].colIndex=2;               //fall
-            drops[j].col=255;
+          if (random16() <= drop.bri * SEGMENT.custom1 * SEGMENT.custom1 / 10 / 128) {               // random drop
+            drop.state = DRIP_FALLING; //fall
+            drop.bri = 255;
           }
         }
-        if (drops[j].colIndex > 1) {           // falling
-          if (drops[j].pos > 0) {              // fall until end of segment
-            drops[j].pos += drops[j].vel;
-            if (drops[j].pos < 0) drops[j].pos = 0;
-            drops[j].vel += gravity;           // gravity is negative
-
-            for (int i=1;i<7-drops[j].colIndex;i++) { // some minor math so we don't expand bouncing droplets
-              uint16_t pos = constrain(uint16_t(drops[j].pos) +i, 0, SEGLEN-1); //this is BAD, returns a pos >= SEGLEN occasionally
-              SEGMENT.setPixelColor(indexToVStrip(pos, stripNr), color_blend(BLACK,dropColor,drops[j].col/i)); //spread pixel with fade while falling
+        if (drop.state >= DRIP_FALLING) {      // falling
+          if (drop.x > 0) {                    // fall until end of segment
+            for (int i=1;i<7-drop.state;i++) { // some minor math so we don't expand bouncing droplets
+              uint16_t pos = min(dropPos + i, SEGLEN-1);
+              SEGMENT.setPixelColor(indexToVStrip(pos, stripNr), color_blend(BLACK,dropColor,drop.bri/i)); //spread pixel with fade while falling
             }
 
-            if (drops[j].colIndex > 2) {       // during bounce, some water is on the floor
-              SEGMENT.setPixelColor(indexToVStrip(0, stripNr), color_blend(dropColor,BLACK,drops[j].col));
+            if (drop.state > DRIP_FALLING) {   // during bounce, some water is on the floor
+              SEGMENT.setPixelColor(indexToVStrip(0, stripNr), color_blend(dropColor,BLACK,drop.bri));
             }
           } else {                             // we hit bottom
-            if (drops[j].colIndex > 2) {       // already hit once, so back to forming
-              drops[j].colIndex = 0;
-              // drops[j].col = sourcedrop;
-
-            } else {
-
-              if (drops[j].colIndex==2) {      // init bounce
-                drops[j].vel = -drops[j].vel/4;// reverse velocity with damping
-                drops[j].pos += drops[j].vel;
-              }
-              drops[j].col = sourcedrop*2;
-              drops[j].colIndex = 5;           // bouncing
+            if (drop.state > DRIP_FALLING) {   // already hit once, so back to forming
+              drop.state = PS_STATE_FREE;
+            } else {                           // init bounce
+              drop.vx = -drop.vx/4;            // reverse velocity with damping
+              drop.x += drop.vx;
+              drop.bri = sourcedrop*2;
+              drop.state = DRIP_BOUNCING;      // bouncing
             }
           }
         }
@@ -5068,8 +5073,8 @@ uint16_t mode_2DDrift() {              // By: Stepko   https://editor.soulmateli
   unsigned long t_20 = t/20; // softhack007: pre-calculating this gives about 10% speedup
   for (float i = 1; i < maxDim; i += 0.25) {
     float angle = radians(t * (maxDim - i));
-    uint16_t myX = (cols>>1) + (uint16_t)(sinf(angle) * i) + (cols%2);
-    uint16_t myY = (rows>>1) + (uint16_t)(cosf(angle) * i) + (rows%2);
+    uint16_t myX = (cols>>1) + (uint16_t)(sin_t(angle) * i) + (cols%2); // WLEDMM fast math
+    uint16_t myY = (rows>>1) + (uint16_t)(cos_t(angle) * i) + (rows%2);
     SEGMENT.setPixelColorXY(myX, myY, ColorFromPalette(SEGPALETTE, (i * 20) + t_20, 255, LINEARBLEND));
   }
   SEGMENT.blur(SEGMENT.intensity>>3);
@@ -5337,7 +5342,7 @@ uint16_t mode_2DJulia(void) {                           // An animated Julia set
   int maxIterations = 15;         // How many iterations per pixel before we give up. Make it 8 bits to match our range of colours.
   float maxCalc = 16.0;           // How big is each calculation allowed to be before we give up.
 
-  maxIterations = SEGMENT.intensity/2;
+  maxIterations = SEGMENT.qualityScaled(SEGMENT.intensity/2, min(SEGMENT.intensity/2, 8)); // WLEDMM fewer iterations when over frame budget
 
 
   // Resize section on the fly for some animaton.
@@ -5627,7 +5632,7 @@ uint16_t mode_2DPlasmaball(void) {                   // By: Stepko https://edito
                                     (rows - 1 - cy == 0)) ? ColorFromPalette(SEGPALETTE, beat8(5), thisVal, LINEARBLEND) : CRGB::Black);
     }
   }
-  SEGMENT.blur(SEGMENT.custom2>>5, (SEGMENT.custom2 > 132));  // WLEDMM
+  if (!SEGMENT.qualityReduced(2)) SEGMENT.blur(SEGMENT.custom2>>5, (SEGMENT.custom2 > 132));  // WLEDMM skip blur when over frame budget
 
   return FRAMETIME;
 } // mode_2DPlasmaball()
@@ -6080,8 +6085,8 @@ uint16_t mode_2Dghostrider(void) {
     CRGB color = CRGB::White;
     SEGMENT.wu_pixel(lighter->gPosX * 256 / 10, lighter->gPosY * 256 / 10, color);
 
-    lighter->gPosX += lighter->Vspeed * sinf(radians(lighter->gAngle));
-    lighter->gPosY += lighter->Vspeed * cosf(radians(lighter->gAngle));
+    lighter->gPosX += lighter->Vspeed * sin_t(radians(lighter->gAngle)); // WLEDMM fast math
+    lighter->gPosY += lighter->Vspeed * cos_t(radians(lighter->gAngle));
     lighter->gAngle += lighter->angleSpeed;
     if (lighter->gPosX < 0)               lighter->gPosX = (cols - 1) * 10;
     if (lighter->gPosX > (cols - 1) * 10) lighter->gPosX = 0;
@@ -6103,8 +6108,8 @@ uint16_t mode_2Dghostrider(void) {
         lighter->time[i] = 0;
         lighter->reg[i] = false;
       } else {
-        lighter->lightersPosX[i] += -7 * sinf(radians(lighter->Angle[i]));
-        lighter->lightersPosY[i] += -7 * cosf(radians(lighter->Angle[i]));
+        lighter->lightersPosX[i] += -7 * sin_t(radians(lighter->Angle[i]));
+        lighter->lightersPosY[i] += -7 * cos_t(radians(lighter->Angle[i]));
       }
       SEGMENT.wu_pixel(lighter->lightersPosX[i] * 256 / 10, lighter->lightersPosY[i] * 256 / 10, ColorFromPalette(SEGPALETTE, (256 - lighter->time[i])));
     }
@@ -6316,8 +6321,9 @@ uint16_t mode_2Ddriftrose(void) {
 
   SEGMENT.fadeToBlackBy(32+(SEGMENT.speed>>3));
   for (size_t i = 1; i < 37; i++) {
-    uint32_t x = (CX + (sinf(radians(i * 10)) * (beatsin8(i, 0, L*2)-L))) * 255.f;
-    uint32_t y = (CY + (cosf(radians(i * 10)) * (beatsin8(i, 0, L*2)-L))) * 255.f;
+    uint16_t angle = i * 10 * 65536U / 360U; // WLEDMM fast math
+    uint32_t x = (CX + (sin16_t(angle) / 32767.f * (beatsin8(i, 0, L*2)-L))) * 255.f;
+    uint32_t y = (CY + (cos16_t(angle) / 32767.f * (beatsin8(i, 0, L*2)-L))) * 255.f;
     SEGMENT.wu_pixel(x, y, CHSV(i * 10, 255, 255));
   }
   SEGMENT.blur((SEGMENT.intensity>>4)+1);
@@ -8161,25 +8167,19 @@ uint16_t mode_2Doctopus() {
   const uint16_t rows = SEGMENT.virtualHeight();
   const uint8_t mapp = 180 / MAX(cols,rows);
 
-  typedef struct {
-    uint8_t angle;
-    uint8_t radius;
-  } map_t;
-
-  const size_t dataSize = SEGMENT.width() * SEGMENT.height() * sizeof(map_t); // prevent reallocation if mirrored or grouped
-  if (!SEGENV.allocateData(dataSize + 2)) return mode_static(); //allocation failed
-
-  map_t *rMap = reinterpret_cast<map_t*>(SEGENV.data);
-  uint8_t *offsX = reinterpret_cast<uint8_t*>(SEGENV.data + dataSize);
-  uint8_t *offsY = reinterpret_cast<uint8_t*>(SEGENV.data + dataSize + 1);
+  // WLEDMM polar map shared with other effects (see WS2812FX::getPolarMap()), centre moved by custom1/custom2
+  const int C_X = cols / 2 + (SEGMENT.custom1 - 128)*cols/255;
+  const int C_Y = rows / 2 + (SEGMENT.custom2 - 128)*rows/255;
+  const polar_t *pMap = strip.getPolarMap(cols, rows, C_X, C_Y, &SEGMENT); // own map in SEGENV.data if the shared ones are busy
+  if (!pMap) return mode_static(); //allocation failed
 
   //WLEDMM add SuperSync control
   uint16_t xStart, xEnd, yStart, yEnd;
   if (SEGMENT.check1) { //Master (sync on needs to show the whole effect, children only their first panel)
     xStart = strip.panel[0].xOffset;
-    xEnd = strip.panel[0].xOffset + strip.panel[0].width;
+    xEnd = min(uint16_t(strip.panel[0].xOffset + strip.panel[0].width), cols);
     yStart = strip.panel[0].yOffset;
-    yEnd = strip.panel[0].yOffset + strip.panel[0].height;
+    yEnd = min(uint16_t(strip.panel[0].yOffset + strip.panel[0].height), rows);
   }
   else  {
     xStart = 0;
@@ -8188,33 +8188,16 @@ uint16_t mode_2Doctopus() {
     yEnd = rows;
   }
 
-  // re-init if SEGMENT dimensions or offset changed
-  if (SEGENV.call == 0 || SEGENV.aux0 != cols || SEGENV.aux1 != rows || SEGMENT.custom1 != *offsX || SEGMENT.custom2 != *offsY) {
-    if (!true) //WLEDMM SuperSync
-      SEGENV.step = 0; // t
-    SEGENV.aux0 = cols;
-    SEGENV.aux1 = rows;
-    *offsX = SEGMENT.custom1;
-    *offsY = SEGMENT.custom2;
-    const uint8_t C_X = cols / 2 + (SEGMENT.custom1 - 128)*cols/255;
-    const uint8_t C_Y = rows / 2 + (SEGMENT.custom2 - 128)*rows/255;
-    for (int x = xStart; x < xEnd; x++) {
-      for (int y = yStart; y < yEnd; y++) {
-        rMap[XY(x, y)].angle = 40.7436f * atan2f(y - C_Y, x - C_X); // avoid 128*atan2()/PI
-        rMap[XY(x, y)].radius = hypotf(x - C_X, y - C_Y) * mapp; //thanks Sutaburosu
-      }
-    }
-  }
-
   if (true) // WLEDMM SuperSync
     SEGENV.step = strip.now * (SEGMENT.speed / 32 + 1) / 25;  // WLEDMM 40fps
   else
     SEGENV.step += SEGMENT.speed / 32 + 1;  // 1-4 range
 
-  for (int x = xStart; x < xEnd; x++) {
-    for (int y = yStart; y < yEnd; y++) {
-      byte angle = rMap[XY(x,y)].angle;
-      byte radius = rMap[XY(x,y)].radius;
+  for (int y = yStart; y < yEnd; y++) {     // WLEDMM row by row, follows map layout
+    for (int x = xStart; x < xEnd; x++) {
+      const polar_t &pc = pMap[x + y * cols];
+      byte angle = pc.angle;                                       // 256 = full turn
+      byte radius = polarRadius(pc, MAX(cols,rows), mapp);         // byte wraps, like the original map
       //CRGB c = CHSV(SEGENV.step / 2 - radius, 255, sin8(sin8((angle * 4 - radius) / 4 + SEGENV.step) + radius - SEGENV.step * 2 + angle * (SEGMENT.custom3/3+1)));
       uint16_t intensity = sin8(sin8((angle * 4 - radius) / 4 + SEGENV.step/2) + radius - SEGENV.step + angle * (SEGMENT.custom3/4+1));
       intensity = map(intensity*intensity, 0, 65535, 0, 255); // add a bit of non-linearity for cleaner display
@@ -8248,6 +8231,26 @@ uint16_t mode_2Dwavingcell() {
 static const char _data_FX_MODE_2DWAVINGCELL[] PROGMEM = "Waving Cell@!,,Amplitude 1,Amplitude 2,Amplitude 3;;!;2";
 
 
+/////////////////////////
+//     2D Image        //
+/////////////////////////
+// WLEDMM plays an animated GIF from LittleFS or SD card; file name is the segment name (default "/image.gif"), see image_loader.cpp
+// check1: the GIF is a sprite sheet (square frames stacked in one image)
+uint16_t mode_2DImage(void) {
+  if (!strip.isMatrix || !SEGMENT.is2D()) return mode_static(); // not a 2D set-up
+  if (SEGENV.call == 0) SEGENV.setUpLeds();   // WLEDMM lossless getPixelColor() for the frame cache
+
+  if (!renderImageToSegment(SEGMENT)) {
+    if (SEGENV.aux0 == 0) SEGMENT.fill(BLACK); // no (valid) image: show nothing
+    SEGENV.aux0 = 1;
+    return FRAMETIME_FIXED;
+  }
+  SEGENV.aux0 = 0;
+  return FRAMETIME;
+}
+static const char _data_FX_MODE_2DIMAGE[] PROGMEM = "Image@!,,,,,,Sprite sheet;;;2;sx=128";
+
+
 #endif // WLED_DISABLE_2D
 
 
@@ -8255,6 +8258,57 @@ static const char _data_FX_MODE_2DWAVINGCELL[] PROGMEM = "Waving Cell@!,,Amplitu
 // mode data
 static const char _data_RESERVED[] PROGMEM = "RSVD";
 
+// WLEDMM keys of the mode defaults section, index = bit in mode_meta_t::defaultsMask
+static const char _modeDefaultKeys[][4] PROGMEM = {"sx","ix","c1","c2","c3","o1","o2","o3","m12","si","rev","mi","rY","mY","pal"};
+
+int8_t WS2812FX::modeDefaultKeyIndex(const char *key) {
+  for (size_t k = 0; k < sizeof(_modeDefaultKeys)/sizeof(_modeDefaultKeys[0]); k++) if (strcmp_P(key, _modeDefaultKeys[k]) == 0) return k;
+  return -1;
+}
+
+// WLEDMM parse mode data string once ("Name@sliders;colors;palette;flags;defaults"), so later lookups need not scan it again
+mode_meta_t WS2812FX::parseModeMeta(const char *modeData) {
+  mode_meta_t meta = {0, MODE_META_1D, 0, 0};
+  if (modeData == nullptr) return meta;
+  char lineBuffer[256] = { '\0' };
+  strncpy_P(lineBuffer, modeData, sizeof(lineBuffer)/sizeof(char)-1);
+  lineBuffer[sizeof(lineBuffer)/sizeof(char)-1] = '\0'; // terminate string
+
+  char *at = strchr(lineBuffer, '@');
+  meta.nameLen = min(at ? size_t(at - lineBuffer) : strlen(lineBuffer), size_t(UINT8_MAX));
+  if (!at) return meta; // name only: 1D effect without controls
+  meta.flags |= MODE_META_SLIDERS;
+
+  // same rule as the old extractModeDefaults(): defaults follow the last ';' in the data string
+  const char *last = strrchr(at+1, ';');
+  if (last) {
+    for (size_t k = 0; k < sizeof(_modeDefaultKeys)/sizeof(_modeDefaultKeys[0]); k++) {
+      char key[4];
+      strcpy_P(key, _modeDefaultKeys[k]);
+      if (strstr(last, key)) meta.defaultsMask |= (1 << k);
+    }
+    if (meta.defaultsMask) meta.defaultsOfs = (last+1) - lineBuffer;
+  }
+
+  // split into sections: 0=sliders, 1=colors, 2=palette, 3=flags, 4=defaults
+  const char *section[5] = { at+1, nullptr, nullptr, nullptr, nullptr };
+  size_t n = 1;
+  for (char *c = at+1; *c && n < 5; c++) if (*c == ';') { *c = '\0'; section[n++] = c+1; }
+
+  if (section[2] && section[2][0]) meta.flags |= MODE_META_PALETTE;
+  if (section[3] && section[3][0]) {
+    meta.flags &= ~MODE_META_1D; // explicit flags replace the implicit "1D"
+    for (const char *f = section[3]; *f; f++) switch (*f) {
+      case '0': meta.flags |= MODE_META_0D;     break;
+      case '1': meta.flags |= MODE_META_1D;     break;
+      case '2': meta.flags |= MODE_META_2D;     break;
+      case 'v': meta.flags |= MODE_META_VOLUME; break;
+      case 'f': meta.flags |= MODE_META_FREQ;   break;
+    }
+  }
+  return meta;
+}
+
 // add (or replace reserved) effect mode and data into vector
 // use id==255 to find unallocated gaps (with "Reserved" data string)
 // if vector size() is smaller than id (single) data is appended at the end (regardless of id)
@@ -8265,10 +8319,34 @@ void WS2812FX::addEffect(uint8_t id, mode_ptr mode_fn, const char *mode_name) {
   if (id < _mode.size()) {
     if (_modeData[id] != _data_RESERVED) return; // do not overwrite alerady added effect
     _mode[id]     = mode_fn;
+    _modeCtx[id]  = nullptr;
     _modeData[id] = mode_name;
+    _modeMeta[id] = parseModeMeta(mode_name);
   } else {
     _mode.push_back(mode_fn);
+    _modeCtx.push_back(nullptr);
+    _modeData.push_back(mode_name);
+    _modeMeta.push_back(parseModeMeta(mode_name));
+    if (_modeCount < _mode.size()) _modeCount++;
+  }
+}
+
+// WLEDMM effects using the explicit RenderContext signature. The legacy slot gets mode_static as a harmless placeholder.
+void WS2812FX::addEffect(uint8_t id, mode_ctx_ptr mode_fn, const char *mode_name) {
+  if (id == 255) { // find empty slot
+    for (size_t i=1; i<_mode.size(); i++) if (_modeData[i] == _data_RESERVED) { id = i; break; }
+  }
+  if (id < _mode.size()) {
+    if (_modeData[id] != _data_RESERVED) return; // do not overwrite alerady added effect
+    _mode[id]     = &mode_static;
+    _modeCtx[id]  = mode_fn;
+    _modeData[id] = mode_name;
+    _modeMeta[id] = parseModeMeta(mode_name);
+  } else {
+    _mode.push_back(&mode_static);
+    _modeCtx.push_back(mode_fn);
     _modeData.push_back(mode_name);
+    _modeMeta.push_back(parseModeMeta(mode_name));
     if (_modeCount < _mode.size()) _modeCount++;
   }
 }
@@ -8276,11 +8354,15 @@ void WS2812FX::addEffect(uint8_t id, mode_ptr mode_fn, const char *mode_name) {
 void WS2812FX::setupEffectData() {
   // Solid must be first! (assuming vector is empty upon call to setup)
   _mode.push_back(&mode_static);
+  _modeCtx.push_back(nullptr);
   _modeData.push_back(_data_FX_MODE_STATIC);
+  _modeMeta.push_back(parseModeMeta(_data_FX_MODE_STATIC));
   // fill reserved word in case there will be any gaps in the array
   for (size_t i=1; i<_modeCount; i++) {
     _mode.push_back(&mode_static);
+    _modeCtx.push_back(nullptr);
     _modeData.push_back(_data_RESERVED);
+    _modeMeta.push_back(parseModeMeta(_data_RESERVED));
   }
   // now replace all pre-allocated effects
   // --- 1D non-audio effects ---
@@ -8491,6 +8573,7 @@ void WS2812FX::setupEffectData() {
   addEffect(FX_MODE_2DSOAP, &mode_2Dsoap, _data_FX_MODE_2DSOAP);
   addEffect(FX_MODE_2DOCTOPUS, &mode_2Doctopus, _data_FX_MODE_2DOCTOPUS);
   addEffect(FX_MODE_2DWAVINGCELL, &mode_2Dwavingcell, _data_FX_MODE_2DWAVINGCELL);
+  addEffect(FX_MODE_2DIMAGE, &mode_2DImage, _data_FX_MODE_2DIMAGE);
 
   addEffect(FX_MODE_2DAKEMI, &mode_2DAkemi, _data_FX_MODE_2DAKEMI); // audio
 #endif // WLED_DISABLE_2D
@@ -30,6 +30,8 @@
 #include <vector>
 
 #include "const.h"
+#include "polar_map.h"     // WLEDMM
+#include "particle_physics.h" // WLEDMM
 
 bool canUseSerial(void);                        // WLEDMM implemented in wled_serial.cpp
 void strip_wait_until_idle(String whoCalledMe); // WLEDMM implemented in FX_fcn.cpp
@@ -98,6 +100,11 @@ bool strip_uses_global_leds(void);              // WLEDMM implemented in FX_fcn.
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
 
+// WLEDMM adaptive quality governor on by default, build with -D WLEDMM_QUALITY_GOVERNOR=false to start with it disabled (cfg "aq")
+#ifndef WLEDMM_QUALITY_GOVERNOR
+  #define WLEDMM_QUALITY_GOVERNOR true
+#endif
+
 #define MIN_SHOW_DELAY   (_frametime < 16 ? (_frametime <8? (_frametime <7? (_frametime <6 ? 2 :3) :4) : 8) : 15)    // WLEDMM support higher framerates (up to 250fps)
 
 #define NUM_COLORS       3 /* number of colors per segment */
@@ -345,7 +352,9 @@ bool strip_uses_global_leds(void);              // WLEDMM implemented in FX_fcn.
 // #define FX_MODE_PALETTE_AR             193 // WLED-SR audioreactive palette
 #define FX_MODE_FIREWORKS_AR           194 // WLED-SR audioreactive fireworks
 
-#define MODE_COUNT                     195
+#define FX_MODE_2DIMAGE                195 // WLEDMM GIF playback from filesystem
+
+#define MODE_COUNT                     196
 
 typedef enum mapping1D2D {
   M12_Pixels = 0,
@@ -361,8 +370,8 @@ typedef enum mapping1D2D {
 // segment, 72 bytes
 typedef struct Segment {
   public:
-    uint16_t start; // start index / start X coordinate 2D (left)
-    uint16_t stop;  // stop index / stop X coordinate 2D (right); segment is invalid if stop == 0
+    pixidx_t start; // start index / start X coordinate 2D (left)
+    pixidx_t stop;  // stop index / stop X coordinate 2D (right); segment is invalid if stop == 0
     uint16_t offset;
     uint8_t  speed;
     uint8_t  intensity;
@@ -388,6 +397,7 @@ typedef struct Segment {
     };
     uint8_t  grouping, spacing;
     uint8_t  opacity;
+    uint8_t  renderScale;         // WLEDMM 2D render resolution: 0 = full, 1 = 1/2, 2 = 1/4 per axis (see upscaleRender())
     uint32_t colors[NUM_COLORS];
     uint8_t  cct;                 //0==1900K, 255==10091K
     uint8_t  custom1, custom2;    // custom FX parameters/sliders
@@ -397,8 +407,8 @@ typedef struct Segment {
       bool    check2  : 1;        // checkmark 2
       bool    check3  : 1;        // checkmark 3
     };
-    uint8_t startY;  // start Y coodrinate 2D (top); there should be no more than 255 rows
-    uint8_t stopY;   // stop Y coordinate 2D (bottom); there should be no more than 255 rows
+    rowidx_t startY; // start Y coodrinate 2D (top); no more than 255 rows unless WLED_LARGE_INSTALLATION
+    rowidx_t stopY;  // stop Y coordinate 2D (bottom); no more than 255 rows unless WLED_LARGE_INSTALLATION
     char *name = nullptr; // WLEDMM initialize to nullptr
 
     // runtime data
@@ -411,7 +421,8 @@ typedef struct Segment {
     CRGB* ledsrgb = nullptr;     // local leds[] array (may be a pointer to global) //WLEDMM rename to ledsrgb to search on them (temp?), and initialize to nullptr
     size_t ledsrgbSize; //WLEDMM 
     static CRGB *_globalLeds;             // global leds[] array
-    static uint16_t maxWidth, maxHeight;  // these define matrix width & height (max. segment dimensions)
+    static pixidx_t maxWidth;             // matrix width (max. segment dimension), equals strip length for 1D
+    static uint16_t maxHeight;            // matrix height (max. segment dimension)
     void *jMap = nullptr; //WLEDMM jMap
 
   private:
@@ -428,6 +439,29 @@ typedef struct Segment {
     size_t _dataLen;                   // WLEDMM uint16_t is too small
     static size_t _usedSegmentData;    // WLEDMM uint16_t is too small
 
+    // WLEDMM cached segment geometry - derived from bounds, grouping/spacing, mirror/transpose and map1D2D.
+    // updated by refreshGeometry(); kept together so setPixelColor() and service() touch only a few cache lines
+    pixidx_t _vWidth;                  // virtualWidth() (length of 1D segments, may exceed 16 bit)
+    uint16_t _vHeight;                 // virtualHeight()
+    pixidx_t _vLength;                 // virtualLength() (except jMap, which is dynamic)
+    uint16_t _groupLen;                // groupLength()
+    uint16_t _blockLen;                // blockSize()
+
+    // WLEDMM adaptive quality, maintained by WS2812FX::governQuality()
+    uint16_t _renderCost;              // smoothed effect render time (us)
+    uint16_t _levelCost[3];            // render time measured at each level before the governor lowered it (recovery hysteresis)
+    uint8_t  _quality;                 // qualityLevel()
+    uint8_t  _autoScale;               // render scale forced by the governor (2D only)
+    mutable bool _qualityAware;        // current effect reads the quality level, so the governor may lower it
+    bool     _is2Dseg;                 // is2D()
+
+    // WLEDMM pixel writers, selected by refreshGeometry() for the current option combination (see FX_fcn.cpp / FX_2Dfcn.cpp)
+    typedef void (*pixel_writer_t)(const Segment &seg, int i, uint32_t col);
+    typedef void (*pixel_writer_xy_t)(const Segment &seg, int x, int y, uint32_t col);
+    pixel_writer_t    _write1D;        // physical write for 1D segments (after opacity)
+    pixel_writer_xy_t _writeXY;        // physical write for 2D segments (after opacity)
+    void selectWriterXY(void);         // defined in FX_2Dfcn.cpp
+
     // transition data, valid only if transitional==true, holds values during transition
     struct Transition {
       uint32_t      _colorT[NUM_COLORS];
@@ -465,7 +499,7 @@ typedef struct Segment {
 
   public:
 
-    Segment(uint16_t sStart=0, uint16_t sStop=30) :
+    Segment(pixidx_t sStart=0, pixidx_t sStop=30) :
       start(sStart),
       stop(sStop),
       offset(0),
@@ -477,6 +511,7 @@ typedef struct Segment {
       grouping(1),
       spacing(0),
       opacity(255),
+      renderScale(0),
       colors{DEFAULT_COLOR,BLACK,BLACK},
       cct(127),
       custom1(DEFAULT_C1),
@@ -501,11 +536,14 @@ typedef struct Segment {
       _t(nullptr)
     {
       //refreshLightCapabilities();
+      _renderCost = 0; _quality = 0; _autoScale = 0; _qualityAware = false; memset(_levelCost, 0, sizeof(_levelCost)); // WLEDMM
+      refreshGeometry();
     }
 
-    Segment(uint16_t sStartX, uint16_t sStopX, uint16_t sStartY, uint16_t sStopY) : Segment(sStartX, sStopX) {
+    Segment(pixidx_t sStartX, pixidx_t sStopX, uint16_t sStartY, uint16_t sStopY) : Segment(sStartX, sStopX) {
       startY = sStartY;
       stopY  = sStopY;
+      refreshGeometry();
     }
 
     Segment(const Segment &orig); // copy constructor
@@ -547,14 +585,27 @@ typedef struct Segment {
     inline bool     getOption(uint8_t n) const { return ((options >> n) & 0x01); }
     inline bool     isSelected(void)     const { return selected; }
     inline bool     isActive(void)       const { return stop > start; }
-    inline bool     is2D(void)           const { return (width()>1 && height()>1); }
+    inline bool     is2D(void)           const { return _is2Dseg; }  // WLEDMM cached, see refreshGeometry()
     inline bool     hasRGB(void)         const { return _isRGB; }
     inline bool     hasWhite(void)       const { return _hasW; }
     inline bool     isCCT(void)          const { return _isCCT; }
-    inline uint16_t width(void)          const { return isActive() ? (stop - start) : 0; }         // segment width in physical pixels (length if 1D)
+    inline pixidx_t width(void)          const { return isActive() ? (stop - start) : 0; }         // segment width in physical pixels (length if 1D)
     inline uint16_t height(void)         const { return (stopY > startY) ? (stopY - startY) : 0; } // segment height (if 2D) in physical pixels // WLEDMM make sure its always > 0
-    inline uint16_t length(void)         const { return width() * height(); }     // segment length (count) in physical pixels
-    inline uint16_t groupLength(void)    const { return max(1, grouping + spacing); } // WLEDMM length = 0 could lead to div/0 in virtualWidth() and virtualHeight()
+    inline pixidx_t length(void)         const { return width() * height(); } // segment length (count) in physical pixels
+    inline uint16_t groupLength(void)    const { return _groupLen; }  // WLEDMM cached, see refreshGeometry()
+    inline uint16_t blockSize(void)      const { return _blockLen; }  // WLEDMM physical pixels per virtual pixel and axis (grouping, scaled by renderScale on 2D)
+
+    // WLEDMM adaptive quality: 0 = full ... 3 = lowest, lowered by the strip when effects exceed the frame budget.
+    // Effects can opt in by scaling their cost knobs (particle count, iterations, blur passes, noise octaves) with qualityScaled().
+    // Only effects that opted in (since their last reset) are degraded.
+    inline uint8_t  qualityLevel(void)   const { return _quality; }
+    inline uint16_t renderCost(void)     const { return _renderCost; } // us per frame (smoothed)
+    inline uint16_t levelCost(uint8_t level) const { return _levelCost[min(level, uint8_t(2))]; } // us measured at a lower level
+    inline bool     qualityAware(void)   const { return _qualityAware; }
+    inline uint16_t qualityScaled(uint16_t full, uint16_t minimum = 1) const { _qualityAware = true; return max(uint16_t((uint32_t(full) * (4 - _quality)) >> 2), minimum); }
+    inline bool     qualityReduced(uint8_t level) const { _qualityAware = true; return _quality >= level; } // for effects that skip optional steps
+    inline void     trackRenderCost(uint32_t us) { _renderCost = min((uint32_t(_renderCost) * 7 + us) >> 3, uint32_t(UINT16_MAX)); }
+    void            setQualityLevel(uint8_t level);
     inline uint8_t  getLightCapabilities(void) const { return _capabilities; }
 
     static size_t   getUsedSegmentData(void)    { return _usedSegmentData; } // WLEDMM size_t
@@ -562,15 +613,29 @@ typedef struct Segment {
 
     void    allocLeds(); //WLEDMM
 
-    void    setUp(uint16_t i1, uint16_t i2, uint8_t grp=1, uint8_t spc=0, uint16_t ofs=UINT16_MAX, uint16_t i1Y=0, uint16_t i2Y=1);
+    void    setUp(pixidx_t i1, pixidx_t i2, uint8_t grp=1, uint8_t spc=0, uint16_t ofs=UINT16_MAX, uint16_t i1Y=0, uint16_t i2Y=1);
     bool    setColor(uint8_t slot, uint32_t c); //returns true if changed
     void    setCCT(uint16_t k);
     void    setOpacity(uint8_t o);
     void    setOption(uint8_t n, bool val);
     void    setMode(uint8_t fx, bool loadDefaults = false);
     void    setPalette(uint8_t pal);
-    uint8_t differs(Segment& b) const;
+
+    // WLEDMM only the fields compared by differs() - much cheaper than a full Segment copy (which also copies effect data and leds)
+    struct Snapshot {
+      pixidx_t start, stop;
+      rowidx_t startY, stopY;
+      uint16_t offset;
+      uint16_t options;
+      uint8_t  grouping, spacing, opacity, renderScale;
+      uint8_t  mode, speed, intensity, palette;
+      uint8_t  custom1, custom2, custom3;
+      uint32_t colors[NUM_COLORS];
+    };
+    Snapshot snapshot(void) const;
+    uint8_t differs(const Snapshot& b) const; // returns SEG_DIFFERS_* mask
     void    refreshLightCapabilities(void);
+    void    refreshGeometry(void);  // WLEDMM re-calculate cached virtual dimensions and pixel writers - call after changing bounds, grouping, spacing, reverse, mirror, transpose or map1D2D directly
 
     // runtime data functions
     inline size_t dataSize(void) const { return _dataLen; }
@@ -608,7 +673,13 @@ typedef struct Segment {
     CRGBPalette16 &currentPalette(CRGBPalette16 &tgt, uint8_t paletteID);
 
     // 1D strip
-    uint16_t virtualLength(void) const;
+    pixidx_t calc_virtualLength(void) const;  // WLEDMM uncached version
+    inline pixidx_t virtualLength(void) const { // WLEDMM use cached value (jMap length depends on the loaded map, so it is not cached)
+      #ifndef WLED_DISABLE_2D
+      if (_is2Dseg && (map1D2D == M12_jMap)) return calc_virtualLength();
+      #endif
+      return _vLength;
+    }
     void setPixelColor(int n, uint32_t c); // set relative pixel within segment with color
     void setPixelColor(int n, byte r, byte g, byte b, byte w = 0) { setPixelColor(n, RGBW32(r,g,b,w)); } // automatically inline
     void setPixelColor(int n, CRGB c)                             { setPixelColor(n, RGBW32(c.r,c.g,c.b,0)); } // automatically inline
@@ -632,25 +703,30 @@ typedef struct Segment {
     uint32_t __attribute__((pure)) color_wheel(uint8_t pos);
 
     // 2D matrix
-    inline uint16_t virtualWidth() const {  // WLEDMM use fast types, and make function inline
-      uint_fast16_t groupLen = groupLength();
-      uint_fast16_t vWidth = ((transpose ? height() : width()) + groupLen - 1) / groupLen;
+    inline uint16_t calc_blockSize() const {  // WLEDMM uncached version; render scaling only applies to 2D segments
+      return (width()>1 && height()>1) ? uint16_t(grouping) << min(max(renderScale, _autoScale), uint8_t(2)) : grouping;
+    }
+    inline pixidx_t calc_virtualWidth() const {  // WLEDMM uncached version, use fast types
+      uint_fast16_t groupLen = max(1, calc_blockSize() + spacing); // WLEDMM length = 0 could lead to div/0
+      pixidx_t vWidth = ((transpose ? height() : width()) + groupLen - 1) / groupLen;
       if (mirror) vWidth = (vWidth + 1) /2;  // divide by 2 if mirror, leave at least a single LED
       return vWidth;
     }
-    inline uint16_t virtualHeight() const {  // WLEDMM use fast types, and make function inline
-      uint_fast16_t groupLen = groupLength();
+    inline uint16_t calc_virtualHeight() const {  // WLEDMM uncached version, use fast types
+      uint_fast16_t groupLen = max(1, calc_blockSize() + spacing); // WLEDMM length = 0 could lead to div/0
       uint_fast16_t vHeight = ((transpose ? width() : height()) + groupLen - 1) / groupLen;
       if (mirror_y) vHeight = (vHeight + 1) /2;  // divide by 2 if mirror, leave at least a single LED
       return vHeight;
     }
+    inline pixidx_t virtualWidth()  const { return _vWidth; }   // WLEDMM cached, see refreshGeometry()
+    inline uint16_t virtualHeight() const { return _vHeight; }  // WLEDMM cached, see refreshGeometry()
 
     uint16_t nrOfVStrips(void) const;
     void createjMap(); //WLEDMM jMap
     void deletejMap(); //WLEDMM jMap
   
   #ifndef WLED_DISABLE_2D
-    inline uint16_t XY(uint_fast16_t x, uint_fast16_t y) { // support function to get relative index within segment (for leds[]) // WLEDMM inline for speed
+    inline pixidx_t XY(uint_fast16_t x, uint_fast16_t y) { // support function to get relative index within segment (for leds[]) // WLEDMM inline for speed
       uint_fast16_t width  = virtualWidth();   // segment width in logical pixels
       uint_fast16_t height = virtualHeight();  // segment height in logical pixels
       if (width == 0) return 0;           // softhack007 avoid div/0
@@ -694,8 +770,9 @@ typedef struct Segment {
     void fill_solid(CRGB c) { fill(RGBW32(c.r,c.g,c.b,0)); }
     void nscale8(uint8_t scale);
     bool jsonToPixels(char *name, uint8_t fileNr); //WLEDMM for artifx
+    void upscaleRender(void); // WLEDMM bilinear fill between render scaled pixels, called by service()
   #else
-    inline uint16_t XY(uint16_t x, uint16_t y)                                    { return x; }
+    inline pixidx_t XY(uint16_t x, uint16_t y)                                    { return x; }
     inline void setPixelColorXY(int x, int y, uint32_t c)                         { setPixelColor(x, c); }
     inline void setPixelColorXY(unsigned x, unsigned y, uint32_t c)               { setPixelColor(int(x), c); }
     inline void setPixelColorXY(int x, int y, byte r, byte g, byte b, byte w = 0) { setPixelColor(x, RGBW32(r,g,b,w)); }
@@ -715,6 +792,7 @@ typedef struct Segment {
     inline void box_blur(uint16_t i, bool vertical, fract8 blur_amount) {}
     inline void blurRow(uint32_t row, fract8 blur_amount, bool smear = false) {}
     inline void blurCol(uint32_t col, fract8 blur_amount, bool smear = false) {}
+    inline void upscaleRender(void) {}
     inline void moveX(int8_t delta, bool wrap = false) {}
     inline void moveY(int8_t delta, bool wrap = false) {}
     inline void move(uint8_t dir, uint8_t delta, bool wrap = false) {}
@@ -730,9 +808,67 @@ typedef struct Segment {
 } segment;
 //static int segSize = sizeof(Segment);
 
+// WLEDMM explicit render context, passed to effects that use the "context" signature (see WS2812FX::addEffect()).
+// Built once per segment and frame by service(), so effects don't need to go through SEGMENT/SEGLEN/SEGCOLOR
+// (global current-segment lookups) inside their pixel loops.
+struct UM_Exchange_Data;
+typedef struct RenderContext {
+  Segment             &seg;      // segment being rendered (SEGMENT / SEGENV)
+  const uint16_t       vLength;  // SEGLEN
+  const uint16_t       vWidth;   // SEGMENT.virtualWidth()
+  const uint16_t       vHeight;  // SEGMENT.virtualHeight()
+  const uint32_t      *colors;   // SEGCOLOR(0..2) - gamma corrected, includes transition
+  const CRGBPalette16 &palette;  // SEGPALETTE
+  const unsigned long  now;      // strip.now
+
+  RenderContext(Segment &s, uint16_t len, const uint32_t *c, const CRGBPalette16 &pal, unsigned long t) :
+    seg(s), vLength(len), vWidth(s.virtualWidth()), vHeight(s.virtualHeight()), colors(c), palette(pal), now(t), _audio(nullptr) {}
+
+  UM_Exchange_Data *audio(void); // audioreactive data (or simulated sound), fetched on first use; defined in FX_fcn.cpp
+
+  private:
+    UM_Exchange_Data *_audio;
+} render_context;
+
+// WLEDMM shared particle engine for effects: physics in particle_physics.h, pool allocation and drawing here
+class ParticleSystem : public ParticlePhysics {
+  public:
+    ParticleSystem(ps_particle_t *p, uint16_t n, uint16_t w, uint16_t h = 1) : ParticlePhysics(p, n, w, h) {}
+
+    // (re)allocates count particles per pool for "pools" independent systems (e.g. virtual strips) in SEGENV.data
+    static ps_particle_t* allocate(Segment &seg, size_t count, size_t pools = 1) {
+      if (!seg.allocateData(sizeof(ps_particle_t) * count * pools)) return nullptr;
+      return reinterpret_cast<ps_particle_t*>(seg.data);
+    }
+
+    void render(Segment &seg, uint32_t (*color)(const ps_particle_t &p), int vStrip = -1, uint16_t maxUsed = UINT16_MAX) const; // one pixel per particle; vStrip selects a virtual strip (1D)
+};
+
+// WLEDMM polar coordinates of each pixel relative to a centre, shared by 2D effects (see WS2812FX::getPolarMap())
+#define POLAR_MAP_SLOTS    2   // number of different maps (size/centre) kept at the same time
+
+// WLEDMM effect metadata flags (see mode_meta_t)
+#define MODE_META_0D       0x01  // also works on single pixel segments
+#define MODE_META_1D       0x02
+#define MODE_META_2D       0x04
+#define MODE_META_VOLUME   0x08  // audio reactive (volume)
+#define MODE_META_FREQ     0x10  // audio reactive (frequency)
+#define MODE_META_PALETTE  0x20  // effect uses palette
+#define MODE_META_SLIDERS  0x40  // has UI control data ("@...")
+
+// WLEDMM effect metadata, parsed once from the mode data string ("Name@sliders;colors;palette;flags;defaults") when the effect is added.
+// Lets name and defaults lookups go straight to the right part of the PROGMEM string instead of copying and scanning all of it.
+typedef struct ModeMeta {
+  uint8_t  nameLen;       // effect name length (chars before '@')
+  uint8_t  flags;         // MODE_META_*
+  uint16_t defaultsOfs;   // offset of the defaults section (after last ';'), 0 if there is none
+  uint16_t defaultsMask;  // bit n set: default for key n of WS2812FX::modeDefaultKeyIndex() is present
+} mode_meta_t;
+
 // main "strip" class
 class WS2812FX {  // 96 bytes
   typedef uint16_t (*mode_ptr)(void); // pointer to mode function
+  typedef uint16_t (*mode_ctx_ptr)(RenderContext &ctx); // WLEDMM pointer to mode function with explicit render context
   typedef void (*show_callback)(void); // pre show callback
   typedef struct ModeData {
     uint8_t     _id;   // mode (effect) id
@@ -784,12 +920,19 @@ class WS2812FX {  // 96 bytes
       customMappingSize(0),
       _lastShow(0),
       _segment_index(0),
+      _governorHold(0),
+      _ablUs(0),
       _mainSegment(0)
+#ifndef WLED_DISABLE_2D
+      , _polarMaps{}
+#endif
     {
       WS2812FX::instance = this;
       _mode.reserve(_modeCount);     // allocate memory to prevent initial fragmentation (does not increase size())
+      _modeCtx.reserve(_modeCount);  // WLEDMM
       _modeData.reserve(_modeCount); // allocate memory to prevent initial fragmentation (does not increase size())
-      if (_mode.capacity() <= 1 || _modeData.capacity() <= 1) _modeCount = 1; // memory allocation failed only show Solid
+      _modeMeta.reserve(_modeCount); // WLEDMM
+      if (_mode.capacity() <= 1 || _modeCtx.capacity() <= 1 || _modeData.capacity() <= 1 || _modeMeta.capacity() <= 1) _modeCount = 1; // memory allocation failed only show Solid
       else setupEffectData();
     }
 
@@ -799,13 +942,18 @@ class WS2812FX {  // 96 bytes
       #endif
       if (customMappingTable) delete[] customMappingTable;
       _mode.clear();
+      _modeCtx.clear();
       _modeData.clear();
+      _modeMeta.clear();
       _segments.clear();
 #ifndef WLED_DISABLE_2D
       panel.clear();
 #endif
       customPalettes.clear();
       if (useLedsArray && Segment::_globalLeds) free(Segment::_globalLeds);
+#ifndef WLED_DISABLE_2D
+      releasePolarMaps(true);
+#endif
     }
 
     static WS2812FX* getInstance(void) { return instance; }
@@ -821,10 +969,10 @@ class WS2812FX {  // 96 bytes
       setColor(uint8_t slot, uint32_t c),
       setCCT(uint16_t k),
       setBrightness(uint8_t b, bool direct = false),
-      setRange(uint16_t i, uint16_t i2, uint32_t col),
+      setRange(pixidx_t i, pixidx_t i2, uint32_t col),
       setTransitionMode(bool t),
       purgeSegments(bool force = false),
-      setSegment(uint8_t n, uint16_t start, uint16_t stop, uint8_t grouping = 1, uint8_t spacing = 0, uint16_t offset = UINT16_MAX, uint16_t startY=0, uint16_t stopY=1),
+      setSegment(uint8_t n, pixidx_t start, pixidx_t stop, uint8_t grouping = 1, uint8_t spacing = 0, uint16_t offset = UINT16_MAX, uint16_t startY=0, uint16_t stopY=1),
       setMainSegmentId(uint8_t n),
       restartRuntime(),
       resetSegments(bool boundsOnly = false), //WLEDMM add boundsOnly
@@ -838,6 +986,7 @@ class WS2812FX {  // 96 bytes
     void setColor(uint8_t slot, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) { setColor(slot, RGBW32(r,g,b,w)); }
     void fill(uint32_t c) { for (int i = 0; i < getLengthTotal(); i++) setPixelColor(i, c); } // fill whole strip with color (inline)
     void addEffect(uint8_t id, mode_ptr mode_fn, const char *mode_name); // add effect to the list; defined in FX.cpp
+    void addEffect(uint8_t id, mode_ctx_ptr mode_fn, const char *mode_name); // WLEDMM add effect that takes a RenderContext; defined in FX.cpp
     void setupEffectData(void); // add default effects to the list; defined in FX.cpp
 
     // outsmart the compiler :) by correctly overloading
@@ -855,7 +1004,8 @@ class WS2812FX {  // 96 bytes
       // return true if the strip is being sent pixel updates
       isUpdating(void),
       deserializeMap(uint8_t n=0),
-      useLedsArray = false;
+      useLedsArray = false,
+      adaptiveQuality = WLEDMM_QUALITY_GOVERNOR; // WLEDMM let governQuality() lower the quality of expensive effects
 
     inline bool isServicing(void) { return _isServicing; }
     inline bool hasWhiteChannel(void) {return _hasWhiteChannel;}
@@ -884,19 +1034,22 @@ class WS2812FX {  // 96 bytes
     uint16_t
       ablMilliampsMax,
       currentMilliamps,
-      getLengthPhysical(void),
-      __attribute__((pure)) getLengthTotal(void), // will include virtual/nonexistent pixels in matrix //WLEDMM attribute added
       getFps();
 
+    pixidx_t
+      getLengthPhysical(void),
+      __attribute__((pure)) getLengthTotal(void); // will include virtual/nonexistent pixels in matrix //WLEDMM attribute added
+
     inline uint16_t getFrameTime(void) { return _frametime; }
     inline uint16_t getMinShowDelay(void) { return MIN_SHOW_DELAY; }
-    inline uint16_t getLength(void) { return _length; } // 2D matrix may have less pixels than W*H
+    inline pixidx_t getLength(void) { return _length; } // 2D matrix may have less pixels than W*H
+    inline uint16_t getAblTime(void) { return _ablUs; } // WLEDMM us per frame spent in current estimation
     inline uint16_t getTransition(void) { return _transitionDur; }
 
     uint32_t
       now,
       timebase;
-    uint32_t __attribute__((pure)) getPixelColor(uint_fast16_t);   // WLEDMM attribute pure = does not have side-effects
+    uint32_t __attribute__((pure)) getPixelColor(pixidx_t);   // WLEDMM attribute pure = does not have side-effects
 
     inline uint32_t getLastShow(void) { return _lastShow; }
     inline uint32_t segColor(uint8_t i) { return _colors_t[i]; }
@@ -907,6 +1060,9 @@ class WS2812FX {  // 96 bytes
     const char **
       getModeDataSrc(void) { return &(_modeData[0]); } // vectors use arrays for underlying data
 
+    inline const mode_meta_t& getModeMeta(uint8_t id) { return _modeMeta[(id<_modeMeta.size()) ? id : 0]; } // WLEDMM parsed mode data
+    static int8_t modeDefaultKeyIndex(const char *key); // WLEDMM bit index of a mode default key ("sx", "ix", ...) in mode_meta_t::defaultsMask, -1 if unknown
+
     Segment&        getSegment(uint8_t id);
     inline Segment& getFirstSelectedSeg(void) { return _segments[getFirstSelectedSegId()]; }
     inline Segment& getMainSegment(void)      { return _segments[getMainSegmentId()]; }
@@ -940,8 +1096,8 @@ class WS2812FX {  // 96 bytes
     } panelO; //panelOrientation
 
     typedef struct panel_t {
-      uint8_t xOffset; // x offset relative to the top left of matrix in LEDs. WLEDMM 8 bits/256 is enough
-      uint8_t yOffset; // y offset relative to the top left of matrix in LEDs. WLEDMM 8 bits/256 is enough
+      rowidx_t xOffset; // x offset relative to the top left of matrix in LEDs. WLEDMM 8 bits/256 is enough, unless WLED_LARGE_INSTALLATION
+      rowidx_t yOffset; // y offset relative to the top left of matrix in LEDs. WLEDMM 8 bits/256 is enough, unless WLED_LARGE_INSTALLATION
       uint8_t  width;   // width of the panel
       uint8_t  height;  // height of the panel
       union {
@@ -975,22 +1131,28 @@ class WS2812FX {  // 96 bytes
     uint32_t
       getPixelColorXY(uint16_t, uint16_t);
 
+    // WLEDMM cached polar map of a cols x rows canvas, index x + y*cols; nullptr if out of memory. Rebuilt when size or centre change.
+    // If all shared maps are in use by other geometries, the map is kept in the data of owner (if given, the effect must not use SEGENV.data itself).
+    const polar_t* getPolarMap(uint16_t cols, uint16_t rows, int16_t cx, int16_t cy, Segment *owner = nullptr);
+    inline const polar_t* getPolarMap(uint16_t cols, uint16_t rows) { return getPolarMap(cols, rows, cols/2, rows/2); }
+
   // end 2D support
 
-    void loadCustomPalettes(void); // loads custom palettes from JSON
+    void loadCustomPalettes(void); // loads custom palettes from binary or JSON files
+    static void removeCustomPaletteBin(const char *jsonFileName); // WLEDMM drop binary copy of a custom palette, call when palette JSON changes
     CRGBPalette16 _currentPalette; // palette used for current effect (includes transition)
     std::vector<CRGBPalette16> customPalettes; // TODO: move custom palettes out of WS2812FX class
 
     // using public variables to reduce code size increase due to inline function getSegment() (with bounds checking)
     // and color transitions
     uint32_t _colors_t[3]; // color used for effect (includes transition)
-    uint16_t _virtualSegmentLength;
+    uint16_t _virtualSegmentLength; // WLEDMM stays 16bit (saturated) even with WLED_LARGE_INSTALLATION, as effects loop with uint16_t counters
 
     std::vector<segment> _segments;
     friend class Segment;
 
   private:
-    uint16_t _length;
+    pixidx_t _length;
     uint8_t  _brightness;
     uint16_t _transitionDur;
 
@@ -1012,21 +1174,38 @@ class WS2812FX {  // 96 bytes
 
     uint8_t                  _modeCount;
     std::vector<mode_ptr>    _mode;     // SRAM footprint: 4 bytes per element
+    std::vector<mode_ctx_ptr> _modeCtx; // WLEDMM effects with explicit render context; nullptr = use _mode (legacy signature)
     std::vector<const char*> _modeData; // mode (effect) name and its slider control data array
+    std::vector<mode_meta_t> _modeMeta; // WLEDMM parsed _modeData, 6 bytes per effect
+
+    static mode_meta_t parseModeMeta(const char *modeData); // WLEDMM defined in FX.cpp
 
     show_callback _callback;
 
-    uint16_t* customMappingTable;
-    uint16_t  customMappingTableSize; //WLEDMM
-    uint16_t  customMappingSize;
+    pixidx_t* customMappingTable;     // WLEDMM 16bit entries unless MAX_LEDS > 65535
+    size_t    customMappingTableSize; //WLEDMM
+    size_t    customMappingSize;
 
     /*uint32_t*/ unsigned long _lastShow; // WLEDMM avoid losing precision
 
     uint8_t _segment_index;
+    uint16_t _governorHold; // WLEDMM frames until the quality governor may act again
+    uint16_t _ablUs;        // WLEDMM smoothed time of estimateCurrentAndLimitBri() (us)
     uint8_t _mainSegment;
 
+#ifndef WLED_DISABLE_2D
+    struct PolarMapSlot {       // WLEDMM see getPolarMap()
+      polar_t *map;
+      uint16_t cols, rows;
+      int16_t  cx, cy;
+      unsigned long lastUsed;   // millis()
+    } _polarMaps[POLAR_MAP_SLOTS];
+    void releasePolarMaps(bool all = false); // frees maps not used for a while
+#endif
+
     void
-      estimateCurrentAndLimitBri(void);
+      estimateCurrentAndLimitBri(void),
+      governQuality(void); // WLEDMM
 };
 
 extern const char JSON_mode_names[];
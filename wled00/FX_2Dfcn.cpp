@@ -75,11 +75,11 @@ void WS2812FX::setUpMatrix() {
 
       // don't use new / delete
       if ((size > 0) && (customMappingTable != nullptr)) {  // resize
-        customMappingTable = (uint16_t*) reallocf(customMappingTable, sizeof(uint16_t) * size); // reallocf will free memory if it cannot resize
+        customMappingTable = (pixidx_t*) reallocf(customMappingTable, sizeof(pixidx_t) * size); // reallocf will free memory if it cannot resize
       }
       if ((size > 0) && (customMappingTable == nullptr)) { // second try
         DEBUG_PRINTLN("setUpMatrix: trying to get fresh memory block.");
-        customMappingTable = (uint16_t*) calloc(size, sizeof(uint16_t));
+        customMappingTable = (pixidx_t*) calloc(size, sizeof(pixidx_t));
         if (customMappingTable == nullptr) { 
           USER_PRINTLN("setUpMatrix: alloc failed");
           errorFlag = ERR_LOW_MEM; // WLEDMM raise errorflag
@@ -93,7 +93,7 @@ void WS2812FX::setUpMatrix() {
 
       // fill with empty in case we don't fill the entire matrix
       for (size_t i = 0; i< customMappingTableSize; i++) { //WLEDMM use customMappingTableSize
-        customMappingTable[i] = (uint16_t)-1;
+        customMappingTable[i] = PIXIDX_NONE;
       }
 
       // we will try to load a "gap" array (a JSON file)
@@ -130,7 +130,8 @@ void WS2812FX::setUpMatrix() {
         releaseJSONBufferLock();
       }
 
-      uint16_t x, y, pix=0; //pixel
+      uint16_t x, y;
+      pixidx_t pix=0; //pixel
       for (size_t pan = 0; pan < panel.size(); pan++) {
         Panel &p = panel[pan];
         uint16_t h = p.vertical ? p.height : p.width;
@@ -152,7 +153,7 @@ void WS2812FX::setUpMatrix() {
 
       #ifdef WLED_DEBUG_MAPS
       DEBUG_PRINTF("Matrix ledmap: \n");
-      for (uint16_t i=0; i<customMappingSize; i++) {
+      for (size_t i=0; i<customMappingSize; i++) {
         if (!(i%Segment::maxWidth)) DEBUG_PRINTLN();
         DEBUG_PRINTF("%4d,", customMappingTable[i]);
       }
@@ -181,9 +182,9 @@ void IRAM_ATTR_YN WS2812FX::setPixelColorXY(int x, int y, uint32_t col) //WLEDMM
 {
 #ifndef WLED_DISABLE_2D
   if (!isMatrix) return; // not a matrix set-up
-  uint_fast16_t index = y * Segment::maxWidth + x;
+  size_t index = y * Segment::maxWidth + x;
 #else
-  uint16_t index = x;
+  size_t index = x;
 #endif
   if (index < customMappingSize) index = customMappingTable[index];
   if (index >= _length) return;
@@ -193,15 +194,77 @@ void IRAM_ATTR_YN WS2812FX::setPixelColorXY(int x, int y, uint32_t col) //WLEDMM
 // returns RGBW values of pixel
 uint32_t WS2812FX::getPixelColorXY(uint16_t x, uint16_t y) {
 #ifndef WLED_DISABLE_2D
-  uint_fast16_t index = (y * Segment::maxWidth + x); //WLEDMM: use fast types
+  size_t index = (y * Segment::maxWidth + x); //WLEDMM: use fast types
 #else
-  uint16_t index = x;
+  size_t index = x;
 #endif
   if (index < customMappingSize) index = customMappingTable[index];
   if (index >= _length) return 0;
   return busses.getPixelColor(index);
 }
 
+#ifndef WLED_DISABLE_2D
+// WLEDMM shared polar maps: angle and radius of each pixel are computed once per canvas size and centre,
+// instead of atan2() and sqrt() per pixel and frame in every effect. Segments with the same geometry share one map.
+#define POLAR_MAP_TIMEOUT 5000 // ms - maps that were not requested for this long are freed
+#define POLAR_MAP_IN_USE  1000 // ms - maps requested more recently are still used by a segment and are not evicted
+
+// map kept in the data of a segment when all shared slots are busy (more geometries than POLAR_MAP_SLOTS)
+typedef struct PolarMapOwn {
+  uint16_t cols, rows;
+  int16_t  cx, cy;
+} polar_own_t;  // followed by cols*rows polar_t
+
+const polar_t* WS2812FX::getPolarMap(uint16_t cols, uint16_t rows, int16_t cx, int16_t cy, Segment *owner) {
+  if (cols == 0 || rows == 0 || cols > POLAR_MAX_DIM || rows > POLAR_MAX_DIM) return nullptr;
+  unsigned long nowMs = millis();
+  PolarMapSlot *slot = nullptr;
+  for (PolarMapSlot &s : _polarMaps) {
+    if (s.map && s.cols == cols && s.rows == rows && s.cx == cx && s.cy == cy) { // cache hit
+      s.lastUsed = nowMs;
+      if (owner && owner->data) owner->deallocateData(); // own map no longer needed
+      return s.map;
+    }
+    if (!slot || !s.map || (slot->map && s.lastUsed < slot->lastUsed)) slot = &s; // free or least recently used slot
+  }
+
+  // all slots still in use: evicting one would rebuild maps every frame, use a map of the segment instead
+  if (slot->map && nowMs - slot->lastUsed < POLAR_MAP_IN_USE && owner) {
+    if (!owner->allocateData(sizeof(polar_own_t) + sizeof(polar_t) * cols * rows)) return nullptr;
+    polar_own_t *own = reinterpret_cast<polar_own_t*>(owner->data);
+    polar_t *map = reinterpret_cast<polar_t*>(owner->data + sizeof(polar_own_t));
+    if (own->cols != cols || own->rows != rows || own->cx != cx || own->cy != cy) {
+      fillPolarMap(map, cols, rows, cx, cy);
+      own->cols = cols; own->rows = rows;
+      own->cx = cx; own->cy = cy;
+    }
+    return map;
+  }
+
+  if (slot->map) free(slot->map);
+  slot->map = (polar_t*) malloc(sizeof(polar_t) * cols * rows);
+  if (!slot->map) {
+    errorFlag = ERR_LOW_MEM;
+    USER_PRINTF("getPolarMap(): out of memory for %ux%u map.\n", cols, rows);
+    return nullptr;
+  }
+  slot->cols = cols; slot->rows = rows;
+  slot->cx = cx; slot->cy = cy;
+  slot->lastUsed = nowMs;
+  fillPolarMap(slot->map, cols, rows, cx, cy);
+  if (owner && owner->data) owner->deallocateData();
+  DEBUG_PRINTF("getPolarMap(): built %ux%u map (centre %d,%d), %u bytes\n", cols, rows, cx, cy, unsigned(sizeof(polar_t) * cols * rows));
+  return slot->map;
+}
+
+void WS2812FX::releasePolarMaps(bool all) {
+  unsigned long nowMs = millis();
+  for (PolarMapSlot &s : _polarMaps) {
+    if (s.map && (all || nowMs - s.lastUsed > POLAR_MAP_TIMEOUT)) { free(s.map); s.map = nullptr; }
+  }
+}
+#endif
+
 ///////////////////////////////////////////////////////////
 // Segment:: routines
 ///////////////////////////////////////////////////////////
@@ -211,6 +274,79 @@ uint32_t WS2812FX::getPixelColorXY(uint16_t x, uint16_t y) {
 // XY(x,y) - gets pixel index within current segment (often used to reference leds[] array element)
 // WLEDMM Segment::XY()is declared inline, see FX.h
 
+// WLEDMM 2D pixel writers: map (valid) virtual coordinates to the matrix. One of them is selected by selectWriterXY().
+// Without grouping, spacing and mirror every virtual pixel is exactly one physical pixel, so no bounds checks are needed.
+template<bool REVERSE, bool REVERSE_Y, bool TRANSPOSE>
+static void IRAM_ATTR_YN writePixelXY(const Segment &seg, int x, int y, uint32_t col) {
+  if (REVERSE  ) x = seg.virtualWidth()  - x - 1;
+  if (REVERSE_Y) y = seg.virtualHeight() - y - 1;
+  if (TRANSPOSE) { int t = x; x = y; y = t; } // swap X & Y if segment transposed
+  strip.setPixelColorXY(seg.start + x, seg.startY + y, col);
+}
+
+// grouping, spacing and mirror
+static void IRAM_ATTR_YN writePixelXYGrouped(const Segment &seg, int x, int y, uint32_t col) {
+  const uint_fast16_t width  = seg.width();
+  const uint_fast16_t height = seg.height();
+
+  if (seg.reverse  ) x = seg.virtualWidth()  - x - 1;
+  if (seg.reverse_y) y = seg.virtualHeight() - y - 1;
+  if (seg.transpose) { uint16_t t = x; x = y; y = t; } // swap X & Y if segment transposed
+
+  x *= seg.groupLength(); // expand to physical pixels
+  y *= seg.groupLength(); // expand to physical pixels
+  if (x >= width || y >= height) return;  // if pixel would fall out of segment just exit
+
+  const int block = seg.blockSize();        // grouping, enlarged by render scaling
+  for (int j = 0; j < block; j++) {   // groupping vertically
+    for (int g = 0; g < block; g++) { // groupping horizontally
+      uint_fast16_t xX = (x+g), yY = (y+j);    //WLEDMM: use fast types
+      if (xX >= width || yY >= height) continue; // we have reached one dimension's end
+
+      strip.setPixelColorXY(seg.start + xX, seg.startY + yY, col);
+
+      if (seg.mirror) { //set the corresponding horizontally mirrored pixel
+        if (seg.transpose) strip.setPixelColorXY(seg.start + xX, seg.startY + height - yY - 1, col);
+        else               strip.setPixelColorXY(seg.start + width - xX - 1, seg.startY + yY, col);
+      }
+      if (seg.mirror_y) { //set the corresponding vertically mirrored pixel
+        if (seg.transpose) strip.setPixelColorXY(seg.start + width - xX - 1, seg.startY + yY, col);
+        else               strip.setPixelColorXY(seg.start + xX, seg.startY + height - yY - 1, col);
+      }
+      if (seg.mirror_y && seg.mirror) { //set the corresponding vertically AND horizontally mirrored pixel
+        strip.setPixelColorXY(width - xX - 1, height - yY - 1, col);
+      }
+    }
+  }
+}
+
+// render scaling without spacing and mirror: only the top-left pixel of each block is written, upscaleRender() fills the rest
+static void IRAM_ATTR_YN writePixelXYScaled(const Segment &seg, int x, int y, uint32_t col) {
+  if (seg.reverse  ) x = seg.virtualWidth()  - x - 1;
+  if (seg.reverse_y) y = seg.virtualHeight() - y - 1;
+  if (seg.transpose) { int t = x; x = y; y = t; } // swap X & Y if segment transposed
+  x *= seg.blockSize();
+  y *= seg.blockSize();
+  if (x >= seg.width() || y >= seg.height()) return;
+  strip.setPixelColorXY(seg.start + x, seg.startY + y, col);
+}
+
+// called by refreshGeometry()
+void Segment::selectWriterXY(void) {
+  if (_blockLen > grouping && spacing == 0 && !mirror && !mirror_y) { _writeXY = writePixelXYScaled; return; } // render scaled
+  if (_blockLen != 1 || spacing > 0 || mirror || mirror_y) { _writeXY = writePixelXYGrouped; return; }
+  switch ((reverse ? 1 : 0) | (reverse_y ? 2 : 0) | (transpose ? 4 : 0)) {
+    case 0: _writeXY = writePixelXY<false, false, false>; break;
+    case 1: _writeXY = writePixelXY<true,  false, false>; break;
+    case 2: _writeXY = writePixelXY<false, true,  false>; break;
+    case 3: _writeXY = writePixelXY<true,  true,  false>; break;
+    case 4: _writeXY = writePixelXY<false, false, true >; break;
+    case 5: _writeXY = writePixelXY<true,  false, true >; break;
+    case 6: _writeXY = writePixelXY<false, true,  true >; break;
+    default:_writeXY = writePixelXY<true,  true,  true >; break;
+  }
+}
+
 void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col) //WLEDMM: IRAM_ATTR conditionally
 {
   if (Segment::maxHeight==1) return; // not a matrix set-up
@@ -224,34 +360,7 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col) //WLEDMM:
     col = color_fade(col, _bri_t);
   }
 
-  if (reverse  ) x = virtualWidth()  - x - 1;
-  if (reverse_y) y = virtualHeight() - y - 1;
-  if (transpose) { uint16_t t = x; x = y; y = t; } // swap X & Y if segment transposed
-
-  x *= groupLength(); // expand to physical pixels
-  y *= groupLength(); // expand to physical pixels
-  if (x >= width() || y >= height()) return;  // if pixel would fall out of segment just exit
-
-  for (int j = 0; j < grouping; j++) {   // groupping vertically
-    for (int g = 0; g < grouping; g++) { // groupping horizontally
-      uint_fast16_t xX = (x+g), yY = (y+j);    //WLEDMM: use fast types
-      if (xX >= width() || yY >= height()) continue; // we have reached one dimension's end
-
-      strip.setPixelColorXY(start + xX, startY + yY, col);
-
-      if (mirror) { //set the corresponding horizontally mirrored pixel
-        if (transpose) strip.setPixelColorXY(start + xX, startY + height() - yY - 1, col);
-        else           strip.setPixelColorXY(start + width() - xX - 1, startY + yY, col);
-      }
-      if (mirror_y) { //set the corresponding vertically mirrored pixel
-        if (transpose) strip.setPixelColorXY(start + width() - xX - 1, startY + yY, col);
-        else           strip.setPixelColorXY(start + xX, startY + height() - yY - 1, col);
-      }
-      if (mirror_y && mirror) { //set the corresponding vertically AND horizontally mirrored pixel
-        strip.setPixelColorXY(width() - xX - 1, height() - yY - 1, col);
-      }
-    }
-  }
+  (*_writeXY)(*this, x, y, col); // WLEDMM writer selected by refreshGeometry()
 }
 
 // anti-aliased version of setPixelColorXY()
@@ -319,6 +428,41 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColorXY(int x, int y) {
   return strip.getPixelColorXY(start + x, startY + y);
 }
 
+// WLEDMM render scaling: the effect has drawn one pixel per block (its top-left corner, see writePixelXYScaled()).
+// Fill the remaining pixels by bilinear interpolation between neighbouring block corners, in 8bit fixed point.
+// Rough cost per frame, relative to full resolution: 1/2 scale = 1/4 effect calls + ~1 write per pixel, 1/4 scale = 1/16 + ~1 write per pixel.
+// With spacing or mirroring the grouped writer already fills whole blocks (nearest neighbour), nothing to do here.
+void Segment::upscaleRender(void) {
+  if (_writeXY != writePixelXYScaled) return;
+  const int block = blockSize();
+  const int w = width(), h = height();
+  if (block < 2 || w < 1 || h < 1) return;
+  const int lastX = ((w - 1) / block) * block; // last block corner in each row/column
+  const int lastY = ((h - 1) / block) * block;
+
+  for (int ay = 0; ay < h; ay += block) {
+    const int ay1 = min(ay + block, lastY);
+    uint32_t c00 = strip.getPixelColorXY(start, startY + ay);   // top-left corner of current block
+    uint32_t c01 = strip.getPixelColorXY(start, startY + ay1);  // bottom-left corner
+    for (int ax = 0; ax < w; ax += block) {
+      const int ax1 = min(ax + block, lastX);
+      const uint32_t c10 = strip.getPixelColorXY(start + ax1, startY + ay);  // top-right corner (= next block)
+      const uint32_t c11 = strip.getPixelColorXY(start + ax1, startY + ay1); // bottom-right corner
+      for (int j = 0; j < block && ay + j < h; j++) {
+        const uint8_t fy = (j << 8) / block;
+        const uint32_t left  = color_blend(c00, c01, fy);
+        const uint32_t right = color_blend(c10, c11, fy);
+        for (int i = 0; i < block && ax + i < w; i++) {
+          if (i == 0 && j == 0) continue; // keep the pixel drawn by the effect
+          strip.setPixelColorXY(start + ax + i, startY + ay + j, color_blend(left, right, (i << 8) / block));
+        }
+      }
+      c00 = c10; // right corners become left corners of the next block
+      c01 = c11;
+    }
+  }
+}
+
 // Blends the specified color with the existing pixel color.
 void Segment::blendPixelColorXY(uint16_t x, uint16_t y, uint32_t color, uint8_t blend) {
   setPixelColorXY(x, y, color_blend(getPixelColorXY(x,y), color, blend));
@@ -716,4 +860,8 @@ void Segment::wu_pixel(uint32_t x, uint32_t y, CRGB c) {      //awesome wu_pixel
 }
 #undef WU_WEIGHT
 
+#else
+
+void Segment::selectWriterXY(void) { _writeXY = nullptr; } // WLEDMM no 2D support
+
 #endif // WLED_DISABLE_2D
@@ -29,6 +29,13 @@
 #ifdef ARDUINO_ARCH_ESP32
 #include <esp_timer.h>     // WLEDMM to get esp_timer_get_time() 
 #endif
+// WLEDMM gradient palettes pre-expanded at build time by pio-scripts/build-palettes.py
+#if defined(__has_include) && !defined(WLEDMM_NO_EXPANDED_PALETTES)
+  #if __has_include("palettes_expanded.h")
+    #include "palettes_expanded.h"
+    #define WLED_HAVE_EXPANDED_PALETTES
+  #endif
+#endif
 
 /*
   Custom per-LED mapping has moved!
@@ -92,7 +99,7 @@ bool strip_uses_global_leds(void) {
 ///////////////////////////////////////////////////////////////////////////////
 size_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
 CRGB    *Segment::_globalLeds = nullptr;
-uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
+pixidx_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
 
 // copy constructor - creates a new segment by copy from orig, but does not copy buffers. Does not modify orig!
@@ -263,6 +270,7 @@ void Segment::resetIfRequired() {
     if (transitional && _t) { transitional = false; delete _t; _t = nullptr; }
     deallocateData();
     next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0;
+    _qualityAware = false; setQualityLevel(0); // WLEDMM (new) effect starts at full quality, until it opts in again
     reset = false; // setOption(SEG_OPTION_RESET, false);
   }
 }
@@ -400,6 +408,12 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
       if (pal>245) {
         targetPalette = strip.customPalettes[255-pal]; // we checked bounds above
       } else {
+        #ifdef WLED_HAVE_EXPANDED_PALETTES
+        if (pal-13 < WLED_EXPANDED_PALETTE_COUNT) { // WLEDMM already expanded at build time
+          memcpy_P(targetPalette.entries, gExpandedPalettes[pal-13], sizeof(targetPalette.entries));
+          break;
+        }
+        #endif
         memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[pal-13])), 72);
         targetPalette.loadDynamicGradientPalette(tcp);
       }
@@ -486,7 +500,7 @@ void Segment::handleTransition() {
   }
 }
 
-void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t ofs, uint16_t i1Y, uint16_t i2Y) {
+void Segment::setUp(pixidx_t i1, pixidx_t i2, uint8_t grp, uint8_t spc, uint16_t ofs, uint16_t i1Y, uint16_t i2Y) {
   //return if neither bounds nor grouping have changed
   bool boundsUnchanged = (start == i1 && stop == i2);
   #ifndef WLED_DISABLE_2D
@@ -502,10 +516,11 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
   if (i2 <= i1) { //disable segment
     stop = 0;
     markForReset();
+    refreshGeometry(); // WLEDMM
     return;
   }
   if (i1 < Segment::maxWidth || (i1 >= Segment::maxWidth*Segment::maxHeight && i1 < strip.getLengthTotal())) start = i1; // Segment::maxWidth equals strip.getLengthTotal() for 1D
-  stop = i2 > Segment::maxWidth*Segment::maxHeight ? min(i2,strip.getLengthTotal()) : (i2 > Segment::maxWidth ? Segment::maxWidth : max((uint16_t)1,i2));  // WLEDMM: use native min/max
+  stop = i2 > Segment::maxWidth*Segment::maxHeight ? min(i2,strip.getLengthTotal()) : (i2 > Segment::maxWidth ? Segment::maxWidth : max((pixidx_t)1,i2));  // WLEDMM: use native min/max
   startY = 0;
   stopY  = 1;
   #ifndef WLED_DISABLE_2D
@@ -520,6 +535,7 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
   }
   if (ofs < UINT16_MAX) offset = ofs;
   markForReset();
+  refreshGeometry(); // WLEDMM
   if (!boundsUnchanged) refreshLightCapabilities();
 }
 
@@ -560,6 +576,7 @@ void Segment::setOption(uint8_t n, bool val) {
   if (fadeTransition && n == SEG_OPTION_ON && val != prevOn) startTransition(strip.getTransition()); // start transition prior to change
   if (val) options |=   0x01 << n;
   else     options &= ~(0x01 << n);
+  if (n == SEG_OPTION_MIRROR || n == SEG_OPTION_MIRROR_Y || n == SEG_OPTION_TRANSPOSED || n == SEG_OPTION_REVERSED || n == SEG_OPTION_REVERSED_Y) refreshGeometry(); // WLEDMM
   if (!(n == SEG_OPTION_SELECTED || n == SEG_OPTION_RESET || n == SEG_OPTION_TRANSITIONAL)) stateChanged = true; // send UDP/WS broadcast
 }
 
@@ -598,6 +615,7 @@ void Segment::setMode(uint8_t fx, bool loadDefaults) {
         sOpt = extractModeDefaults(fx, "rY");   if (sOpt >= 0) {if (oldReverse_y==-1) oldReverse_y = reverse_y; reverse_y = (bool)sOpt;} else {if (oldReverse_y!=-1) reverse_y = oldReverse_y==1; oldReverse_y = -1;}
         sOpt = extractModeDefaults(fx, "mY");   if (sOpt >= 0) {if (oldMirror_y==-1) oldMirror_y = mirror_y; mirror_y  = (bool)sOpt;} else {if (oldMirror_y!=-1) mirror_y = oldMirror_y==1; oldMirror_y = -1;} // NOTE: setting this option is a risky business
         sOpt = extractModeDefaults(fx, "pal");  if (sOpt >= 0) {if (oldPalette==-1) oldPalette = palette; setPalette(sOpt);} else {if (oldPalette!=-1) setPalette(oldPalette); oldPalette = -1;}
+        refreshGeometry(); // WLEDMM m12 and mirror may have changed
       }
       if (!fadeTransition) markForReset(); // WLEDMM quickfix for effect "double startup" bug. -> only works when "Crossfade" is disabled (led settings)
       stateChanged = true; // send UDP/WS broadcast
@@ -802,13 +820,91 @@ constexpr float Int_to_Rad_Big = (DEG_TO_RAD * 360) / Pinwheel_Steps_Big;      /
 // WLEDMM end
 
 
+// WLEDMM audio data for effects using RenderContext - only looked up when an effect asks for it
+um_data_t *RenderContext::audio(void) {
+  if (_audio == nullptr) {
+    if (!usermods.getUMData(&_audio, USERMOD_ID_AUDIOREACTIVE)) _audio = simulateSound(seg.soundSim);
+  }
+  return _audio;
+}
+
+// WLEDMM 1D pixel writers: map a (valid) virtual index to the strip. One of them is selected by refreshGeometry().
+// Segments without grouping, spacing and mirror (the common case) only need the reverse and offset applied.
+template<bool REVERSE>
+static void IRAM_ATTR_YN writePixel1D(const Segment &seg, int i, uint32_t col) {
+  pixidx_t len = seg.length();
+  if (REVERSE) i = (len - 1) - i;
+  pixidx_t index = seg.start + i + seg.offset; // offset/phase
+  if (index >= seg.stop) index -= len; // wrap
+  strip.setPixelColor(index, col);
+}
+
+// grouping, spacing and mirror
+static void IRAM_ATTR_YN writePixel1DGrouped(const Segment &seg, int i, uint32_t col) {
+  pixidx_t len = seg.length();
+  // expand pixel (taking into account start, grouping, spacing [and offset])
+  i = i * seg.groupLength();
+  if (seg.reverse) { // is segment reversed?
+    if (seg.mirror) { // is segment mirrored?
+      i = (len - 1) / 2 - i;  //only need to index half the pixels
+    } else {
+      i = (len - 1) - i;
+    }
+  }
+  i += seg.start; // starting pixel in a group
+
+  // set all the pixels in the group
+  for (int j = 0; j < seg.grouping; j++) {
+    pixidx_t indexSet = i + ((seg.reverse) ? -j : j);
+    if (indexSet >= seg.start && indexSet < seg.stop) {
+      if (seg.mirror) { //set the corresponding mirrored pixel
+        pixidx_t indexMir = seg.stop - indexSet + seg.start - 1;
+        indexMir += seg.offset; // offset/phase
+        if (indexMir >= seg.stop) indexMir -= len; // wrap
+        strip.setPixelColor(indexMir, col);
+      }
+      indexSet += seg.offset; // offset/phase
+      if (indexSet >= seg.stop) indexSet -= len; // wrap
+      strip.setPixelColor(indexSet, col);
+    }
+  }
+}
+
+// WLEDMM re-calculate cached geometry. Order matters: calc_virtualLength() depends on the cached 2D values.
+void Segment::refreshGeometry(void) {
+  _is2Dseg  = (width()>1 && height()>1);
+  _blockLen = calc_blockSize();
+  _groupLen = max(1, _blockLen + spacing); // WLEDMM length = 0 could lead to div/0 in virtualWidth() and virtualHeight()
+  _vWidth   = calc_virtualWidth();
+  _vHeight  = calc_virtualHeight();
+  _vLength  = calc_virtualLength();
+
+  if (grouping != 1 || spacing > 0 || mirror) _write1D = writePixel1DGrouped;
+  else _write1D = reverse ? writePixel1D<true> : writePixel1D<false>;
+  selectWriterXY();
+}
+
+// WLEDMM lowest quality level also halves the render resolution of 2D segments (unless renderScale already does).
+// The effect keeps running: it paints the whole segment at the new block size in its next frame, so no blanking or reset.
+void Segment::setQualityLevel(uint8_t level) {
+  level = min(level, uint8_t(3));
+  if (level == _quality) return;
+  if (level > _quality) _levelCost[_quality] = _renderCost; // cost at the level we leave, see governQuality()
+  _quality = level;
+  uint8_t autoScale = (_quality > 2 && _is2Dseg) ? 1 : 0;
+  if (autoScale == _autoScale) return;
+  _autoScale = autoScale;
+  if (renderScale >= 1) return; // geometry unchanged
+  refreshGeometry();
+}
+
 // 1D strip
-uint16_t Segment::virtualLength() const {
+pixidx_t Segment::calc_virtualLength() const {
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
-    uint16_t vW = virtualWidth();
-    uint16_t vH = virtualHeight();
-    uint16_t vLen = vW * vH; // use all pixels from segment
+    pixidx_t vW = virtualWidth();
+    pixidx_t vH = virtualHeight();
+    pixidx_t vLen = vW * vH; // use all pixels from segment
     switch (map1D2D) {
       case M12_pBar:
         vLen = vH;
@@ -843,11 +939,19 @@ uint16_t Segment::virtualLength() const {
   }
 #endif
   uint16_t groupLen = groupLength();
-  uint16_t vLength = (length() + groupLen - 1) / groupLen;
+  pixidx_t vLength = (length() + groupLen - 1) / groupLen;
   if (mirror) vLength = (vLength + 1) /2;  // divide by 2 if mirror, leave at least a single LED
   return vLength;
 }
 
+//WLEDMM used for M12_sCircle: pixel i on circle number vStrip (whole degrees, fast math)
+static void xyFromCircle(int &x, int &y, int i, uint16_t vW, uint16_t vStrip, uint16_t nStrips) {
+  uint16_t angle = uint32_t(360*i/SEGLEN) * 65536U / 360U; // degrees to 1/65536 of a circle
+  float scale = float(vW * (vStrip+1)) / (32767.0f * nStrips);
+  x = roundf(sin16_t(angle) * scale);
+  y = roundf(cos16_t(angle) * scale);
+}
+
 //WLEDMM used for M12_sBlock
 void xyFromBlock(uint16_t &x,uint16_t &y, uint16_t i, uint16_t vW, uint16_t vH, uint16_t vStrip) {
   float i2;
@@ -878,16 +982,16 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) //WLEDMM: IRAM_ATT
 {
   if (!isActive()) return; // not active
 #ifndef WLED_DISABLE_2D
-  int vStrip = i>>16; // hack to allow running on virtual strips (2D segment columns/rows)
+  int vStrip = VSTRIP_OF(i); // hack to allow running on virtual strips (2D segment columns/rows)
 #endif
-  i &= 0xFFFF;
+  i = VSTRIP_INDEX(i);        // WLEDMM may exceed 16 bit in large installations
 
   if (i >= virtualLength() || i<0) return;  // if pixel would fall out of segment just exit
 
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
-    uint16_t vH = virtualHeight();  // segment height in logical pixels
-    uint16_t vW = virtualWidth();
+    pixidx_t vH = virtualHeight();  // segment height in logical pixels
+    pixidx_t vW = virtualWidth();
     switch (map1D2D) {
       case M12_Pixels:
         // use all available pixels as a long strip
@@ -915,14 +1019,17 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) //WLEDMM: IRAM_ATT
           if (useSymmetry) numSteps = 1 + ((HALF_PI/2.0f + step/2.0f) / step); // with symmetry
           else             numSteps = 1 + ((HALF_PI      + step/2.0f) / step); // without symmetry
 
-          float rad = 0.0f;
+          // WLEDMM fast math: angle in 1/65536 of a circle, with 8 extra fractional bits to avoid accumulating rounding errors
+          const uint32_t step24 = step * (65536.0f * 256.0f / TWO_PI);
+          uint32_t angle24 = 0;
           for (unsigned count = 0; count < numSteps; count++) {
             // may want to try float version as well (with or without antialiasing)
-            int x = roundf(sinf(rad) * radius);
-            int y = roundf(cosf(rad) * radius);
+            uint16_t angle = angle24 >> 8;
+            int x = (sin16_t(angle) * i + 16384) >> 15;  // round(sin * radius)
+            int y = (cos16_t(angle) * i + 16384) >> 15;  // round(cos * radius)
             setPixelColorXY(x, y, col);
             if(useSymmetry) setPixelColorXY(y, x, col);// WLEDMM
-            rad += step;
+            angle24 += step24;
           }
 
           // Bresenham’s Algorithm (may not fill every pixel)
@@ -952,8 +1059,8 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) //WLEDMM: IRAM_ATT
       case M12_sCircle: //WLEDMM
         if (vStrip > 0)
         {
-          int x = roundf(sinf(360*i/SEGLEN*DEG_TO_RAD) * vW * (vStrip+1)/nrOfVStrips());
-          int y = roundf(cosf(360*i/SEGLEN*DEG_TO_RAD) * vW * (vStrip+1)/nrOfVStrips());
+          int x, y;
+          xyFromCircle(x, y, i, vW, vStrip, nrOfVStrips());
           setPixelColorXY(x + vW/2, y + vH/2, col);
         }
         else // pArc -> circle
@@ -984,8 +1091,8 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) //WLEDMM: IRAM_ATT
         float centerY = roundf((vH-1) / 2.0f);
         // int maxDistance = sqrt(centerX * centerX + centerY * centerY) + 1;
         float angleRad = (max(vW,vH) > Pinwheel_Size_Medium) ? float(i) * Int_to_Rad_Big : float(i) * Int_to_Rad_Med; // angle in radians
-        float cosVal = cosf(angleRad);
-        float sinVal = sinf(angleRad);
+        float cosVal = cos_t(angleRad);
+        float sinVal = sin_t(angleRad);
 
         // draw line at angle, starting at center and ending at the segment edge
         // we use fixed point math for better speed. Starting distance is 0.5 for better rounding
@@ -1026,39 +1133,13 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) //WLEDMM: IRAM_ATT
 
   if (ledsrgb) ledsrgb[i] = col;
 
-  uint16_t len = length();
   uint8_t _bri_t = currentBri(on ? opacity : 0);
   if (!_bri_t && !transitional && fadeTransition) return; // if _bri_t == 0 && segment is not transitioning && transitions are enabled then save a few CPU cycles
   if (_bri_t < 255) {
     col = color_fade(col, _bri_t);
   }
 
-  // expand pixel (taking into account start, grouping, spacing [and offset])
-  i = i * groupLength();
-  if (reverse) { // is segment reversed?
-    if (mirror) { // is segment mirrored?
-      i = (len - 1) / 2 - i;  //only need to index half the pixels
-    } else {
-      i = (len - 1) - i;
-    }
-  }
-  i += start; // starting pixel in a group
-
-  // set all the pixels in the group
-  for (int j = 0; j < grouping; j++) {
-    uint16_t indexSet = i + ((reverse) ? -j : j);
-    if (indexSet >= start && indexSet < stop) {
-      if (mirror) { //set the corresponding mirrored pixel
-        uint16_t indexMir = stop - indexSet + start - 1;
-        indexMir += offset; // offset/phase
-        if (indexMir >= stop) indexMir -= len; // wrap
-        strip.setPixelColor(indexMir, col);
-      }
-      indexSet += offset; // offset/phase
-      if (indexSet >= stop) indexSet -= len; // wrap
-      strip.setPixelColor(indexSet, col);
-    }
-  }
+  (*_write1D)(*this, i, col); // WLEDMM writer selected by refreshGeometry()
 }
 
 // anti-aliased normalized version of setPixelColor()
@@ -1072,25 +1153,25 @@ void Segment::setPixelColor(float i, uint32_t col, bool aa)
 
   float fC = i * (virtualLength()-1);
   if (aa) {
-    uint16_t iL = roundf(fC-0.49f);
-    uint16_t iR = roundf(fC+0.49f);
+    pixidx_t iL = roundf(fC-0.49f);
+    pixidx_t iR = roundf(fC+0.49f);
     float    dL = (fC - iL)*(fC - iL);
     float    dR = (iR - fC)*(iR - fC);
-    uint32_t cIL = getPixelColor(iL | (vStrip<<16));
-    uint32_t cIR = getPixelColor(iR | (vStrip<<16));
+    uint32_t cIL = getPixelColor(VSTRIP_PACK(iL, vStrip));
+    uint32_t cIR = getPixelColor(VSTRIP_PACK(iR, vStrip));
     if (iR!=iL) {
       // blend L pixel
       cIL = color_blend(col, cIL, uint8_t(dL*255.0f));
-      setPixelColor(iL | (vStrip<<16), cIL);
+      setPixelColor(VSTRIP_PACK(iL, vStrip), cIL);
       // blend R pixel
       cIR = color_blend(col, cIR, uint8_t(dR*255.0f));
-      setPixelColor(iR | (vStrip<<16), cIR);
+      setPixelColor(VSTRIP_PACK(iR, vStrip), cIR);
     } else {
       // exact match (x & y land on a pixel)
-      setPixelColor(iL | (vStrip<<16), col);
+      setPixelColor(VSTRIP_PACK(iL, vStrip), col);
     }
   } else {
-    setPixelColor(uint16_t(roundf(fC)) | (vStrip<<16), col);
+    setPixelColor(VSTRIP_PACK(pixidx_t(roundf(fC)), vStrip), col);
   }
 }
 
@@ -1098,14 +1179,14 @@ uint32_t Segment::getPixelColor(int i)
 {
   if (!isActive()) return 0; // not active
 #ifndef WLED_DISABLE_2D
-  int vStrip = i>>16;
+  int vStrip = VSTRIP_OF(i);
 #endif
-  i &= 0xFFFF;
+  i = VSTRIP_INDEX(i);
 
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
-    uint16_t vH = virtualHeight();  // segment height in logical pixels
-    uint16_t vW = virtualWidth();
+    pixidx_t vH = virtualHeight();  // segment height in logical pixels
+    pixidx_t vW = virtualWidth();
     switch (map1D2D) {
       case M12_Pixels:
         return getPixelColorXY(i % vW, i / vW);
@@ -1126,8 +1207,8 @@ uint32_t Segment::getPixelColor(int i)
       case M12_sCircle: //WLEDMM
         if (vStrip > 0)
         {
-          int x = roundf(sinf(360*i/SEGLEN*DEG_TO_RAD) * vW * (vStrip+1)/nrOfVStrips());
-          int y = roundf(cosf(360*i/SEGLEN*DEG_TO_RAD) * vW * (vStrip+1)/nrOfVStrips());
+          int x, y;
+          xyFromCircle(x, y, i, vW, vStrip, nrOfVStrips());
           return getPixelColorXY(x + vW/2, y + vH/2);
         }
         else
@@ -1149,8 +1230,8 @@ uint32_t Segment::getPixelColor(int i)
         float centerX = (vW - 1) / 2.0f;
         float centerY = (vH - 1) / 2.0f;
         float angleRad = (max(vW,vH) > Pinwheel_Size_Medium) ? float(i) * Int_to_Rad_Big : float(i) * Int_to_Rad_Med; // angle in radians
-        int x = roundf(centerX + distance * cosf(angleRad));
-        int y = roundf(centerY + distance * sinf(angleRad));
+        int x = roundf(centerX + distance * cos_t(angleRad));
+        int y = roundf(centerY + distance * sin_t(angleRad));
         return getPixelColorXY(x, y);
     }
     return 0;
@@ -1169,13 +1250,37 @@ uint32_t Segment::getPixelColor(int i)
   return strip.getPixelColor(i);
 }
 
-uint8_t Segment::differs(Segment& b) const {
+Segment::Snapshot Segment::snapshot() const {
+  Snapshot snap;
+  snap.start     = start;
+  snap.stop      = stop;
+  snap.startY    = startY;
+  snap.stopY     = stopY;
+  snap.offset    = offset;
+  snap.options   = options;
+  snap.grouping  = grouping;
+  snap.spacing   = spacing;
+  snap.opacity   = opacity;
+  snap.renderScale = renderScale;
+  snap.mode      = mode;
+  snap.speed     = speed;
+  snap.intensity = intensity;
+  snap.palette   = palette;
+  snap.custom1   = custom1;
+  snap.custom2   = custom2;
+  snap.custom3   = custom3;
+  for (uint8_t i = 0; i < NUM_COLORS; i++) snap.colors[i] = colors[i];
+  return snap;
+}
+
+uint8_t Segment::differs(const Snapshot& b) const {
   uint8_t d = 0;
   if (start != b.start)         d |= SEG_DIFFERS_BOUNDS;
   if (stop != b.stop)           d |= SEG_DIFFERS_BOUNDS;
   if (offset != b.offset)       d |= SEG_DIFFERS_GSO;
   if (grouping != b.grouping)   d |= SEG_DIFFERS_GSO;
   if (spacing != b.spacing)     d |= SEG_DIFFERS_GSO;
+  if (renderScale != b.renderScale) d |= SEG_DIFFERS_GSO;
   if (opacity != b.opacity)     d |= SEG_DIFFERS_BRI;
   if (mode != b.mode)           d |= SEG_DIFFERS_FX;
   if (speed != b.speed)         d |= SEG_DIFFERS_FX;
@@ -1197,8 +1302,8 @@ uint8_t Segment::differs(Segment& b) const {
 
 void Segment::refreshLightCapabilities() {
   uint8_t capabilities = 0;
-  uint16_t segStartIdx = 0xFFFFU;
-  uint16_t segStopIdx  = 0;
+  pixidx_t segStartIdx = PIXIDX_NONE;
+  pixidx_t segStopIdx  = 0;
 
   if (!isActive()) {
     _capabilities = 0;
@@ -1208,9 +1313,9 @@ void Segment::refreshLightCapabilities() {
   if (start < Segment::maxWidth * Segment::maxHeight) {
     // we are withing 2D matrix (includes 1D segments)
     for (int y = startY; y < stopY; y++) for (int x = start; x < stop; x++) {
-      uint16_t index = x + Segment::maxWidth * y;
+      pixidx_t index = x + Segment::maxWidth * y;
       if (index < strip.customMappingSize) index = strip.customMappingTable[index]; // convert logical address to physical
-      if (index < 0xFFFFU) {
+      if (index < PIXIDX_NONE) {
         if (segStartIdx > index) segStartIdx = index;
         if (segStopIdx  < index) segStopIdx  = index;
       }
@@ -1250,11 +1355,11 @@ void Segment::refreshLightCapabilities() {
  */
 void Segment::fill(uint32_t c) {
   if (!isActive()) return; // not active
-  const uint_fast16_t cols = is2D() ? virtualWidth() : virtualLength();             // WLEDMM use fast int types
-  const uint_fast16_t rows = virtualHeight(); // will be 1 for 1D
-  for(uint_fast16_t y = 0; y < rows; y++) for (uint_fast16_t x = 0; x < cols; x++) {
-    if (is2D()) setPixelColorXY((uint16_t)x, (uint16_t)y, c);
-    else        setPixelColor((uint16_t)x, c);
+  const pixidx_t cols = is2D() ? virtualWidth() : virtualLength();             // WLEDMM pixel index type, may exceed 16 bit
+  const pixidx_t rows = virtualHeight(); // will be 1 for 1D
+  for(pixidx_t y = 0; y < rows; y++) for (pixidx_t x = 0; x < cols; x++) {
+    if (is2D()) setPixelColorXY(int(x), int(y), c);
+    else        setPixelColor(int(x), c);
   }
 }
 
@@ -1294,8 +1399,8 @@ void Segment::fadePixelColor(uint16_t n, uint8_t fade) {
  */
 void Segment::fade_out(uint8_t rate) {
   if (!isActive()) return; // not active
-  const uint_fast16_t cols = is2D() ? virtualWidth() : virtualLength();           // WLEDMM use fast int types
-  const uint_fast16_t rows = virtualHeight(); // will be 1 for 1D
+  const pixidx_t cols = is2D() ? virtualWidth() : virtualLength();           // WLEDMM pixel index type, may exceed 16 bit
+  const pixidx_t rows = virtualHeight(); // will be 1 for 1D
 
   uint_fast8_t fadeRate = (255-rate) >> 1;
   float mappedRate_r = 1.0f / (float(fadeRate) +1.1f); // WLEDMM use reciprocal  1/mappedRate -> faster on non-FPU chips
@@ -1306,8 +1411,8 @@ void Segment::fade_out(uint8_t rate) {
   int g2 = G(color2);
   int b2 = B(color2);
 
-  for (uint_fast16_t y = 0; y < rows; y++) for (uint_fast16_t x = 0; x < cols; x++) {
-    uint32_t color = is2D() ? getPixelColorXY(x, y) : getPixelColor(x);
+  for (pixidx_t y = 0; y < rows; y++) for (pixidx_t x = 0; x < cols; x++) {
+    uint32_t color = is2D() ? getPixelColorXY(int(x), int(y)) : getPixelColor(int(x));
     if (color == color2) continue;  // WLEDMM speedup - pixel color = target color, so nothing to do
     int w1 = W(color);
     int r1 = R(color);
@@ -1326,26 +1431,26 @@ void Segment::fade_out(uint8_t rate) {
     bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
 
     //if ((wdelta == 0) && (rdelta == 0) && (gdelta == 0) && (bdelta == 0)) continue; // WLEDMM delta = zero => no change // causes problem with text overlay
-    if (is2D()) setPixelColorXY((uint16_t)x, (uint16_t)y, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
-    else        setPixelColor((uint16_t)x, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    if (is2D()) setPixelColorXY(int(x), int(y), r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    else        setPixelColor(int(x), r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
   }
 }
 
 // fades all pixels to black using nscale8()
 void Segment::fadeToBlackBy(uint8_t fadeBy) {
   if (!isActive() || fadeBy == 0) return;   // optimization - no scaling to apply
-  const uint_fast16_t cols = is2D() ? virtualWidth() : virtualLength();      // WLEDMM use fast int types
-  const uint_fast16_t rows = virtualHeight(); // will be 1 for 1D
+  const pixidx_t cols = is2D() ? virtualWidth() : virtualLength();      // WLEDMM pixel index type, may exceed 16 bit
+  const pixidx_t rows = virtualHeight(); // will be 1 for 1D
   const uint_fast8_t scaledown = 255-fadeBy;  // WLEDMM faster to pre-compute this
 
   // WLEDMM minor optimization
   if(is2D()) {
-    for (uint_fast16_t y = 0; y < rows; y++) for (uint_fast16_t x = 0; x < cols; x++) {
-      setPixelColorXY((uint16_t)x, (uint16_t)y, CRGB(getPixelColorXY(x,y)).nscale8(scaledown));
+    for (pixidx_t y = 0; y < rows; y++) for (pixidx_t x = 0; x < cols; x++) {
+      setPixelColorXY(int(x), int(y), CRGB(getPixelColorXY(int(x), int(y))).nscale8(scaledown));
     }
   } else {
-    for (uint_fast16_t x = 0; x < cols; x++) {
-      setPixelColor((uint16_t)x, CRGB(getPixelColor((uint16_t)x)).nscale8(scaledown));
+    for (pixidx_t x = 0; x < cols; x++) {
+      setPixelColor(int(x), CRGB(getPixelColor(int(x))).nscale8(scaledown));
     }
   }
 }
@@ -1558,7 +1663,7 @@ void WS2812FX::enumerateLedmaps() {
             memset(dim, 0, sizeof(dim)); // clear buffer before reading
             f.readBytesUntil('\n', dim, sizeof(dim)-1);
             uint16_t maxHeight = atoi(cleanUpName(dim));
-            ledmapMaxSize = MAX(ledmapMaxSize, maxWidth * maxHeight);
+            ledmapMaxSize = MAX(ledmapMaxSize, size_t(maxWidth) * maxHeight);
 
             if (maxWidth*maxHeight>0) {
               USER_PRINTF(" (%dx%d -> %d)\n", maxWidth, maxHeight, ledmapMaxSize);
@@ -1634,7 +1739,7 @@ void WS2812FX::finalizeInit(void)
     _hasWhiteChannel |= bus->hasWhite();
     //refresh is required to remain off if at least one of the strips requires the refresh.
     _isOffRefreshRequired |= bus->isOffRefreshRequired();
-    uint16_t busEnd = bus->getStart() + bus->getLength();
+    pixidx_t busEnd = bus->getStart() + bus->getLength();
     if (busEnd > _length) _length = busEnd;
     #ifdef ESP8266
     if ((!IS_DIGITAL(bus->getType()) || IS_2PIN(bus->getType()))) continue;
@@ -1670,9 +1775,26 @@ void WS2812FX::finalizeInit(void)
     if ((Segment::_globalLeds == nullptr) && (arrSize > 0)) errorFlag = ERR_LOW_MEM; // WLEDMM raise errorflag
   }
 
+  #if defined(WLED_DEBUG) && defined(WLED_HAVE_EXPANDED_PALETTES)
+  // WLEDMM verify build-time palettes against FastLED
+  for (size_t p = 0; p < WLED_EXPANDED_PALETTE_COUNT; p++) {
+    byte tcp[76] = { 255 };
+    CRGBPalette16 runtimePal;
+    memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[p])), 72);
+    runtimePal.loadDynamicGradientPalette(tcp);
+    if (memcmp_P(runtimePal.entries, gExpandedPalettes[p], sizeof(runtimePal.entries)) != 0) DEBUG_PRINTF("Expanded palette %d differs from FastLED!\n", int(p+13));
+  }
+  #endif
+
   //segments are created in makeAutoSegments();
   DEBUG_PRINTLN(F("Loading custom palettes"));
+  #ifdef WLED_DEBUG
+  unsigned long palStart = micros();
+  #endif
   loadCustomPalettes(); // (re)load all custom palettes
+  #ifdef WLED_DEBUG
+  DEBUG_PRINTF("Custom palettes loaded in %lu us\n", micros() - palStart);
+  #endif
   DEBUG_PRINTLN(F("Loading custom ledmaps"));
   deserializeMap();     // (re)load default ledmap
   _isServicing = false;        // WLEDMM
@@ -1723,11 +1845,13 @@ void WS2812FX::service() {
     if(nowUp >= seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))  // WLEDMM ">=" instead of ">"
     {
       if (seg.grouping == 0) seg.grouping = 1; //sanity check
+      seg.refreshGeometry(); // WLEDMM once per frame - catches direct changes to bounds/options (usermods, JSON, UDP sync)
       doShow = true;
       uint16_t frameDelay = FRAMETIME;    // WLEDMM avoid name clash with "delay" function
 
       if (!seg.freeze) { //only run effect function if not frozen
-        _virtualSegmentLength = seg.virtualLength();
+        unsigned long renderStart = micros(); // WLEDMM render cost for governQuality()
+        _virtualSegmentLength = min(seg.virtualLength(), pixidx_t(UINT16_MAX)); // WLEDMM effects use 16bit loop counters
         _colors_t[0] = seg.currentColor(0, seg.colors[0]);
         _colors_t[1] = seg.currentColor(1, seg.colors[1]);
         _colors_t[2] = seg.currentColor(2, seg.colors[2]);
@@ -1739,7 +1863,14 @@ void WS2812FX::service() {
         // effect blending (execute previous effect)
         // actual code may be a bit more involved as effects have runtime data including allocated memory
         //if (seg.transitional && seg._modeP) (*_mode[seg._modeP])(progress());
-        frameDelay = (*_mode[seg.currentMode(seg.mode)])();
+        uint8_t fxId = seg.currentMode(seg.mode);
+        if (fxId < _modeCtx.size() && _modeCtx[fxId]) { // WLEDMM effect takes explicit render context
+          RenderContext ctx(seg, _virtualSegmentLength, _colors_t, _currentPalette, now);
+          frameDelay = (*_modeCtx[fxId])(ctx);
+        } else
+          frameDelay = (*_mode[fxId])(); // legacy effect, uses SEGMENT/SEGLEN/SEGCOLOR
+        if (seg.is2D() && seg.blockSize() > seg.grouping) seg.upscaleRender(); // WLEDMM effect drew at reduced resolution (render scale)
+        seg.trackRenderCost(micros() - renderStart);
         if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
         if (seg.transitional && frameDelay > FRAMETIME) frameDelay = FRAMETIME; // force faster updates during transition
 
@@ -1752,7 +1883,12 @@ void WS2812FX::service() {
   }
   _virtualSegmentLength = 0;
   busses.setSegmentCCT(-1);
+#ifndef WLED_DISABLE_2D
+  releasePolarMaps(); // WLEDMM free maps no longer used by any effect
+  releaseImagePlayers(); // WLEDMM close images no longer played
+#endif
   if(doShow) {
+    governQuality(); // WLEDMM
     yield();
     show();
   }
@@ -1760,6 +1896,37 @@ void WS2812FX::service() {
   _isServicing = false;
 }
 
+// WLEDMM adaptive quality governor: keeps the summed effect render time of all segments within the frame budget.
+// Over budget, the most expensive segment whose effect opted in (see Segment::qualityScaled()) is lowered by one level.
+// A segment only gets a level back if the cost measured at that level would fit into 3/4 of the budget, so a segment
+// that is just too expensive at the lower level does not flip back and forth. The hold time gives the smoothed render cost time to settle.
+#define QUALITY_HOLD_FRAMES   16
+#define QUALITY_MIN_FRAMETIME 20  // ms; effects are not degraded just to run faster than 50 fps
+void WS2812FX::governQuality(void) {
+  if (!adaptiveQuality) { // switched off: give all segments their full quality back
+    for (segment &seg : _segments) if (seg.qualityLevel() > 0) seg.setQualityLevel(0);
+    return;
+  }
+  if (_governorHold > 0) { _governorHold--; return; }
+  const uint32_t budget = uint32_t(max(_frametime, uint16_t(QUALITY_MIN_FRAMETIME))) * 800; // us; leave ~20% of the frame for show()
+  uint32_t total = 0;
+  Segment *costliest = nullptr, *cheapest = nullptr;
+  for (segment &seg : _segments) {
+    if (!seg.isActive() || seg.freeze) continue;
+    total += seg.renderCost();
+    if (!seg.qualityAware()) continue;
+    if (seg.qualityLevel() < 3 && (!costliest || seg.renderCost() > costliest->renderCost())) costliest = &seg;
+    if (seg.qualityLevel() > 0 && (!cheapest  || seg.levelCost(seg.qualityLevel()-1) < cheapest->levelCost(cheapest->qualityLevel()-1))) cheapest = &seg;
+  }
+  if (total > budget && costliest) {
+    costliest->setQualityLevel(costliest->qualityLevel() + 1);
+    _governorHold = QUALITY_HOLD_FRAMES;
+  } else if (cheapest && total - cheapest->renderCost() + cheapest->levelCost(cheapest->qualityLevel()-1) < budget*3/4) {
+    cheapest->setQualityLevel(cheapest->qualityLevel() - 1);
+    _governorHold = 4 * QUALITY_HOLD_FRAMES;
+  }
+}
+
 void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
 {
   if (i < customMappingSize) i = customMappingTable[i];
@@ -1767,7 +1934,7 @@ void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
   busses.setPixelColor(i, col);
 }
 
-uint32_t WS2812FX::getPixelColor(uint_fast16_t i) // WLEDMM fast int types
+uint32_t WS2812FX::getPixelColor(pixidx_t i)
 {
   if (i < customMappingSize) i = customMappingTable[i];
   if (i >= _length) return 0;
@@ -1801,6 +1968,7 @@ void WS2812FX::estimateCurrentAndLimitBri() {
 
   if (ablMilliampsMax < 150 || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
     currentMilliamps = 0;
+    Bus::setPowerTracking(false);  // WLEDMM no per-pixel power bookkeeping while ABL is off
     busses.setBrightness(_brightness);
     return;
   }
@@ -1814,28 +1982,24 @@ void WS2812FX::estimateCurrentAndLimitBri() {
     powerBudget = 0;
   }
 
+  Bus::setPowerTracking(true);                   // WLEDMM shadows are rebuilt from the bus once after re-enabling
+  Bus::setPowerModel(useWackyWS2815PowerModel);  // WLEDMM digital busses track their power units while pixels are set
   uint32_t powerSum = 0;
+  uint32_t busSum[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {0};   // WLEDMM power per bus ...
+  uint32_t busPeak[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {0};  // ... and of its busiest injection group
+  bool busBudgets = false;
 
   for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
     Bus *bus = busses.getBus(bNum);
     if (bus->getType() >= TYPE_NET_DDP_RGB) continue; //exclude non-physical network busses
-    uint16_t len = bus->getLength();
-    uint32_t busPowerSum = 0;
-    for (uint_fast16_t i = 0; i < len; i++) { //sum up the usage of each LED
-      uint32_t c = bus->getPixelColor(i);
-      byte r = R(c), g = G(c), b = B(c), w = W(c);
-
-      if(useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-        busPowerSum += (max(max(r,g),b)) * 3; // WLEDMM use native min/max
-      } else {
-        busPowerSum += (r + g + b + w);
-      }
-    }
+    uint32_t busPowerSum = bus->getPowerSum(&busPeak[bNum]);
 
     if (bus->hasWhite()) { //RGBW led total output with white LEDs enabled is still 50mA, so each channel uses less
-      busPowerSum *= 3;
-      busPowerSum = busPowerSum >> 2; //same as /= 4
+      busPowerSum = (busPowerSum * 3) >> 2; //same as *3/4
+      busPeak[bNum] = (busPeak[bNum] * 3) >> 2;
     }
+    busSum[bNum] = busPowerSum;
+    if (bus->getMaxCurrent()) busBudgets = true;
     powerSum += busPowerSum;
   }
 
@@ -1843,11 +2007,12 @@ void WS2812FX::estimateCurrentAndLimitBri() {
   //powerSum *= _brightness; // for NPBrightnessBus
   powerSum *= 255;           // no need to scale down powerSum - NPB-LG getPixelColor returns colors scaled down by brightness
 
+  uint8_t scaleB = 255;
   if (powerSum > powerBudget) //scale brightness down to stay in current limit
   {
     float scale = (float)powerBudget / (float)powerSum;
     uint16_t scaleI = scale * 255;
-    uint8_t scaleB = (scaleI > 255) ? 255 : scaleI;
+    scaleB = (scaleI > 255) ? 255 : scaleI;
     uint8_t newBri = scale8(_brightness, scaleB);
     // to keep brightness uniform, sets virtual busses too - softhack007: apply reductions immediately
     if (scaleB < 255) busses.setBrightness(scaleB, true); // NPB-LG has already applied brightness, so its sufficient to post-apply scaling ==> use scaleB instead of newBri
@@ -1858,6 +2023,24 @@ void WS2812FX::estimateCurrentAndLimitBri() {
     currentMilliamps = powerSum / puPerMilliamp;
     busses.setBrightness(_brightness, false);            // set new brightness for next frame
   }
+
+  // WLEDMM busses (or each of their power injection groups) with an own current budget are limited further
+  if (busBudgets) {
+    for (uint_fast8_t bNum = 0; bNum < busses.getNumBusses(); bNum++) {
+      Bus *bus = busses.getBus(bNum);
+      if (bus->getType() >= TYPE_NET_DDP_RGB || !bus->getMaxCurrent() || !busPeak[bNum]) continue;
+      uint16_t groupLen = bus->getInjectLength() ? bus->getInjectLength() : bus->getLength();
+      uint32_t budget = bus->getMaxCurrent() * puPerMilliamp;
+      budget = (budget > puPerMilliamp * groupLen) ? budget - puPerMilliamp * groupLen : 0; // standby current
+      float scale = (float)budget / ((float)busPeak[bNum] * 255.0f);
+      if (scale * 255.0f >= scaleB) continue;           // global limit is already lower
+      uint8_t busScale = scale * 255.0f;
+      // the global limit (scaleB) has already been post-applied to this bus, so only apply what is still missing
+      bus->setBrightness((uint16_t(busScale) * 255) / scaleB, true);
+      bus->setBrightness(scale8(_brightness, busScale), false);
+      currentMilliamps -= (busSum[bNum] * (scaleB - busScale)) / puPerMilliamp;
+    }
+  }
   currentMilliamps += MA_FOR_ESP; //add power of ESP back to estimate
   currentMilliamps += pLen; //add standby power back to estimate
 }
@@ -1869,7 +2052,9 @@ void WS2812FX::show(void) {
   show_callback callback = _callback;
   if (callback) callback();
 
+  unsigned long ablStart = micros(); // WLEDMM
   estimateCurrentAndLimitBri();
+  _ablUs = (uint32_t(_ablUs) * 7 + min(micros() - ablStart, 65535UL)) >> 3;
 
   #if defined(ARDUINO_ARCH_ESP32) && defined(WLEDMM_FASTPATH)
   unsigned long b4show = millis(); // WLEDMM the time before calling "show"
@@ -2019,14 +2204,14 @@ uint8_t WS2812FX::getActiveSegmentsNum(void) {
   return c;
 }
 
-uint16_t WS2812FX::getLengthTotal(void) {  // WLEDMM fast int types
-  uint_fast16_t len = Segment::maxWidth * Segment::maxHeight; // will be _length for 1D (see finalizeInit()) but should cover whole matrix for 2D
+pixidx_t WS2812FX::getLengthTotal(void) {  // WLEDMM fast int types
+  size_t len = Segment::maxWidth * Segment::maxHeight; // will be _length for 1D (see finalizeInit()) but should cover whole matrix for 2D
   if (isMatrix && _length > len) len = _length; // for 2D with trailing strip
   return len;
 }
 
-uint16_t WS2812FX::getLengthPhysical(void) {  // WLEDMM fast int types
-  uint_fast16_t len = 0;
+pixidx_t WS2812FX::getLengthPhysical(void) {  // WLEDMM fast int types
+  size_t len = 0;
   for (unsigned b = 0; b < busses.getNumBusses(); b++) {   //  WLEDMM use native (fast) types
     Bus *bus = busses.getBus(b);
     if (bus->getType() >= TYPE_NET_DDP_RGB) continue; //exclude non-physical network busses
@@ -2082,7 +2267,7 @@ Segment& WS2812FX::getSegment(uint8_t id) {
   return _segments[id >= _segments.size() ? mainSegID : id]; // vectors
 }
 
-void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping, uint8_t spacing, uint16_t offset, uint16_t startY, uint16_t stopY) {
+void WS2812FX::setSegment(uint8_t n, pixidx_t i1, pixidx_t i2, uint8_t grouping, uint8_t spacing, uint16_t offset, uint16_t startY, uint16_t stopY) {
   if (n >= _segments.size()) return;
   _segments[n].setUp(i1, i2, grouping, spacing, offset, startY, stopY);
 }
@@ -2113,6 +2298,7 @@ void WS2812FX::resetSegments(bool boundsOnly) { //WLEDMM add boundsonly
       seg.start = 0;
       seg.stop = _length;
       #endif
+      seg.refreshGeometry(); // WLEDMM
       seg.allocLeds();
     }
   }
@@ -2120,8 +2306,8 @@ void WS2812FX::resetSegments(bool boundsOnly) { //WLEDMM add boundsonly
 
 void WS2812FX::makeAutoSegments(bool forceReset) {
   if (autoSegments) { //make one segment per bus
-    uint16_t segStarts[MAX_NUM_SEGMENTS] = {0};
-    uint16_t segStops [MAX_NUM_SEGMENTS] = {0};
+    pixidx_t segStarts[MAX_NUM_SEGMENTS] = {0};
+    pixidx_t segStops [MAX_NUM_SEGMENTS] = {0};
     size_t s = 0;
 
     #ifndef WLED_DISABLE_2D
@@ -2214,8 +2400,10 @@ void WS2812FX::fixInvalidSegments() {
     }
   }
   // this is always called as the last step after finalizeInit(), update covered bus types
-  for (segment &seg : _segments)
+  for (segment &seg : _segments) {
+    seg.refreshGeometry(); // WLEDMM bounds may have been changed above, or by makeAutoSegments()
     seg.refreshLightCapabilities();
+  }
 }
 
 //true if all segments align with a bus, or if a segment covers the total length
@@ -2240,19 +2428,18 @@ uint8_t WS2812FX::setPixelSegment(uint8_t n) {
   uint8_t prevSegId = _segment_index;
   if (n < _segments.size()) {
     _segment_index = n;
-    _virtualSegmentLength = _segments[_segment_index].virtualLength();
+    _virtualSegmentLength = min(_segments[_segment_index].virtualLength(), pixidx_t(UINT16_MAX)); // WLEDMM effects use 16bit loop counters
   }
   return prevSegId;
 }
 
-void WS2812FX::setRange(uint16_t i, uint16_t i2, uint32_t col) {
-  if (i2 >= i)
-  {
-    for (uint_fast16_t x = i; x <= i2; x++) setPixelColor((uint16_t)x, col);    //  WLEDMM use fast int types
-  } else
-  {
-    for (uint_fast16_t x = i2; x <= i; x++) setPixelColor((uint16_t)x, col);
+void WS2812FX::setRange(pixidx_t i, pixidx_t i2, uint32_t col) {
+  if (i2 < i) std::swap(i, i2);
+  if (i >= customMappingSize && i < _length) { // WLEDMM no ledmap in this range: fill per bus
+    busses.setPixelColors(i, min(pixidx_t(i2 + 1), _length) - i, col);
+    return;
   }
+  for (uint32_t x = i; x <= i2; x++) setPixelColor(int(x), col);    //  WLEDMM 32 bit counter, i2 may be the largest pixidx_t
 }
 
 void WS2812FX::setTransitionMode(bool t) {
@@ -2265,26 +2452,125 @@ void WS2812FX::printSize() {
   for (const Segment &seg : _segments) size += seg.getSize();
   DEBUG_PRINTF("Segments: %d -> %uB\n", _segments.size(), size);
   DEBUG_PRINTF("Modes: %d*%d=%uB\n", sizeof(mode_ptr), _mode.size(), (_mode.capacity()*sizeof(mode_ptr)));
+  DEBUG_PRINTF("Modes (ctx): %d*%d=%uB\n", sizeof(mode_ctx_ptr), _modeCtx.size(), (_modeCtx.capacity()*sizeof(mode_ctx_ptr)));
   DEBUG_PRINTF("Data: %d*%d=%uB\n", sizeof(const char *), _modeData.size(), (_modeData.capacity()*sizeof(const char *)));
-  DEBUG_PRINTF("Map: %d*%d=%uB\n", sizeof(uint16_t), (int)customMappingSize, customMappingSize*sizeof(uint16_t));
+  DEBUG_PRINTF("Meta: %d*%d=%uB\n", sizeof(mode_meta_t), _modeMeta.size(), (_modeMeta.capacity()*sizeof(mode_meta_t))); // WLEDMM
+  DEBUG_PRINTF("Map: %d*%d=%uB\n", sizeof(pixidx_t), (int)customMappingSize, customMappingSize*sizeof(pixidx_t));
   size = getLengthTotal();
   if (useLedsArray) DEBUG_PRINTF("Buffer: %d*%u=%uB\n", sizeof(CRGB), size, size*sizeof(CRGB));
 }
 #endif
 
+// WLEDMM binary custom palettes: "/paletteN.bin" is loaded with a single read, "/paletteN.json" is converted on first use.
+// format: 'W','P', version (2), number of stops n (2..18), size (32 bit LE) and crc16 (LE) of the JSON it was made from
+// (0 = no JSON source), then n * {index, R, G, B} - like the JSON, without gamma correction.
+// The JSON is the master copy: a .bin that doesn't match it (JSON changed in /edit, failed write, removed JSON) is rebuilt or dropped.
+#define CUSTOM_PALETTE_BIN_VERSION 2
+#define CUSTOM_PALETTE_BIN_HEADER  10
+#define CUSTOM_PALETTE_MAX_STOPS   18
+
+typedef struct PaletteSource {
+  uint32_t size;
+  uint16_t crc;
+} palette_src_t;
+
+// size and checksum of the JSON file (all zero if it does not exist); reading is much cheaper than parsing
+static palette_src_t paletteSource(const char *fileName) {
+  palette_src_t src = {0, 0};
+  File f = WLED_FS.open(fileName, "r");
+  if (!f) return src;
+  byte chunk[128];
+  uint16_t crc = 0xFFFF;
+  size_t len;
+  while ((len = f.read(chunk, sizeof(chunk))) > 0) {
+    crc = crc16(chunk, len, crc);
+    src.size += len;
+  }
+  f.close();
+  src.crc = crc;
+  return src;
+}
+
+static size_t readBinaryPalette(const char *fileName, byte *tcp, palette_src_t &src) {
+  byte buf[CUSTOM_PALETTE_BIN_HEADER + CUSTOM_PALETTE_MAX_STOPS*4];
+  File f = WLED_FS.open(fileName, "r");
+  if (!f) return 0;
+  size_t len = f.read(buf, sizeof(buf));
+  f.close();
+  size_t stops = buf[3];
+  if (len < CUSTOM_PALETTE_BIN_HEADER || buf[0] != 'W' || buf[1] != 'P' || buf[2] != CUSTOM_PALETTE_BIN_VERSION
+      || stops < 2 || stops > CUSTOM_PALETTE_MAX_STOPS || len != CUSTOM_PALETTE_BIN_HEADER + stops*4
+      || buf[CUSTOM_PALETTE_BIN_HEADER + (stops-1)*4] != 255) {
+    DEBUG_PRINT(F("Invalid binary palette ")); DEBUG_PRINTLN(fileName);
+    return 0;
+  }
+  src.size = buf[4] | (buf[5] << 8) | (buf[6] << 16) | (uint32_t(buf[7]) << 24);
+  src.crc  = buf[8] | (buf[9] << 8);
+  memcpy(tcp, buf+CUSTOM_PALETTE_BIN_HEADER, stops*4);
+  return stops;
+}
+
+// written to a temporary file first, so a failed write never leaves a truncated .bin behind
+static void writeBinaryPalette(const char *fileName, const byte *tcp, size_t stops, const palette_src_t &src) {
+  byte buf[CUSTOM_PALETTE_BIN_HEADER + CUSTOM_PALETTE_MAX_STOPS*4] = {'W', 'P', CUSTOM_PALETTE_BIN_VERSION, (byte)stops,
+    byte(src.size), byte(src.size >> 8), byte(src.size >> 16), byte(src.size >> 24), byte(src.crc), byte(src.crc >> 8)};
+  memcpy(buf+CUSTOM_PALETTE_BIN_HEADER, tcp, stops*4);
+  const char *tmpName = "/palette.tmp";
+  File f = WLED_FS.open(tmpName, "w");
+  if (!f) return;
+  size_t len = CUSTOM_PALETTE_BIN_HEADER + stops*4;
+  bool ok = (f.write(buf, len) == len);
+  f.close();
+  if (ok) {
+    if (WLED_FS.exists(fileName)) WLED_FS.remove(fileName);
+    ok = WLED_FS.rename(tmpName, fileName);
+  }
+  if (!ok) { WLED_FS.remove(tmpName); DEBUG_PRINT(F("Could not write ")); DEBUG_PRINTLN(fileName); }
+}
+
+void WS2812FX::removeCustomPaletteBin(const char *jsonFileName) {
+  // "/paletteN.json" -> "/paletteN.bin"
+  char fileName[32];
+  strlcpy(fileName, jsonFileName, sizeof(fileName));
+  char *ext = strrchr(fileName, '.');
+  if (ext == nullptr || strcmp_P(ext, PSTR(".json")) != 0) return;
+  strcpy_P(ext, PSTR(".bin"));
+  if (WLED_FS.exists(fileName)) WLED_FS.remove(fileName);
+}
+
 void WS2812FX::loadCustomPalettes() {
-  byte tcp[72]; //support gradient palettes with up to 18 entries
+  byte tcp[CUSTOM_PALETTE_MAX_STOPS*4]; //support gradient palettes with up to 18 entries
   CRGBPalette16 targetPalette;
   customPalettes.clear(); // start fresh
   for (int index = 0; index<10; index++) {
     char fileName[32];
+    char binFileName[32];
     sprintf_P(fileName, PSTR("/palette%d.json"), index);
+    sprintf_P(binFileName, PSTR("/palette%d.bin"), index);
+    size_t stops = 0;
+    bool hasJson = WLED_FS.exists(fileName);
+    palette_src_t jsonSrc = {0, 0};
+    if (hasJson) jsonSrc = paletteSource(fileName);
+
+    if (WLED_FS.exists(binFileName)) {
+      DEBUG_PRINT(F("Reading palette from "));
+      DEBUG_PRINTLN(binFileName);
+      palette_src_t binSrc;
+      stops = readBinaryPalette(binFileName, tcp, binSrc);
+      // made from a different JSON (or from one that is gone): outdated. A .bin without JSON source stands on its own.
+      bool stale = hasJson ? (binSrc.size != jsonSrc.size || binSrc.crc != jsonSrc.crc) : (binSrc.size != 0);
+      if (stops > 0 && stale) {
+        DEBUG_PRINTLN(F("Binary palette is outdated."));
+        stops = 0;
+        if (!hasJson) WLED_FS.remove(binFileName);
+      }
+    }
 
-    StaticJsonDocument<1536> pDoc; // barely enough to fit 72 numbers
-    if (WLED_FS.exists(fileName)) {
+    if (stops == 0 && hasJson) {
       DEBUG_PRINT(F("Reading palette from "));
       DEBUG_PRINTLN(fileName);
 
+      StaticJsonDocument<1536> pDoc; // barely enough to fit 72 numbers
       if (readObjectFromFile(fileName, nullptr, &pDoc)) {
         JsonArray pal = pDoc[F("palette")];
         if (!pal.isNull() && pal.size()>3) { // not an empty palette (at least 2 entries)
@@ -2296,28 +2582,40 @@ void WS2812FX::loadCustomPalettes() {
               uint8_t rgbw[] = {0,0,0,0};
               tcp[ j ] = (uint8_t) pal[ i ].as<int>(); // index
               colorFromHexString(rgbw, pal[i+1].as<const char *>()); // will catch non-string entires
-              for (unsigned c=0; c<3; c++) tcp[j+1+c] = gamma8(rgbw[c]); // only use RGB component
+              for (unsigned c=0; c<3; c++) tcp[j+1+c] = rgbw[c]; // only use RGB component
               DEBUG_PRINTF("%d(%d) : %d %d %d\n", i, int(tcp[j]), int(tcp[j+1]), int(tcp[j+2]), int(tcp[j+3]));
+              stops++;
             }
           } else {
             size_t palSize = min(pal.size(), (size_t)72);    // WLEDMM use native min/max
             palSize -= palSize % 4; // make sure size is multiple of 4
             for (size_t i=0; i<palSize && pal[i].as<int>()<256; i+=4) {
               tcp[ i ] = (uint8_t) pal[ i ].as<int>(); // index
-              tcp[i+1] = gamma8((uint8_t) pal[i+1].as<int>()); // R
-              tcp[i+2] = gamma8((uint8_t) pal[i+2].as<int>()); // G
-              tcp[i+3] = gamma8((uint8_t) pal[i+3].as<int>()); // B
+              tcp[i+1] = (uint8_t) pal[i+1].as<int>(); // R
+              tcp[i+2] = (uint8_t) pal[i+2].as<int>(); // G
+              tcp[i+3] = (uint8_t) pal[i+3].as<int>(); // B
               DEBUG_PRINTF("%d(%d) : %d %d %d\n", i, int(tcp[i]), int(tcp[i+1]), int(tcp[i+2]), int(tcp[i+3]));
+              stops++;
             }
           }
-          customPalettes.push_back(targetPalette.loadDynamicGradientPalette(tcp));
+          // WLEDMM cache as binary palette, if it is complete (last index is 255)
+          if (stops >= 2 && tcp[(stops-1)*4] == 255) writeBinaryPalette(binFileName, tcp, stops, jsonSrc);
         } else {
           DEBUG_PRINTLN(F("Wrong palette format."));
         }
       }
-    } else {
+    } else if (stops == 0) {
       break;
     }
+
+    if (stops > 0) {
+      for (size_t i = 0; i < stops*4; i += 4) { // WLEDMM gamma correction is applied at load time, so the binary file stays valid when gamma settings change
+        tcp[i+1] = gamma8(tcp[i+1]);
+        tcp[i+2] = gamma8(tcp[i+2]);
+        tcp[i+3] = gamma8(tcp[i+3]);
+      }
+      customPalettes.push_back(targetPalette.loadDynamicGradientPalette(tcp));
+    }
   }
 }
 
@@ -2410,11 +2708,11 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 
     // don't use new / delete
     if ((size > 0) && (customMappingTable != nullptr)) {
-      customMappingTable = (uint16_t*) reallocf(customMappingTable, sizeof(uint16_t) * size);  // reallocf will free memory if it cannot resize
+      customMappingTable = (pixidx_t*) reallocf(customMappingTable, sizeof(pixidx_t) * size);  // reallocf will free memory if it cannot resize
     }
     if ((size > 0) && (customMappingTable == nullptr)) { // second try
       DEBUG_PRINTLN("deserializeMap: trying to get fresh memory block.");
-      customMappingTable = (uint16_t*) calloc(size, sizeof(uint16_t));
+      customMappingTable = (pixidx_t*) calloc(size, sizeof(pixidx_t));
       if (customMappingTable == nullptr) { 
         DEBUG_PRINTLN("deserializeMap: alloc failed!");
         errorFlag = ERR_LOW_MEM; // WLEDMM raise errorflag
@@ -2426,16 +2724,16 @@ bool WS2812FX::deserializeMap(uint8_t n) {
   if (customMappingTable != nullptr) {
     customMappingSize  = Segment::maxWidth * Segment::maxHeight;
     // WLEDMM reset mapping table before loading
-    //memset(customMappingTable, 0xFF, customMappingTableSize * sizeof(uint16_t)); // FFFF = no pixel
+    //memset(customMappingTable, 0xFF, customMappingTableSize * sizeof(pixidx_t)); // FFFF = no pixel
     for (unsigned i=0; i<customMappingTableSize; i++) customMappingTable[i]=i;     // "neutral" 1:1 mapping
 
     //WLEDMM: find the map values
     f.find("\"map\":[");
-    uint16_t i=0;
+    size_t i=0;
     do { //for each element in the array
-      int mapi = f.readStringUntil(',').toInt();
+      long mapi = f.readStringUntil(',').toInt();
       // USER_PRINTF(", %d(%d)", mapi, i);
-      if (i < customMappingSize) customMappingTable[i++] = (uint16_t) (mapi<0 ? 0xFFFFU : mapi);  // WLEDMM do not write past array bounds
+      if (i < customMappingSize) customMappingTable[i++] = (mapi<0 ? PIXIDX_NONE : pixidx_t(mapi));  // WLEDMM do not write past array bounds
     } while (f.available());
 
     loadedLedmap = n;
@@ -2443,7 +2741,7 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 
     USER_PRINTF("Custom ledmap: %d size=%d\n", loadedLedmap, customMappingSize);
     #ifdef WLED_DEBUG_MAPS
-      for (uint16_t j=0; j<customMappingSize; j++) { // fixing a minor warning: declaration of 'i' shadows a previous local
+      for (size_t j=0; j<customMappingSize; j++) { // fixing a minor warning: declaration of 'i' shadows a previous local
         if (!(j%Segment::maxWidth)) DEBUG_PRINTLN();
         DEBUG_PRINTF("%4d,", customMappingTable[j]);
       }
@@ -2460,6 +2758,26 @@ bool WS2812FX::deserializeMap(uint8_t n) {
 }
 
 
+///////////////////////////////////////////////////////////
+// WLEDMM ParticleSystem
+///////////////////////////////////////////////////////////
+
+void ParticleSystem::render(Segment &seg, uint32_t (*color)(const ps_particle_t &p), int vStrip, uint16_t maxUsed) const {
+  const uint16_t n = min(count, maxUsed);
+  const bool is2D = maxY > PS_ONE;
+  const int stripBits = (vStrip >= 0) ? VSTRIP_PACK(0, vStrip + 1) : 0; // see indexToVStrip() in FX.cpp
+  for (size_t i = 0; i < n; i++) {
+    const ps_particle_t &p = particles[i];
+    if (p.state == PS_STATE_FREE || p.x < 0 || p.x >= maxX) continue;
+    if (is2D) {
+      if (p.y < 0 || p.y >= maxY) continue;
+      seg.setPixelColorXY(int(p.x >> PS_SHIFT), int(p.y >> PS_SHIFT), color(p));
+    } else
+      seg.setPixelColor(int(p.x >> PS_SHIFT) | stripBits, color(p));
+  }
+}
+
+
 WS2812FX* WS2812FX::instance = nullptr;
 
 const char JSON_mode_names[] PROGMEM = R"=====(["FX names moved"])=====";
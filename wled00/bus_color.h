@@ -0,0 +1,43 @@
+#ifndef BUS_COLOR_H
+#define BUS_COLOR_H
+
+/*
+ * WLEDMM per-pixel color helpers of the busses that are resolved once instead of for every pixel:
+ * the color order plan (ColorOrderMap entries clipped to one bus) and an exact x/255 without division.
+ * Plain C++ without Arduino dependencies, tested on the host against the old code (see test/test_bus_color).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+// x/255 for x <= 255*255 (product of two 8 bit values), exact
+static inline uint_fast16_t div255(uint_fast16_t x) {
+  return (x + 1 + (x >> 8)) >> 8;
+}
+
+// color order map entry clipped to a bus, in physical bus index (incl. skipped LEDs)
+struct ColorOrderRange { uint16_t start, end; uint8_t colorOrder; };
+
+// resolves the color order map for a bus covering physical pixels [busStart, busStart+busLen), keeping the map order
+// (first match wins, like ColorOrderMap::getPixelColorOrder()); swapW is ORed into each mapped order.
+// MAP needs count() and get(i) returning entries with start, len and colorOrder. Returns the number of ranges.
+template <class MAP>
+uint8_t buildColorOrderPlan(const MAP &map, size_t busStart, size_t busLen, uint8_t swapW, ColorOrderRange *plan, uint8_t maxRanges) {
+  uint8_t n = 0;
+  for (uint_fast8_t i = 0; i < map.count() && n < maxRanges; i++) {
+    const auto *m = map.get(i);
+    size_t from = size_t(m->start) > busStart ? size_t(m->start) : busStart;
+    size_t to   = size_t(m->start) + m->len < busStart + busLen ? size_t(m->start) + m->len : busStart + busLen;
+    if (from >= to) continue;
+    plan[n++] = {uint16_t(from - busStart), uint16_t(to - busStart), uint8_t(m->colorOrder | swapW)};
+  }
+  return n;
+}
+
+static inline uint8_t colorOrderInPlan(const ColorOrderRange *plan, uint8_t count, uint16_t pix, uint8_t defaultColorOrder) {
+  for (uint_fast8_t i = 0; i < count; i++)
+    if (pix >= plan[i].start && pix < plan[i].end) return plan[i].colorOrder;
+  return defaultColorOrder;
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include "pin_manager.h"
 #include "bus_wrapper.h"
 #include "bus_manager.h"
+#include "bus_show.h"      // WLEDMM two phase show()
 
 //WLEDMM: #define DEBUGOUT(x) netDebugEnabled?NetDebug.print(x):Serial.print(x) not supported in this file as netDebugEnabled not in scope
 #if 0
@@ -17,7 +18,7 @@ uint16_t approximateKelvinFromRGB(uint32_t rgb);
 void colorRGBtoRGBW(byte* rgb);
 
 //udp.cpp
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false, uint16_t universe=1, uint8_t *sequence=nullptr);
 
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
@@ -52,7 +53,7 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte
 #define W(c) (byte((c) >> 24))
 
 
-void ColorOrderMap::add(uint16_t start, uint16_t len, uint8_t colorOrder) {
+void ColorOrderMap::add(pixidx_t start, pixidx_t len, uint8_t colorOrder) {
   if (_count >= WLED_MAX_COLOR_ORDER_MAPPINGS) {
     return;
   }
@@ -68,7 +69,7 @@ void ColorOrderMap::add(uint16_t start, uint16_t len, uint8_t colorOrder) {
   _count++;
 }
 
-uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder) const {
+uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(pixidx_t pix, uint8_t defaultColorOrder) const {
   if (_count == 0) return defaultColorOrder;
   // upper nibble contains W swap information
   uint8_t swapW = defaultColorOrder >> 4;
@@ -81,6 +82,27 @@ uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(uint16_t pix, uint8_t defaul
 }
 
 
+// WLEDMM ABL: each channel step of each LED is one power unit
+uint_fast16_t Bus::powerUnits(uint32_t c) {
+  uint8_t r = R(c), g = G(c), b = B(c);
+  if (_ws2815Power) return max(max(r,g),b) * 3; // ignore white component on WS2815 power calculation
+  return r + g + b + W(c);
+}
+
+// reads back every LED of the bus; busses that track their power while pixels are set override this
+uint32_t Bus::getPowerSum(uint32_t *peak) {
+  uint32_t sum = 0, groupSum = 0, groupMax = 0;
+  uint16_t len = getLength();
+  for (uint_fast16_t i = 0; i < len; i++) {
+    uint_fast16_t pu = powerUnits(getPixelColor(i));
+    sum += pu;
+    groupSum += pu;
+    if (_injectLen && (i + 1) % _injectLen == 0) { groupMax = max(groupMax, groupSum); groupSum = 0; }
+  }
+  if (peak) *peak = _injectLen ? max(groupMax, groupSum) : sum;
+  return sum;
+}
+
 uint32_t Bus::autoWhiteCalc(uint32_t c) {
   uint8_t aWM = _autoWhiteMode;
   if (_gAWM != AW_GLOBAL_DISABLED) aWM = _gAWM;
@@ -121,6 +143,10 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com) : Bu
   _busPtr = PolyBus::create(_iType, _pins, lenToCreate, nr, _frequencykHz);
   _valid = (_busPtr != nullptr);
   _colorOrder = bc.colorOrder;
+  _autoWhite = (bc.type == TYPE_SK6812_RGBW || bc.type == TYPE_TM1814 || bc.type == TYPE_WS2812_1CH_X3);
+  updateColorOrderPlan();
+  if (_valid) _powerShadow = (uint8_t*) calloc(_len, sizeof(uint8_t)); // WLEDMM all LEDs start black; w/o shadow ABL reads back the bus
+  _powerGen = _powerModelGen;
   if (_pins[1] != 255) {  // WLEDMM USER_PRINTF
     USER_PRINTF("%successfully inited strip %u (len %u) with type %u and pins %u,%u (itype %u)\n", _valid?"S":"Uns", nr, _len, bc.type, _pins[0],_pins[1],_iType);
   } else {
@@ -151,17 +177,26 @@ void BusDigital::setBrightness(uint8_t b, bool immediate) {
 //TODO only show if no new show due in the next 50ms
 void BusDigital::setStatusPixel(uint32_t c) {
   if (_skip && canShow()) {
-    PolyBus::setPixelColor(_busPtr, _iType, 0, c, _colorOrderMap.getPixelColorOrder(_start, _colorOrder));
+    PolyBus::setPixelColor(_busPtr, _iType, 0, c, colorOrderAt(0));
     PolyBus::show(_busPtr, _iType);
   }
 }
 
 void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
-  if (_type == TYPE_SK6812_RGBW || _type == TYPE_TM1814 || _type == TYPE_WS2812_1CH_X3) c = autoWhiteCalc(c);
+  if (_autoWhite) c = autoWhiteCalc(c);
   if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
   if (reversed) pix = _len - pix -1;
   else pix += _skip;
-  uint8_t co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
+  if (_powerShadow && _powerTracking) { // WLEDMM ABL: update power estimate with the difference to the previous color
+    uint8_t pw = (_type == TYPE_WS2812_1CH_X3) ? (powerUnits(RGBW32(W(c), W(c), W(c), W(c))) + 2) >> 2 : (powerUnits(c) + 2) >> 2;
+    if (pw != _powerShadow[pix]) {
+      int delta = int(pw) - _powerShadow[pix];
+      _powerShadow[pix] = pw;
+      _powerSum += delta;
+      if (_groupSum) _groupSum[pix / _injectLen] += delta;
+    }
+  }
+  uint8_t co = colorOrderAt(pix);
   if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
     uint16_t pOld = pix;
     pix = IC_INDEX_WS2812_1CH_3X(pix);
@@ -178,7 +213,7 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
 uint32_t BusDigital::getPixelColor(uint16_t pix) {
   if (reversed) pix = _len - pix -1;
   else pix += _skip;
-  uint8_t co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
+  uint8_t co = colorOrderAt(pix);
   if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
     uint16_t pOld = pix;
     pix = IC_INDEX_WS2812_1CH_3X(pix);
@@ -203,6 +238,51 @@ void BusDigital::setColorOrder(uint8_t colorOrder) {
   // upper nibble contains W swap information
   if ((colorOrder & 0x0F) > 5) return;
   _colorOrder = colorOrder;
+  updateColorOrderPlan();
+}
+
+// WLEDMM resolve the color order map for this bus once, instead of scanning all mappings for every pixel
+// (same result as ColorOrderMap::getPixelColorOrder(pix+_start, _colorOrder): first matching mapping wins)
+void BusDigital::updateColorOrderPlan() {
+  uint8_t swapW = _colorOrder & 0xF0; // upper nibble contains W swap information
+  _coPlanCount = buildColorOrderPlan(_colorOrderMap, _start, _len, swapW, _coPlan, WLED_MAX_COLOR_ORDER_MAPPINGS);
+}
+
+// WLEDMM ABL: same units as Bus::getPowerSum(), i.e. of the colors after the bus has applied its brightness
+uint32_t BusDigital::getPowerSum(uint32_t *peak) {
+  if (!_powerShadow) return Bus::getPowerSum(peak);
+  if (_powerGen != _powerModelGen) rebuildPowerShadow();
+  uint32_t groupMax = _powerSum;
+  if (_groupSum) {
+    groupMax = 0;
+    for (unsigned g = 0; g < (_len + _injectLen - 1) / _injectLen; g++) groupMax = max(groupMax, _groupSum[g]);
+  }
+  if (peak) *peak = (groupMax * 4 * _bri) / 255;
+  return (_powerSum * 4 * _bri) / 255;
+}
+
+void BusDigital::setCurrentBudget(uint16_t milliAmps, uint16_t injectLen) {
+  Bus::setCurrentBudget(milliAmps, injectLen);
+  free(_groupSum);
+  _groupSum = nullptr;
+  if (_powerShadow && _injectLen > 0 && _injectLen < _len) _groupSum = (uint32_t*) calloc((_len + _injectLen - 1) / _injectLen, sizeof(uint32_t));
+  if (!_groupSum) _injectLen = 0; // whole bus is one group
+  else _powerGen = _powerModelGen - 1; // group sums are filled by rebuildPowerShadow()
+}
+
+// recreate the shadow from the bus buffer (power model changed); the buffer holds colors scaled by _bri
+void BusDigital::rebuildPowerShadow() {
+  _powerGen = _powerModelGen;
+  _powerSum = 0;
+  if (_groupSum) memset(_groupSum, 0, ((_len + _injectLen - 1) / _injectLen) * sizeof(uint32_t));
+  for (uint_fast16_t i = 0; i < getLength(); i++) {
+    uint_fast16_t pix = reversed ? _len - i - 1 : i + _skip;
+    uint32_t pu = _bri ? (powerUnits(getPixelColor(i)) * 255) / _bri : 0;
+    uint8_t pw = min(uint32_t((pu + 2) >> 2), uint32_t(255));
+    _powerShadow[pix] = pw;
+    _powerSum += pw;
+    if (_groupSum) _groupSum[pix / _injectLen] += pw;
+  }
 }
 
 void BusDigital::reinit() {
@@ -215,11 +295,149 @@ void BusDigital::cleanup() {
   _iType = I_NONE;
   _valid = false;
   _busPtr = nullptr;
+  free(_powerShadow); _powerShadow = nullptr; // WLEDMM
+  free(_groupSum);    _groupSum = nullptr;
   pinManager.deallocatePin(_pins[1], PinOwner::BusDigital);
   pinManager.deallocatePin(_pins[0], PinOwner::BusDigital);
 }
 
 
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLEDMM_DIRECT_RMT)
+#include "driver/rmt.h"
+
+#define RMT_DIRECT_RESET_US 300 // latch time after the last bit (WS2812B V5 and newer)
+
+BusRmtDirect *BusRmtDirect::_channelBus[8] = {nullptr};
+
+// the translator callback has no user argument in all IDF versions, so there is one per channel
+template<uint8_t CH> static void rmtDirectTranslate(const void *src, rmt_item32_t *dest, size_t srcSize, size_t wantedNum, size_t *translatedSize, size_t *itemNum) {
+  BusRmtDirect::translate(CH, (const uint8_t*)src, (uint32_t*)dest, srcSize, wantedNum, translatedSize, itemNum);
+}
+static const sample_to_rmt_t rmtDirectTranslators[8] = {
+  rmtDirectTranslate<0>, rmtDirectTranslate<1>, rmtDirectTranslate<2>, rmtDirectTranslate<3>,
+  rmtDirectTranslate<4>, rmtDirectTranslate<5>, rmtDirectTranslate<6>, rmtDirectTranslate<7>
+};
+
+// only plain WS2812 RGB busses that NeoPixelBus would put on an RMT channel
+bool BusRmtDirect::supports(BusConfig &bc, uint8_t nr) {
+  return bc.type == TYPE_WS2812_RGB && bc.skipAmount == 0 && nr < RMT_CHANNEL_MAX && nr < 8
+      && PolyBus::getI(bc.type, bc.pins, nr) == I_32_RN_NEO_3;
+}
+
+BusRmtDirect::BusRmtDirect(BusConfig &bc, uint8_t nr, const ColorOrderMap &com) : Bus(bc.type, bc.start, bc.autoWhite), _colorOrderMap(com) {
+  if (!bc.count || nr >= RMT_CHANNEL_MAX || nr >= 8) return;
+  if (!pinManager.allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
+  _pin = bc.pins[0];
+  _channel = nr;
+  _len = bc.count;
+  reversed = bc.reversed;
+  _needsRefresh = bc.refreshReq;
+  _colorOrder = bc.colorOrder;
+  _data = (uint8_t*) calloc(_len, 3);
+  if (!_data) { errorFlag = ERR_LOW_MEM; cleanup(); return; }
+
+  rmt_config_t config = {};
+  config.rmt_mode = RMT_MODE_TX;
+  config.channel = (rmt_channel_t)_channel;
+  config.gpio_num = (gpio_num_t)_pin;
+  config.mem_block_num = 1;
+  config.clk_div = WS281X_RMT_CLK_DIV;
+  config.tx_config.loop_en = false;
+  config.tx_config.carrier_en = false;
+  config.tx_config.idle_output_en = true;
+  config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+  if (rmt_config(&config) != ESP_OK || rmt_driver_install(config.channel, 0, 0) != ESP_OK) { cleanup(); return; }
+  _channelBus[_channel] = this;
+  rmt_translator_init(config.channel, rmtDirectTranslators[_channel]);
+  _valid = true;
+  USER_PRINTF("Successfully inited direct RMT strip %u (len %u) with type %u and pin %u\n", nr, _len, bc.type, _pin);
+}
+
+void BusRmtDirect::translate(uint8_t channel, const uint8_t *src, uint32_t *dest, size_t srcSize, size_t wantedNum, size_t *translatedSize, size_t *itemNum) {
+  BusRmtDirect *bus = channel < 8 ? _channelBus[channel] : nullptr;
+  if (!bus || !src || !dest) { *translatedSize = 0; *itemNum = 0; return; }
+  size_t n = bus->_encoder.encode(src - bus->_data, min(srcSize, wantedNum / 8), dest); // source position = position on the wire
+  *translatedSize = n;
+  *itemNum = n * 8;
+}
+
+// the pixel buffer is read while sending: wait before changing it
+void BusRmtDirect::waitSent() {
+  if (!_sending) return;
+  rmt_wait_tx_done((rmt_channel_t)_channel, portMAX_DELAY);
+  _sending = false;
+}
+
+void BusRmtDirect::show() {
+  if (!_valid) return;
+  waitSent();
+  _encoder.begin(_data, _len, _colorOrder, frameBrightness(), reversed, WS2812X_TIMING);
+  ColorOrderRange plan[WLED_MAX_COLOR_ORDER_MAPPINGS]; // same ranges as BusDigital::updateColorOrderPlan()
+  uint8_t planCount = buildColorOrderPlan(_colorOrderMap, _start, _len, 0, plan, WLED_MAX_COLOR_ORDER_MAPPINGS);
+  for (uint_fast8_t i = 0; i < planCount; i++) _encoder.addColorOrderRange(plan[i].start, plan[i].end - plan[i].start, plan[i].colorOrder);
+  _frameBri = _bri; // the next frame is drawn at the brightness set by now
+  _postScale = 255;
+  _sending = true;
+  _sendStart = micros();
+  rmt_write_sample((rmt_channel_t)_channel, _data, size_t(_len) * 3, false);
+}
+
+bool BusRmtDirect::canShow() {
+  if (!_sending) return true;
+  if (rmt_wait_tx_done((rmt_channel_t)_channel, 0) != ESP_OK) return false;
+  return micros() - _sendStart >= (uint32_t(_len) * 30) + RMT_DIRECT_RESET_US; // 24 bits of 1.25us per LED, then latch
+}
+
+// brightness is applied while encoding, the stored pixels are never scaled. To behave like NeoPixelBusLg:
+// - a new brightness applies to the next frame (NPB-LG applies it in setPixelColor())
+// - immediate (ABL) scales the frame that is about to be sent; repeated calls multiply (like ApplyPostAdjustments())
+void BusRmtDirect::setBrightness(uint8_t b, bool immediate) {
+  if (immediate) _postScale = (uint16_t(_postScale) * (uint16_t(b) + 1)) >> 8;
+  else Bus::setBrightness(b);
+}
+
+// brightness the pending frame will be sent with
+uint8_t BusRmtDirect::frameBrightness() const {
+  return (uint16_t(_frameBri) * (uint16_t(_postScale) + 1)) >> 8;
+}
+
+void IRAM_ATTR BusRmtDirect::setPixelColor(uint16_t pix, uint32_t c) {
+  if (!_valid || pix >= _len) return;
+  if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT, same as BusDigital
+  if (_sending) waitSent();
+  uint8_t *p = _data + size_t(pix) * 3;
+  p[0] = R(c); p[1] = G(c); p[2] = B(c);
+}
+
+uint32_t BusRmtDirect::getPixelColor(uint16_t pix) {
+  if (!_valid || pix >= _len) return 0;
+  const uint8_t *p = _data + size_t(pix) * 3;
+  return RGBW32(p[0], p[1], p[2], 0);
+}
+
+// WLEDMM ABL: same units as BusDigital::getPowerSum(), i.e. scaled by the brightness the frame will be sent with
+uint32_t BusRmtDirect::getPowerSum(uint32_t *peak) {
+  uint32_t sum = Bus::getPowerSum(peak);
+  uint16_t bri = uint16_t(frameBrightness()) + 1;
+  if (peak) *peak = (uint64_t(*peak) * bri) >> 8;
+  return (uint64_t(sum) * bri) >> 8;
+}
+
+void BusRmtDirect::cleanup() {
+  DEBUG_PRINTLN(F("Direct RMT Cleanup."));
+  if (_valid) {
+    waitSent();
+    rmt_driver_uninstall((rmt_channel_t)_channel);
+  }
+  if (_channel < 8 && _channelBus[_channel] == this) _channelBus[_channel] = nullptr;
+  _valid = false;
+  free(_data); _data = nullptr;
+  pinManager.deallocatePin(_pin, PinOwner::BusDigital);
+  _pin = 255;
+}
+#endif
+
+
 BusPwm::BusPwm(BusConfig &bc) : Bus(bc.type, bc.start, bc.autoWhite) {
   _valid = false;
   if (!IS_PWM(bc.type)) return;
@@ -416,6 +634,7 @@ BusNetwork::BusNetwork(BusConfig &bc) : Bus(bc.type, bc.start, bc.autoWhite) {
   memset(_data, 0, bc.count * _UDPchannels);
   _len = bc.count;
   _client = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
+  setStartUniverse(bc.universe); // WLEDMM
   _broadcastLock = false;
   _valid = true;
 }
@@ -439,11 +658,41 @@ uint32_t BusNetwork::getPixelColor(uint16_t pix) {
 
 void BusNetwork::show() {
   if (!_valid || !canShow()) return;
+  if (BusManager::getNetworkPacketGap() > 0) { // WLEDMM paced: snapshot now, send from the main loop
+    if (!_sendData) _sendData = (byte *)malloc(_len * _UDPchannels);
+    if (_sendData) {
+      memcpy(_sendData, _data, _len * _UDPchannels);
+      _sendBri = _bri;
+      _nextPacket = 0;
+      _packetCount = realtimePacketCount(_UDPtype, _len, _rgbw);
+      _frameStart = millis();
+      return;
+    }
+  }
   _broadcastLock = true;
-  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw);
+  unsigned long start = millis();
+  if (realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw, _universe, &_sequence)) _sendErrors++;
+  else _packetsSent += realtimePacketCount(_UDPtype, _len, _rgbw);
+  _frameSendMs = millis() - start;
   _broadcastLock = false;
 }
 
+bool BusNetwork::sendNextPacket() {
+  if (_nextPacket >= _packetCount) return false;
+  if (realtimeSendPacket(_UDPtype, _client, _len, _sendData, _sendBri, _rgbw, _nextPacket, false, _universe, &_sequence)) _sendErrors++;
+  else _packetsSent++;
+  if (++_nextPacket >= _packetCount) _frameSendMs = millis() - _frameStart;
+  return _nextPacket < _packetCount;
+}
+
+void BusNetwork::sendSync() {
+  switch (realtimeSendSync(_UDPtype, _client, &_sequence)) {
+    case 0: _packetsSent++; break;
+    case 1: _sendErrors++;  break;
+    default: break; // no sync packet for this protocol/setting
+  }
+}
+
 uint8_t BusNetwork::getPins(uint8_t* pinArray) {
   for (uint8_t i = 0; i < 4; i++) {
     pinArray[i] = _client[i];
@@ -456,6 +705,9 @@ void BusNetwork::cleanup() {
   _valid = false;
   if (_data != nullptr) free(_data);
   _data = nullptr;
+  free(_sendData); // WLEDMM
+  _sendData = nullptr;
+  _nextPacket = _packetCount = 0;
 }
 
 // ***************************************************************************
@@ -710,21 +962,98 @@ uint32_t BusManager::memUsage(BusConfig &bc) {
 int BusManager::add(BusConfig &bc) {
   if (getNumBusses() - getNumVirtualBusses() >= WLED_MAX_BUSSES) return -1;
   USER_PRINTF("BusManager::add(bc.type=%u)\n", bc.type);
+  busses[numBusses] = create(bc, numBusses);
+  numBusses++;
+  rebuildRanges();
+  return numBusses - 1;
+}
+
+Bus* BusManager::create(BusConfig &bc, uint8_t nr) {
+  Bus *bus;
   if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) {
-    busses[numBusses] = new BusNetwork(bc);
+    bus = new BusNetwork(bc);
 #ifdef WLED_ENABLE_HUB75MATRIX
   } else if (bc.type >= TYPE_HUB75MATRIX && bc.type <= (TYPE_HUB75MATRIX + 10)) {
     USER_PRINTLN("BusManager::add - Adding BusHub75Matrix");
-    busses[numBusses] = new BusHub75Matrix(bc);
+    bus = new BusHub75Matrix(bc);
 #endif
   } else if (IS_DIGITAL(bc.type)) {
-    busses[numBusses] = new BusDigital(bc, numBusses, colorOrderMap);
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLEDMM_DIRECT_RMT)
+    if (BusRmtDirect::supports(bc, nr)) bus = new BusRmtDirect(bc, nr, colorOrderMap);
+    else
+#endif
+    bus = new BusDigital(bc, nr, colorOrderMap);
   } else if (bc.type == TYPE_ONOFF) {
-    busses[numBusses] = new BusOnOff(bc);
+    bus = new BusOnOff(bc);
   } else {
-    busses[numBusses] = new BusPwm(bc);
+    bus = new BusPwm(bc);
+  }
+  bus->setCurrentBudget(bc.milliAmpsMax, bc.injectLen); // WLEDMM
+  return bus;
+}
+
+// WLEDMM true if the bus can take the new config without being re-created (same driver, pins, length and timing)
+bool BusManager::isCompatible(Bus *bus, BusConfig &bc) {
+  if (!bus->isOk() || bus->getType() != bc.type) return false;
+  uint8_t pins[5] = {255, 255, 255, 255, 255};
+  uint8_t nPins = bus->getPins(pins);
+  for (uint_fast8_t p = 0; p < nPins; p++) if (pins[p] != bc.pins[p]) return false;
+  if (IS_DIGITAL(bc.type)) {
+    if (bus->getLength() != bc.count || bus->skippedLeds() != bc.skipAmount) return false;
+    if (bus->isOffRefreshRequired() != (bc.refreshReq || bc.type == TYPE_TM1814)) return false;
+    if (IS_2PIN(bc.type) && bus->getFrequency() != (bc.frequency ? bc.frequency : 2000U)) return false;
+  } else if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) {
+    if (bus->getLength() != bc.count) return false;
+  } else if (bc.type != TYPE_ONOFF) { // PWM
+    if (bus->getFrequency() != (bc.frequency ? bc.frequency : WLED_PWM_FREQ)) return false;
+  }
+  return true;
+}
+
+// WLEDMM apply a new bus list without tearing everything down: busses whose hardware setup is unchanged are kept
+// (and keep their pixel buffers, so they don't go dark), start, direction, color order, auto white and current budget
+// are updated in place. Only changed busses are deleted and re-created, at the same index (RMT/I2S channel).
+// returns the number of busses that were (re-)created
+uint8_t BusManager::reconfigure(BusConfig *configs[], uint8_t count) {
+  DEBUG_PRINTLN(F("Reconfiguring busses."));
+  while (!canAllShow()) yield();
+  netPending = false;
+
+  // first free all busses that go away, so their pins and channels are available to the new ones
+  bool keep[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {false};
+  for (uint_fast8_t i = 0; i < numBusses; i++) {
+    keep[i] = i < count && isCompatible(busses[i], *configs[i]);
+    if (!keep[i]) { delete busses[i]; busses[i] = nullptr; waitUs[i] = showUs[i] = 0; }
+  }
+  if (count < numBusses) numBusses = count;
+
+  uint8_t created = 0;
+  for (uint_fast8_t i = 0; i < count; i++) {
+    BusConfig &bc = *configs[i];
+    if (i < numBusses && keep[i]) {
+      Bus *bus = busses[i];
+      bus->setStart(bc.start);
+      bus->reversed = bc.reversed;
+      if (Bus::hasWhite(bc.type)) bus->setAutoWhiteMode(bc.autoWhite);
+      bus->setColorOrder(bc.colorOrder); // digital busses also re-resolve the color order map for the new start
+      bus->setCurrentBudget(bc.milliAmpsMax, bc.injectLen);
+      bus->setStartUniverse(bc.universe);
+    } else if (i < numBusses) {
+      busses[i] = create(bc, i);
+      created++;
+    } else {
+      if (add(bc) < 0) break;
+      created++;
+    }
   }
-  return numBusses++;
+  rebuildRanges();
+  return created;
+}
+
+// WLEDMM sorted pixel range table for setPixelColor()/getPixelColor()
+void BusManager::rebuildRanges() {
+  ranges.rebuild(busses, numBusses);
+  if (ranges.overlapping()) USER_PRINTLN(F("BusManager: busses overlap, using slow pixel lookup."));
 }
 
 //do not call this method from system context (network callback)
@@ -734,11 +1063,49 @@ void BusManager::removeAll() {
   while (!canAllShow()) yield();
   for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
   numBusses = 0;
+  netPending = false;
+  memset(waitUs, 0, sizeof(waitUs));
+  memset(showUs, 0, sizeof(showUs));
+  rebuildRanges();
 }
 
+// WLEDMM two phase show, see bus_show.h
+struct BusShowClock {
+  inline unsigned long now() { return micros(); }
+  inline void idle() { yield(); }
+};
+
 void BusManager::show() {
-  for (uint8_t i = 0; i < numBusses; i++) {
-    busses[i]->show();
+  if (netPending) handleNetworkOutput(true); // WLEDMM previous network frame not finished in time: send the rest now
+  BusShowClock clock;
+  showAllBusses(busses, numBusses, clock, waitUs, showUs);
+  if (netPacketGap > 0) netPending = (getNumVirtualBusses() > 0);
+}
+
+// WLEDMM paced network output, called from the main loop: sends one packet per netPacketGap,
+// round robin over all network busses so the destinations progress together, then latches all of them
+// (DDP push, E1.31 sync, ArtSync) once every destination has its complete frame.
+void BusManager::handleNetworkOutput(bool flush) {
+  if (!netPending) return;
+  while (flush || micros() - netLastSend >= netPacketGap) {
+    BusNetwork *next = nullptr;
+    for (uint_fast8_t n = 0; n < numBusses && !next; n++) {
+      uint8_t i = (netNext + n) % numBusses;
+      if (busses[i]->getType() < TYPE_NET_DDP_RGB || busses[i]->getType() >= 96) continue;
+      BusNetwork *b = static_cast<BusNetwork*>(busses[i]);
+      if (b->hasPendingPackets()) { next = b; netNext = i + 1; }
+    }
+    if (!next) { // frame complete everywhere
+      for (uint_fast8_t i = 0; i < numBusses; i++)
+        if (busses[i]->getType() >= TYPE_NET_DDP_RGB && busses[i]->getType() < 96) static_cast<BusNetwork*>(busses[i])->sendSync();
+      netPending = false;
+      return;
+    }
+    next->sendNextPacket();
+    // keep the packet rate if the main loop is slower than the gap, but do not burst after long pauses
+    unsigned long now = micros();
+    if (now - netLastSend > 4UL * netPacketGap) netLastSend = now - 4UL * netPacketGap;
+    netLastSend += netPacketGap;
   }
 }
 
@@ -748,15 +1115,39 @@ void BusManager::setStatusPixel(uint32_t c) {
   }
 }
 
-void IRAM_ATTR BusManager::setPixelColor(uint16_t pix, uint32_t c, int16_t cct) {
+void IRAM_ATTR BusManager::setPixelColor(pixidx_t pix, uint32_t c, int16_t cct) {
+  if (!ranges.overlapping()) {  // WLEDMM range table lookup
+    int r = ranges.lookup(pix);
+    if (r < 0) return;
+    ranges[r].bus->setPixelColor(pix - ranges[r].start, c);
+    return;
+  }
   for (uint_fast8_t i = 0; i < numBusses; i++) {    // WLEDMM use fast native types
     Bus* b = busses[i];
-    uint_fast16_t bstart = b->getStart();
+    pixidx_t bstart = b->getStart();
     if (pix < bstart || pix >= bstart + b->getLength()) continue;
     busses[i]->setPixelColor(pix - bstart, c);
   }
 }
 
+// WLEDMM one lookup per bus instead of one per pixel
+void BusManager::setPixelColors(pixidx_t start, pixidx_t len, uint32_t c) {
+  if (ranges.overlapping()) {
+    for (pixidx_t i = start; i < start + len; i++) setPixelColor(i, c);
+    return;
+  }
+  pixidx_t end = start + len;
+  for (uint_fast8_t r = 0; r < ranges.size() && start < end; r++) {
+    const auto &br = ranges[r];
+    if (br.end <= start) continue;
+    if (br.start >= end) break;
+    if (start < br.start) start = br.start;  // gap between busses
+    pixidx_t stop = min(end, br.end);
+    for (pixidx_t i = start - br.start; i < stop - br.start; i++) br.bus->setPixelColor(i, c);
+    start = stop;
+  }
+}
+
 void BusManager::setBrightness(uint8_t b, bool immediate) {
   for (uint8_t i = 0; i < numBusses; i++) {
     busses[i]->setBrightness(b, immediate);
@@ -772,10 +1163,14 @@ void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
   Bus::setCCT(cct);
 }
 
-uint32_t BusManager::getPixelColor(uint_fast16_t pix) {     // WLEDMM use fast native types
+uint32_t BusManager::getPixelColor(pixidx_t pix) {     // WLEDMM use fast native types
+  if (!ranges.overlapping()) {  // WLEDMM range table lookup (first matching bus, like the loop below)
+    int r = ranges.find(pix);
+    return (r < 0) ? 0 : ranges[r].bus->getPixelColor(pix - ranges[r].start);
+  }
   for (uint_fast8_t i = 0; i < numBusses; i++) {
     Bus* b = busses[i];
-    uint_fast16_t bstart = b->getStart();
+    pixidx_t bstart = b->getStart();
     if (pix < bstart || pix >= bstart + b->getLength()) continue;
     return b->getPixelColor(pix - bstart);
   }
@@ -795,8 +1190,8 @@ Bus* BusManager::getBus(uint8_t busNr) {
 }
 
 //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
-uint16_t BusManager::getTotalLength() {
-  uint_fast16_t len = 0;
+pixidx_t BusManager::getTotalLength() {
+  size_t len = 0;
   for (uint_fast8_t i=0; i<numBusses; i++) len += busses[i]->getLength();      // WLEDMM use fast native types
   return len;
 }
@@ -805,3 +1200,7 @@ uint16_t BusManager::getTotalLength() {
 int16_t Bus::_cct = -1;
 uint8_t Bus::_cctBlend = 0;
 uint8_t Bus::_gAWM = 255;
+bool    Bus::_ws2815Power = false;
+uint16_t BusManager::netPacketGap = 0;
+uint8_t Bus::_powerModelGen = 0;
+bool    Bus::_powerTracking = false;
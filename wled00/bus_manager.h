@@ -10,6 +10,12 @@
  */
 
 #include "const.h"
+#include "bus_ranges.h"   // WLEDMM sorted pixel range table
+#include "bus_color.h"    // WLEDMM color order plan
+#include "net_packets.h"  // WLEDMM E131_MAX_UNIVERSE
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLEDMM_DIRECT_RMT)
+#include "ws281x_encoder.h"   // WLEDMM BusRmtDirect
+#endif
 
 #define GET_BIT(var,bit)    (((var)>>(bit))&0x01)
 #define SET_BIT(var,bit)    ((var)|=(uint16_t)(0x0001<<(bit)))
@@ -26,7 +32,7 @@
 struct BusConfig {
   uint8_t type;
   uint16_t count;
-  uint16_t start;
+  pixidx_t start;
   uint8_t colorOrder;
   bool reversed;
   uint8_t skipAmount;
@@ -34,7 +40,10 @@ struct BusConfig {
   uint8_t autoWhite;
   uint8_t pins[5] = {LEDPIN, 255, 255, 255, 255};
   uint16_t frequency;
-  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U) {
+  uint16_t milliAmpsMax = 0;  // WLEDMM own current budget of the bus (per injection group if injectLen > 0), 0 = global limit only
+  uint16_t injectLen = 0;     // WLEDMM LEDs per power injection group
+  uint16_t universe = 1;      // WLEDMM E1.31 network bus: universe of its first pixels
+  BusConfig(uint8_t busType, uint8_t* ppins, pixidx_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U) {
     refreshReq = (bool) GET_BIT(busType,7);
     type = busType & 0x7F;  // bit 7 may be/is hacked to include refresh info (1=refresh in off state, 0=no refresh)
     count = len; start = pstart; colorOrder = pcolorOrder; reversed = rev; skipAmount = skip; autoWhite = aw; frequency = clock_kHz;
@@ -47,7 +56,7 @@ struct BusConfig {
   }
 
   //validates start and length and extends total if needed
-  bool adjustBounds(uint16_t& total) {
+  bool adjustBounds(pixidx_t& total) {
     if (!count) count = 1;
     if (count > MAX_LEDS_PER_BUS) count = MAX_LEDS_PER_BUS;
     if (start >= MAX_LEDS) return false;
@@ -61,13 +70,13 @@ struct BusConfig {
 
 // Defines an LED Strip and its color ordering.
 struct ColorOrderMapEntry {
-  uint16_t start;
-  uint16_t len;
+  pixidx_t start;
+  pixidx_t len;
   uint8_t colorOrder;
 };
 
 struct ColorOrderMap {
-    void add(uint16_t start, uint16_t len, uint8_t colorOrder);
+    void add(pixidx_t start, pixidx_t len, uint8_t colorOrder);
 
     uint8_t count() const {
       return _count;
@@ -85,7 +94,7 @@ struct ColorOrderMap {
       return &(_mappings[n]);
     }
 
-    uint8_t getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder) const;
+    uint8_t getPixelColorOrder(pixidx_t pix, uint8_t defaultColorOrder) const;
 
   private:
     uint8_t _count;
@@ -95,7 +104,7 @@ struct ColorOrderMap {
 //parent class of BusDigital, BusPwm, and BusNetwork
 class Bus {
   public:
-    Bus(uint8_t type, uint16_t start, uint8_t aw)
+    Bus(uint8_t type, pixidx_t start, uint8_t aw)
     : _bri(255)
     , _len(1)
     , _valid(false)
@@ -118,17 +127,29 @@ class Bus {
     virtual uint8_t  getPins(uint8_t* pinArray) { return 0; }
     virtual uint16_t getLength() { return _len; }
     virtual void     setColorOrder() {}
+    virtual void     setColorOrder(uint8_t colorOrder) {}  // WLEDMM used by BusManager::reconfigure()
+    virtual void     updateColorOrderPlan() {}  // WLEDMM color order map has changed
     virtual uint8_t  getColorOrder() { return COL_ORDER_RGB; }
     virtual uint8_t  skippedLeds() { return 0; }
     virtual uint16_t getFrequency() { return 0U; }
-    inline  uint16_t getStart() { return _start; }
-    inline  void     setStart(uint16_t start) { _start = start; }
+    inline  pixidx_t getStart() { return _start; }
+    inline  void     setStart(pixidx_t start) { _start = start; }
     inline  uint8_t  getType() { return _type; }
     inline  bool     isOk() { return _valid; }
     inline  bool     isOffRefreshRequired() { return _needsRefresh; }
-            bool     containsPixel(uint16_t pix) { return pix >= _start && pix < _start+_len; }
+            bool     containsPixel(pixidx_t pix) { return pix >= _start && pix < _start+_len; }
     virtual uint16_t getMaxPixels() { return MAX_LEDS_PER_BUS; };
 
+    // WLEDMM ABL: sum of power units of all LEDs (peak = busiest injection group, or the whole bus)
+    virtual uint32_t getPowerSum(uint32_t *peak = nullptr);
+    virtual void     setCurrentBudget(uint16_t milliAmps, uint16_t injectLen) { _milliAmpsMax = milliAmps; _injectLen = injectLen; }
+    inline  uint16_t getMaxCurrent()   { return _milliAmpsMax; }
+    inline  uint16_t getInjectLength() { return _injectLen; }
+    virtual void     setStartUniverse(uint16_t universe) {}  // WLEDMM E1.31 network busses
+    virtual uint16_t getStartUniverse() { return 0; }
+    static  void     setPowerModel(bool ws2815) { if (ws2815 != _ws2815Power) { _ws2815Power = ws2815; _powerModelGen++; } }
+    static  void     setPowerTracking(bool on)  { if (on != _powerTracking) { _powerTracking = on; _powerModelGen++; } } // WLEDMM off while ABL is disabled
+
     virtual bool hasRGB() {
       if ((_type >= TYPE_WS2812_1CH && _type <= TYPE_WS2812_WWA) || _type == TYPE_ANALOG_1CH || _type == TYPE_ANALOG_2CH || _type == TYPE_ONOFF) return false;
       return true;
@@ -166,16 +187,22 @@ class Bus {
   protected:
     uint8_t  _type;
     uint8_t  _bri;
-    uint16_t _start;
-    uint16_t _len;
+    pixidx_t _start;
+    uint16_t _len;     // pixel index within a bus (and bus length) stays 16bit, see MAX_LEDS_PER_BUS
     bool     _valid;
     bool     _needsRefresh;
     uint8_t  _autoWhiteMode;
+    uint16_t _milliAmpsMax = 0;
+    uint16_t _injectLen = 0;
     static uint8_t _gAWM;
     static int16_t _cct;
     static uint8_t _cctBlend;
+    static bool    _ws2815Power;    // WLEDMM ABL: ignore white, count brightest channel only
+    static uint8_t _powerModelGen;  // WLEDMM changes with the power model
+    static bool    _powerTracking;  // WLEDMM ABL enabled: digital busses update their power shadow in setPixelColor()
 
     uint32_t autoWhiteCalc(uint32_t c);
+    static uint_fast16_t powerUnits(uint32_t c);
 };
 
 
@@ -207,6 +234,12 @@ class BusDigital : public Bus {
 
     void setColorOrder(uint8_t colorOrder);
 
+    void updateColorOrderPlan();
+
+    uint32_t getPowerSum(uint32_t *peak = nullptr);
+
+    void setCurrentBudget(uint16_t milliAmps, uint16_t injectLen);
+
     uint8_t skippedLeds() {
       return _skip;
     }
@@ -229,9 +262,84 @@ class BusDigital : public Bus {
     uint16_t _frequencykHz = 0U;
     void * _busPtr = nullptr;
     const ColorOrderMap &_colorOrderMap;
+    bool _autoWhite = false;        // WLEDMM type needs autoWhiteCalc()
+
+    // WLEDMM ABL: power units/4 of every LED as last written, kept up to date in setPixelColor()
+    // so show() does not need to read back the whole bus
+    uint8_t  *_powerShadow = nullptr;
+    uint32_t *_groupSum = nullptr;  // per power injection group
+    uint32_t _powerSum = 0;
+    uint8_t  _powerGen = 0;         // power model the shadow was built with
+
+    void rebuildPowerShadow();
+
+    // WLEDMM color order map entries that cover this bus, in physical bus index (incl. skipped LEDs)
+    ColorOrderRange _coPlan[WLED_MAX_COLOR_ORDER_MAPPINGS];
+    uint8_t _coPlanCount = 0;
+
+    inline uint8_t colorOrderAt(uint16_t pix) const {
+      return colorOrderInPlan(_coPlan, _coPlanCount, pix, _colorOrder);
+    }
 };
 
 
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLEDMM_DIRECT_RMT)
+// WLEDMM WS2812 RGB bus on an RMT channel without NeoPixelBus (build with -D WLEDMM_DIRECT_RMT).
+// Pixels are stored once, unscaled; WS281xEncoder applies color order, brightness and direction while the RMT driver
+// fetches the bitstream. Saves the second NeoPixelBus buffer and its copy per frame, and getPixelColor() is lossless.
+class BusRmtDirect : public Bus {
+  public:
+    BusRmtDirect(BusConfig &bc, uint8_t nr, const ColorOrderMap &com);
+
+    static bool supports(BusConfig &bc, uint8_t nr);
+
+    void show();
+
+    bool canShow();
+
+    void setBrightness(uint8_t b, bool immediate);
+
+    void setPixelColor(uint16_t pix, uint32_t c);
+
+    uint32_t getPixelColor(uint16_t pix);
+
+    uint32_t getPowerSum(uint32_t *peak = nullptr);
+
+    uint8_t getPins(uint8_t* pinArray) { pinArray[0] = _pin; return 1; }
+
+    uint8_t getColorOrder() { return _colorOrder; }
+
+    void setColorOrder(uint8_t colorOrder) { if ((colorOrder & 0x0F) <= COL_ORDER_MAX) _colorOrder = colorOrder; }
+
+    void cleanup();
+
+    ~BusRmtDirect() {
+      cleanup();
+    }
+
+    // called by the RMT driver (translator) for the next chunk of the bitstream
+    static void translate(uint8_t channel, const uint8_t *src, uint32_t *dest, size_t srcSize, size_t wantedNum, size_t *translatedSize, size_t *itemNum);
+
+  private:
+    uint8_t  _pin = 255;
+    uint8_t  _channel = 0;
+    uint8_t  _colorOrder = COL_ORDER_GRB;
+    uint8_t  _frameBri = 255;       // brightness the pixels in _data were drawn with
+    uint8_t  _postScale = 255;      // ABL reduction of the pending frame (setBrightness(b, true))
+    uint8_t *_data = nullptr;       // R,G,B per LED
+    bool     _sending = false;
+    unsigned long _sendStart = 0;   // micros()
+    const ColorOrderMap &_colorOrderMap;
+    WS281xEncoder _encoder;
+
+    static BusRmtDirect *_channelBus[8];
+
+    void waitSent();
+    uint8_t frameBrightness() const;
+};
+#endif
+
+
 class BusPwm : public Bus {
   public:
     BusPwm(BusConfig &bc);
@@ -320,6 +428,18 @@ class BusNetwork : public Bus {
 
     void cleanup();
 
+    // WLEDMM paced output (BusManager::setNetworkPacketGap() > 0): show() only takes a snapshot of the frame,
+    // BusManager::handleNetworkOutput() sends it packet by packet and latches all destinations together
+    bool sendNextPacket();   // returns false when the frame is complete
+    void sendSync();
+    inline bool     hasPendingPackets() const { return _nextPacket < _packetCount; }
+    inline uint32_t getPacketsSent()    const { return _packetsSent; }
+    inline uint32_t getSendErrors()     const { return _sendErrors; }
+    inline uint16_t getFrameSendTime()  const { return _frameSendMs; }
+    inline IPAddress getClient()        const { return _client; }
+    void     setStartUniverse(uint16_t universe) override { if (universe > 0 && universe <= E131_MAX_UNIVERSE) _universe = universe; }
+    uint16_t getStartUniverse() override { return _UDPtype == 1 ? _universe : 0; }
+
     ~BusNetwork() {
       cleanup();
     }
@@ -331,6 +451,16 @@ class BusNetwork : public Bus {
     bool      _rgbw;
     bool      _broadcastLock;
     byte     *_data;
+    byte     *_sendData = nullptr;  // WLEDMM frame being sent (paced output)
+    uint8_t   _sendBri = 255;
+    uint16_t  _nextPacket = 0;
+    uint16_t  _packetCount = 0;
+    unsigned long _frameStart = 0;
+    uint32_t  _packetsSent = 0;
+    uint32_t  _sendErrors = 0;
+    uint16_t  _frameSendMs = 0;     // time to send the last complete frame
+    uint16_t  _universe = 1;        // WLEDMM E1.31: universe of the first packet
+    uint8_t   _sequence = 0;        // WLEDMM E1.31: sequence number of this destination
 };
 
 #ifdef WLED_ENABLE_HUB75MATRIX
@@ -391,30 +521,41 @@ class BusManager {
 
     int add(BusConfig &bc);
 
+    // WLEDMM re-create only busses whose type, pins, length or timing changed, update the others in place
+    uint8_t reconfigure(BusConfig *configs[], uint8_t count);
+
     //do not call this method from system context (network callback)
     void removeAll();
 
     void show();
 
+    // WLEDMM paced network output, see BusNetwork
+    void handleNetworkOutput(bool flush = false);
+    static void     setNetworkPacketGap(uint16_t us) { netPacketGap = us; }
+    static uint16_t getNetworkPacketGap()            { return netPacketGap; }
+
     void setStatusPixel(uint32_t c);
 
-    void setPixelColor(uint16_t pix, uint32_t c, int16_t cct=-1);
+    void setPixelColor(pixidx_t pix, uint32_t c, int16_t cct=-1);
+
+    void setPixelColors(pixidx_t start, pixidx_t len, uint32_t c);   // WLEDMM batched fill of consecutive physical pixels
 
     void setBrightness(uint8_t b, bool immediate=false);          // immediate=true is for use in ABL, it applies brightness immediately (warning: inefficient)
 
     void setSegmentCCT(int16_t cct, bool allowWBCorrection = false);
 
-    uint32_t __attribute__((pure)) getPixelColor(uint_fast16_t pix); // WLEDMM attribute added
+    uint32_t __attribute__((pure)) getPixelColor(pixidx_t pix); // WLEDMM attribute added
 
     bool canAllShow();
 
     Bus* getBus(uint8_t busNr);
 
     //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
-    uint16_t getTotalLength();
+    pixidx_t getTotalLength();
 
     inline void updateColorOrderMap(const ColorOrderMap &com) {
       memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap));
+      for (uint_fast8_t i = 0; i < numBusses; i++) busses[i]->updateColorOrderPlan(); // WLEDMM
     }
 
     inline const ColorOrderMap& getColorOrderMap() const {
@@ -425,11 +566,27 @@ class BusManager {
       return numBusses;
     }
 
+    // WLEDMM smoothed per-bus timing of show(): waiting for the previous transfer, and starting the new one (us)
+    inline uint16_t getBusWaitTime(uint8_t busNr) { return busNr < numBusses ? waitUs[busNr] : 0; }
+    inline uint16_t getBusShowTime(uint8_t busNr) { return busNr < numBusses ? showUs[busNr] : 0; }
+
   private:
     uint8_t numBusses = 0;
     Bus* busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
     ColorOrderMap colorOrderMap;
 
+    BusRangeTable<Bus, WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES> ranges; // WLEDMM pixel ranges sorted by start
+    uint16_t waitUs[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {0};
+    static uint16_t netPacketGap;   // us between network packets, 0 = send each frame at once
+    bool netPending = false;        // paced frame in progress
+    uint8_t netNext = 0;            // round robin over network busses
+    unsigned long netLastSend = 0;
+    uint16_t showUs[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES] = {0};
+
+    void rebuildRanges();
+    Bus* create(BusConfig &bc, uint8_t nr);
+    static bool isCompatible(Bus *bus, BusConfig &bc);
+
     inline uint8_t getNumVirtualBusses() {
       int j = 0;
       for (int i=0; i<numBusses; i++) if (busses[i]->getType() >= TYPE_NET_DDP_RGB && busses[i]->getType() < 96) j++;
@@ -0,0 +1,61 @@
+#ifndef BUS_RANGES_H
+#define BUS_RANGES_H
+
+/*
+ * WLEDMM pixel ranges of all busses sorted by start, so a pixel is resolved without scanning all busses.
+ * Used by BusManager (bus_manager.h) for setPixelColor()/getPixelColor(); BUS only needs getStart() and getLength().
+ * Plain C++ without Arduino dependencies, tested and benchmarked on the host (see test/test_bus_ranges).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "const.h"
+
+template <class BUS, size_t N>
+class BusRangeTable {
+  public:
+    struct Range { pixidx_t start, end; BUS* bus; };
+
+    // rebuild from the bus list (whenever busses are added, removed or reconfigured; bus length is fixed after construction)
+    void rebuild(BUS* const *busses, size_t count) {
+      _num = 0;
+      _last = 0;
+      _overlapping = false;
+      for (size_t i = 0; i < count && _num < N; i++) {
+        pixidx_t len = busses[i]->getLength();
+        if (len == 0) continue;
+        Range r = {busses[i]->getStart(), pixidx_t(busses[i]->getStart() + len), busses[i]};
+        int j = _num++;
+        for (; j > 0 && _ranges[j-1].start > r.start; j--) _ranges[j] = _ranges[j-1]; // insertion sort, at most a few busses
+        _ranges[j] = r;
+      }
+      for (uint_fast8_t i = 1; i < _num; i++) if (_ranges[i].start < _ranges[i-1].end) _overlapping = true;
+    }
+
+    // index of the range containing pix, or -1; only meaningful if !overlapping()
+    inline int find(pixidx_t pix) const {
+      if (_last < _num && pix >= _ranges[_last].start && pix < _ranges[_last].end) return _last;
+      int lo = 0, hi = _num;  // first range with start > pix
+      while (lo < hi) { int mid = (lo + hi) >> 1; if (_ranges[mid].start <= pix) lo = mid + 1; else hi = mid; }
+      return (lo > 0 && pix < _ranges[lo-1].end) ? lo-1 : -1;
+    }
+
+    // like find(), remembering the hit: consecutive pixels mostly land on the same bus
+    inline int lookup(pixidx_t pix) {
+      int r = find(pix);
+      if (r >= 0) _last = r;
+      return r;
+    }
+
+    inline const Range& operator[](size_t r) const { return _ranges[r]; }
+    inline uint8_t size() const { return _num; }
+    inline bool overlapping() const { return _overlapping; } // busses share pixels: all of them have to be written (slow path)
+
+  private:
+    Range   _ranges[N];
+    uint8_t _num = 0;
+    uint8_t _last = 0;
+    bool    _overlapping = false;
+};
+
+#endif
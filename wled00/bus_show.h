@@ -0,0 +1,38 @@
+#ifndef BUS_SHOW_H
+#define BUS_SHOW_H
+
+/*
+ * WLEDMM two phase show() of BusManager: first wait until all busses have finished their previous transfer,
+ * then start all of them back to back. Calling show() in sequence lets each bus block on its own previous
+ * transfer, so later busses start late and the frame time depends on the bus order.
+ * BUS needs canShow() and show(); CLOCK needs now() (us) and idle() (yield while waiting).
+ * Plain C++ without Arduino dependencies, tested with a mock bus and a simulated clock (see test/test_bus_show).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BUS_SHOW_MAX_WAIT 50000 // us, give up waiting for the busses (their show() will block instead)
+
+// smoothed timing (7/8 old + 1/8 new, us, saturated at 65535)
+static inline uint16_t busTimingEMA(uint16_t avg, uint32_t sample) {
+  return (uint32_t(avg) * 7 + (sample < 65535 ? sample : 65535)) >> 3;
+}
+
+template <class BUS, class CLOCK>
+void showAllBusses(BUS* const *busses, size_t count, CLOCK &clock, uint16_t *waitUs, uint16_t *showUs,
+                   uint32_t maxWait = BUS_SHOW_MAX_WAIT) {
+  const unsigned long deadline = clock.now(); // one timeout for all busses together
+  for (size_t i = 0; i < count; i++) {
+    unsigned long waitStart = clock.now();
+    while (!busses[i]->canShow() && clock.now() - deadline < maxWait) clock.idle();
+    waitUs[i] = busTimingEMA(waitUs[i], clock.now() - waitStart);
+  }
+  for (size_t i = 0; i < count; i++) {
+    unsigned long showStart = clock.now();
+    busses[i]->show();
+    showUs[i] = busTimingEMA(showUs[i], clock.now() - showStart);
+  }
+}
+
+#endif
@@ -18,6 +18,26 @@
 #endif
 // temporary end
 
+// WLEDMM parallel I2S output (classic ESP32 only, needs NeoPixelBus 2.7 or newer): -D WLEDMM_PARALLEL_I2S
+// All digital busses become lanes of I2S#1, which clocks out up to 8 strips in one DMA transfer
+// (bit-transposed by NeoPixelBus) instead of one strip per RMT channel.
+// parallel_encoder.h is a host tested 8/16 lane encoder for drivers that fill the DMA buffers themselves (e.g. ESP32-S3 LCD).
+#if defined(WLEDMM_PARALLEL_I2S) && (!defined(ARDUINO_ARCH_ESP32) || defined(WLED_NO_I2S1_PIXELBUS))
+  #warning "WLEDMM_PARALLEL_I2S needs I2S#1 of a classic ESP32 - disabled"
+  #undef WLEDMM_PARALLEL_I2S
+#endif
+#ifdef WLEDMM_PARALLEL_I2S
+  #define I2S1_800KBPS_METHOD NeoEsp32I2s1X8800KbpsMethod
+  #define I2S1_400KBPS_METHOD NeoEsp32I2s1X8400KbpsMethod
+  #define I2S1_TM1814_METHOD  NeoEsp32I2s1X8Tm1814Method
+  #define I2S1_TM1829_METHOD  NeoEsp32I2s1X8Tm1829Method
+#else
+  #define I2S1_800KBPS_METHOD NeoEsp32I2s1800KbpsMethod
+  #define I2S1_400KBPS_METHOD NeoEsp32I2s1400KbpsMethod
+  #define I2S1_TM1814_METHOD  NeoEsp32I2s1Tm1814Method
+  #define I2S1_TM1829_METHOD  NeoEsp32I2s1Tm1829Method
+#endif
+
 //Hardware SPI Pins
 #define P_8266_HS_MOSI 13
 #define P_8266_HS_CLK  14
@@ -169,7 +189,7 @@
 #define B_32_I0_NEO_3 NeoPixelBusLg<NeoGrbFeature, NeoEsp32I2s0800KbpsMethod, NeoGammaNullMethod>
 #endif
 #ifndef WLED_NO_I2S1_PIXELBUS
-#define B_32_I1_NEO_3 NeoPixelBusLg<NeoGrbFeature, NeoEsp32I2s1800KbpsMethod, NeoGammaNullMethod>
+#define B_32_I1_NEO_3 NeoPixelBusLg<NeoGrbFeature, I2S1_800KBPS_METHOD, NeoGammaNullMethod>
 #endif
 //#define B_32_BB_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32BitBang800KbpsMethod> // NeoEsp8266BitBang800KbpsMethod
 //RGBW
@@ -178,7 +198,7 @@
 #define B_32_I0_NEO_4 NeoPixelBusLg<NeoGrbwFeature, NeoEsp32I2s0800KbpsMethod, NeoGammaNullMethod>
 #endif
 #ifndef WLED_NO_I2S1_PIXELBUS
-#define B_32_I1_NEO_4 NeoPixelBusLg<NeoGrbwFeature, NeoEsp32I2s1800KbpsMethod, NeoGammaNullMethod>
+#define B_32_I1_NEO_4 NeoPixelBusLg<NeoGrbwFeature, I2S1_800KBPS_METHOD, NeoGammaNullMethod>
 #endif
 //#define B_32_BB_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp32BitBang800KbpsMethod> // NeoEsp8266BitBang800KbpsMethod
 //400Kbps
@@ -187,7 +207,7 @@
 #define B_32_I0_400_3 NeoPixelBusLg<NeoGrbFeature, NeoEsp32I2s0400KbpsMethod, NeoGammaNullMethod>
 #endif
 #ifndef WLED_NO_I2S1_PIXELBUS
-#define B_32_I1_400_3 NeoPixelBusLg<NeoGrbFeature, NeoEsp32I2s1400KbpsMethod, NeoGammaNullMethod>
+#define B_32_I1_400_3 NeoPixelBusLg<NeoGrbFeature, I2S1_400KBPS_METHOD, NeoGammaNullMethod>
 #endif
 //#define B_32_BB_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32BitBang400KbpsMethod> // NeoEsp8266BitBang400KbpsMethod
 //TM1814 (RGBW)
@@ -196,7 +216,7 @@
 #define B_32_I0_TM1_4 NeoPixelBusLg<NeoWrgbTm1814Feature, NeoEsp32I2s0Tm1814Method, NeoGammaNullMethod>
 #endif
 #ifndef WLED_NO_I2S1_PIXELBUS
-#define B_32_I1_TM1_4 NeoPixelBusLg<NeoWrgbTm1814Feature, NeoEsp32I2s1Tm1814Method, NeoGammaNullMethod>
+#define B_32_I1_TM1_4 NeoPixelBusLg<NeoWrgbTm1814Feature, I2S1_TM1814_METHOD, NeoGammaNullMethod>
 #endif
 //Bit Bang theoratically possible, but very undesirable and not needed (no pin restrictions on RMT and I2S)
 //TM1829 (RGB)
@@ -205,7 +225,7 @@
 #define B_32_I0_TM2_3 NeoPixelBusLg<NeoBrgFeature, NeoEsp32I2s0Tm1829Method, NeoGammaNullMethod>
 #endif
 #ifndef WLED_NO_I2S1_PIXELBUS
-#define B_32_I1_TM2_3 NeoPixelBusLg<NeoBrgFeature, NeoEsp32I2s1Tm1829Method, NeoGammaNullMethod>
+#define B_32_I1_TM2_3 NeoPixelBusLg<NeoBrgFeature, I2S1_TM1829_METHOD, NeoGammaNullMethod>
 #endif
 //Bit Bang theoratically possible, but very undesirable and not needed (no pin restrictions on RMT and I2S)
 //UCS8903
@@ -214,7 +234,7 @@
 #define B_32_I0_UCS_3 NeoPixelBusLg<NeoRgbUcs8903Feature, NeoEsp32I2s0800KbpsMethod, NeoGammaNullMethod>
 #endif
 #ifndef WLED_NO_I2S1_PIXELBUS
-#define B_32_I1_UCS_3 NeoPixelBusLg<NeoRgbUcs8903Feature, NeoEsp32I2s1800KbpsMethod, NeoGammaNullMethod>
+#define B_32_I1_UCS_3 NeoPixelBusLg<NeoRgbUcs8903Feature, I2S1_800KBPS_METHOD, NeoGammaNullMethod>
 #endif
 //Bit Bang theoratically possible, but very undesirable and not needed (no pin restrictions on RMT and I2S)
 //UCS8904
@@ -223,7 +243,7 @@
 #define B_32_I0_UCS_4 NeoPixelBusLg<NeoRgbwUcs8904Feature, NeoEsp32I2s0800KbpsMethod, NeoGammaNullMethod>
 #endif
 #ifndef WLED_NO_I2S1_PIXELBUS
-#define B_32_I1_UCS_4 NeoPixelBusLg<NeoRgbwUcs8904Feature, NeoEsp32I2s1800KbpsMethod, NeoGammaNullMethod>
+#define B_32_I1_UCS_4 NeoPixelBusLg<NeoRgbwUcs8904Feature, I2S1_800KBPS_METHOD, NeoGammaNullMethod>
 #endif
 //Bit Bang theoratically possible, but very undesirable and not needed (no pin restrictions on RMT and I2S)
 
@@ -1176,6 +1196,10 @@ class PolyBus {
       // On ESP32-S3 only the first 4 RMT channels are usable for transmitting
       if (num > 3) return I_NONE;
       //if (num > 3) offset = num -4; // I2S not supported yet
+      #elif defined(WLEDMM_PARALLEL_I2S)
+      // WLEDMM parallel I2S: up to 8 busses, all of them lanes of I2S#1
+      if (num > 7) return I_NONE;
+      offset = 2;
       #else
       // standard ESP32 has 8 RMT and 2 I2S channels
       #ifndef WLEDMM_FASTPATH
@@ -105,6 +105,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
 
   CJSON(strip.ablMilliampsMax, hw_led[F("maxpwr")]);
   CJSON(strip.milliampsPerLed, hw_led[F("ledma")]);
+  BusManager::setNetworkPacketGap(hw_led[F("netgap")] | BusManager::getNetworkPacketGap()); // WLEDMM us between network packets (0 = no pacing)
+  CJSON(e131OutSyncUniverse, hw_led[F("e131sync")]); // WLEDMM E1.31 output sync universe (0 = no sync)
+  if (e131OutSyncUniverse > E131_MAX_UNIVERSE) e131OutSyncUniverse = 0;
   Bus::setGlobalAWMode(hw_led[F("rgbwm")] | AW_GLOBAL_DISABLED);
   CJSON(correctWB, hw_led["cct"]);
   CJSON(cctFromRgb, hw_led[F("cr")]);
@@ -112,6 +115,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
   CJSON(strip.useLedsArray, hw_led[F("ld")]);
+  CJSON(strip.adaptiveQuality, hw_led[F("aq")]); // WLEDMM
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -186,7 +190,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       uint16_t length = elm["len"] | 1;
       uint8_t colorOrder = (int)elm[F("order")]; // contains white channel swap option in upper nibble
       uint8_t skipFirst = elm[F("skip")];
-      uint16_t start = elm["start"] | 0;
+      pixidx_t start = elm["start"] | 0;
       if (length==0 || start + length > MAX_LEDS) continue; // zero length or we reached max. number of LEDs, just stop
       uint8_t ledType = elm["type"] | TYPE_WS2812_RGB;
       bool reversed = elm["rev"];
@@ -194,13 +198,21 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       uint16_t freqkHz = elm[F("freq")] | 0;  // will be in kHz for DotStar and Hz for PWM (not yet implemented fully)
       ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
       uint8_t AWmode = elm[F("rgbwm")] | RGBW_MODE_MANUAL_ONLY;
+      uint16_t maxMA = elm[F("maxma")] | 0;   // WLEDMM own current budget of this bus (per injection group)
+      uint16_t injLen = elm[F("injlen")] | 0; // WLEDMM LEDs per power injection group
+      uint16_t universe = elm[F("uni")] | 1;  // WLEDMM E1.31 network bus: first universe
       if (fromFS) {
         BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz);
-        mem += BusManager::memUsage(bc);
-        if (mem <= MAX_LED_MEMORY) if (busses.add(bc) == -1) break;  // finalization will be done in WLED::beginStrip()
+        bc.milliAmpsMax = maxMA; bc.injectLen = injLen; bc.universe = universe;
+        uint32_t busMem = BusManager::memUsage(bc);
+        if (mem + busMem <= MAX_LED_MEMORY) {  // WLEDMM only count busses that fit (same as bus re-init in wled.cpp)
+          mem += busMem;
+          if (busses.add(bc) == -1) break;  // finalization will be done in WLED::beginStrip()
+        }
       } else {
         if (busConfigs[s] != nullptr) delete busConfigs[s];
         busConfigs[s] = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode);
+        busConfigs[s]->milliAmpsMax = maxMA; busConfigs[s]->injectLen = injLen; busConfigs[s]->universe = universe;
         busesChanged = true;
       }
       s++;
@@ -217,8 +229,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     uint8_t s = 0;
     for (JsonObject entry : hw_com) {
       if (s > WLED_MAX_COLOR_ORDER_MAPPINGS) break;
-      uint16_t start = entry["start"] | 0;
-      uint16_t len = entry["len"] | 0;
+      pixidx_t start = entry["start"] | 0;
+      pixidx_t len = entry["len"] | 0;
       uint8_t colorOrder = (int)entry[F("order")];
       com.add(start, len, colorOrder);
       s++;
@@ -767,12 +779,15 @@ void serializeConfig() {
   hw_led[F("total")] = strip.getLengthTotal(); //no longer read, but provided for compatibility on downgrade
   hw_led[F("maxpwr")] = strip.ablMilliampsMax;
   hw_led[F("ledma")] = strip.milliampsPerLed;
+  hw_led[F("netgap")] = BusManager::getNetworkPacketGap();
+  hw_led[F("e131sync")] = e131OutSyncUniverse;
   hw_led["cct"] = correctWB;
   hw_led[F("cr")] = cctFromRgb;
   hw_led[F("cb")] = strip.cctBlending;
   hw_led["fps"] = strip.getTargetFps();
   hw_led[F("rgbwm")] = Bus::getGlobalAWMode(); // global auto white mode override
   hw_led[F("ld")] = strip.useLedsArray;
+  hw_led[F("aq")] = strip.adaptiveQuality; // WLEDMM
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -828,6 +843,11 @@ void serializeConfig() {
     ins["ref"] = bus->isOffRefreshRequired();
     ins[F("rgbwm")] = bus->getAutoWhiteMode();
     ins[F("freq")] = bus->getFrequency();
+    if (bus->getMaxCurrent()) {  // WLEDMM optional per-bus current budget
+      ins[F("maxma")] = bus->getMaxCurrent();
+      ins[F("injlen")] = bus->getInjectLength();
+    }
+    if (bus->getStartUniverse()) ins[F("uni")] = bus->getStartUniverse(); // WLEDMM E1.31 network bus
   }
 
   JsonArray hw_com = hw.createNestedArray(F("com"));
@@ -302,11 +302,11 @@ uint32_t IRAM_ATTR_YN colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb)  //
   static uint16_t lastKelvin = 0;
   if (lastKelvin != kelvin) colorKtoRGB(kelvin, correctionRGB);  // convert Kelvin to RGB
   lastKelvin = kelvin;
-  byte rgbw[4];
-  rgbw[0] = ((uint16_t) correctionRGB[0] * R(rgb)) /255; // correct R
-  rgbw[1] = ((uint16_t) correctionRGB[1] * G(rgb)) /255; // correct G
-  rgbw[2] = ((uint16_t) correctionRGB[2] * B(rgb)) /255; // correct B
-  rgbw[3] =                                W(rgb);
+  byte rgbw[4];  // WLEDMM x/255 without division (bus_color.h)
+  rgbw[0] = div255(correctionRGB[0] * R(rgb)); // correct R
+  rgbw[1] = div255(correctionRGB[1] * G(rgb)); // correct G
+  rgbw[2] = div255(correctionRGB[2] * B(rgb)); // correct B
+  rgbw[3] =                      W(rgb);
   return RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]);
 }
 
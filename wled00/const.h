@@ -249,7 +249,7 @@
 
 //Network types (master broadcast) (80-95)
 #define TYPE_NET_DDP_RGB         80            //network DDP RGB bus (master broadcast bus)
-#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus, unused)
+#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus)
 #define TYPE_NET_ARTNET_RGB      82            //network ArtNet RGB bus (master broadcast bus, unused)
 #define TYPE_NET_DDP_RGBW        88            //network DDP RGBW bus (master broadcast bus)
 
@@ -379,6 +379,20 @@
 #define NTP_PACKET_SIZE 48       // size of NTP receive buffer
 #define NTP_MIN_PACKET_SIZE 48   // min expected size - NTP v4 allows for "extended information" appended to the standard fields
 
+// WLEDMM large installations (-D WLED_LARGE_INSTALLATION): more than 65535 pixels and more than 255 rows.
+// Only makes sense on boards with PSRAM (i.e. S3 with 8MB) - global leds[] and ledmap grow with the number of pixels.
+#ifdef WLED_LARGE_INSTALLATION
+  #ifdef ESP8266
+    #error "WLED_LARGE_INSTALLATION is not supported on ESP8266."
+  #endif
+  #ifndef MAX_LEDS
+    #define MAX_LEDS 131072
+  #endif
+  #ifndef MAX_LED_MEMORY
+    #define MAX_LED_MEMORY 512000  // bus buffers (i.e. network busses) go to PSRAM
+  #endif
+#endif
+
 //maximum number of rendered LEDs - this does not have to match max. physical LEDs, e.g. if there are virtual busses
 #ifndef MAX_LEDS
 #ifdef ESP8266
@@ -404,6 +418,31 @@
 #define MAX_LEDS_PER_BUS 2048   // may not be enough for fast LEDs (i.e. APA102)
 #endif
 
+// WLEDMM index types for strip pixels and matrix rows. Kept at 16/8 bit unless really needed, as they end up in per-pixel tables (ledmap).
+#if MAX_LEDS > 65535
+  typedef uint32_t pixidx_t;  // strip pixel index or pixel count (also used for ledmap entries)
+#else
+  typedef uint16_t pixidx_t;
+#endif
+#ifdef WLED_LARGE_INSTALLATION
+  typedef uint16_t rowidx_t;  // Y coordinate of segments and panel offsets
+#else
+  typedef uint8_t  rowidx_t;  // no more than 255 rows
+#endif
+#define PIXIDX_NONE ((pixidx_t)-1)  // ledmap: no physical pixel
+
+// WLEDMM Segment::setPixelColor(int)/getPixelColor(int) take the virtual strip (column of a 1D effect expanded to 2D, 1-based)
+// in the upper bits of the pixel index. Large installations need more than 16 bits for the index itself.
+#if MAX_LEDS > 65535
+  #define VSTRIP_SHIFT 21     // up to 2M pixels per segment, up to 1023 virtual strips (matrix columns)
+#else
+  #define VSTRIP_SHIFT 16
+#endif
+#define VSTRIP_INDEX_MASK ((1 << VSTRIP_SHIFT) - 1)
+#define VSTRIP_PACK(index, vStrip) (int(index) | (int(vStrip) << VSTRIP_SHIFT))
+#define VSTRIP_OF(i)    ((i) >> VSTRIP_SHIFT)       // 0 = no virtual strip, negative for negative indexes
+#define VSTRIP_INDEX(i) ((i) & VSTRIP_INDEX_MASK)
+
 // string temp buffer (now stored in stack locally) // WLEDMM ...which is actually not the greatest design choice on ESP32
 #ifdef ESP8266
 #define SETTINGS_STACK_BUF_SIZE 2048
@@ -29,7 +29,7 @@ void handleDDPPacket(e131_packet_t* p) {
 
   uint32_t start =  htonl(p->channelOffset) / ddpChannelsPerLed;
   start += DMXAddress / ddpChannelsPerLed;
-  uint16_t stop = start + htons(p->dataLen) / ddpChannelsPerLed;
+  pixidx_t stop = start + htons(p->dataLen) / ddpChannelsPerLed;
   uint8_t* data = p->data;
   uint16_t c = 0;
   if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
@@ -37,7 +37,7 @@ void handleDDPPacket(e131_packet_t* p) {
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
   if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
-    for (uint16_t i = start; i < stop; i++) {
+    for (pixidx_t i = start; i < stop; i++) {
       setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
       c += ddpChannelsPerLed;
     }
@@ -126,7 +126,7 @@ void handleDMXData(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, uint8
 
 
   byte wChannel = 0;
-  uint16_t totalLen = strip.getLengthTotal();
+  pixidx_t totalLen = strip.getLengthTotal();
   uint16_t availDMXLen = 0;
   uint16_t dataOffset = DMXAddress;
 
@@ -157,7 +157,7 @@ void handleDMXData(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, uint8
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
       wChannel = (availDMXLen > 3) ? e131_data[dataOffset+3] : 0;
-      for (uint16_t i = 0; i < totalLen; i++)
+      for (pixidx_t i = 0; i < totalLen; i++)
         setRealtimePixel(i, e131_data[dataOffset+0], e131_data[dataOffset+1], e131_data[dataOffset+2], wChannel);
       break;
 
@@ -174,7 +174,7 @@ void handleDMXData(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, uint8
         strip.setBrightness(bri, true);
       }
 
-      for (uint16_t i = 0; i < totalLen; i++)
+      for (pixidx_t i = 0; i < totalLen; i++)
         setRealtimePixel(i, e131_data[dataOffset+1], e131_data[dataOffset+2], e131_data[dataOffset+3], wChannel);
       break;
 
@@ -236,6 +236,7 @@ void handleDMXData(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, uint8
           if ((e131_data[dataOffset+5] & 0b00001000) != seg.transpose) { seg.setOption(SEG_OPTION_TRANSPOSED, e131_data[dataOffset+5] & 0b00001000); }
           if ((e131_data[dataOffset+5] & 0b00110000) / 8 != seg.map1D2D) {
             seg.map1D2D = (e131_data[dataOffset+5] & 0b00110000) / 8;
+            seg.refreshGeometry(); // WLEDMM
           }
           // To maintain backwards compatibility with prior e1.31 values, reverse is fixed to mask 0x01000000
           if ((e131_data[dataOffset+5] & 0b01000000) != seg.reverse) { seg.setOption(SEG_OPTION_REVERSED, e131_data[dataOffset+5] & 0b01000000); }
@@ -278,7 +279,8 @@ void handleDMXData(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, uint8
         const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
         const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
         uint8_t stripBrightness = bri;
-        uint16_t previousLeds, dmxOffset, ledsTotal;
+        uint16_t dmxOffset;
+        pixidx_t previousLeds, ledsTotal;
 
         if (previousUniverses == 0) {
           if (availDMXLen < 1) return;
@@ -320,12 +322,12 @@ void handleDMXData(uint16_t uni, uint16_t dmxChannels, uint8_t* e131_data, uint8
         }
 
         if (!is4Chan) {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
+          for (pixidx_t i = previousLeds; i < ledsTotal; i++) {
             setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
             dmxOffset+=3;
           }
         } else {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
+          for (pixidx_t i = previousLeds; i < ledsTotal; i++) {
             setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
             dmxOffset+=4;
           }
@@ -371,11 +373,11 @@ void handleArtnetPollReply(IPAddress ipAddress) {
         const uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
         const uint16_t dmxLenOffset = (DMXAddress == 0) ? 0 : 1; // For legacy DMX start address 0
         const uint16_t ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
-        const uint16_t totalLen = strip.getLengthTotal();
+        const pixidx_t totalLen = strip.getLengthTotal();
 
         if (totalLen > ledsInFirstUniverse) {
           const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
-          const uint16_t remainLED = totalLen - ledsInFirstUniverse;
+          const pixidx_t remainLED = totalLen - ledsInFirstUniverse;
 
           endUniverse += (remainLED / ledsPerUniverse);
 
@@ -102,6 +102,13 @@ void onHueConnect(void* arg, AsyncClient* client);
 void sendHuePoll();
 void onHueData(void* arg, AsyncClient* client, void *data, size_t len);
 
+//image_loader.cpp
+#ifndef WLED_DISABLE_2D
+bool renderImageToSegment(Segment &seg);
+uint32_t getImageDecodeTime();
+void releaseImagePlayers(bool all = false); // WLEDMM closes files and frees caches of images no longer played
+#endif
+
 //improv.cpp
 enum ImprovRPCType {
   Command_Wifi = 0x01,
@@ -204,9 +211,25 @@ void calculateSunriseAndSunset();
 void setTimeFromAPI(uint32_t timein);
 
 //overlay.cpp
+// WLEDMM retained overlay layer: holds overlay pixels as runs and re-applies them after every frame,
+// so the owner (clock, usermod) only redraws when its content changes. Later runs overwrite earlier ones.
+class OverlayLayer {
+  public:
+    bool changed(uint32_t key);   // true (and layer cleared) if content for this key has to be drawn
+    void invalidate(void) { _valid = false; }
+    void setPixelColor(pixidx_t i, uint32_t c) { setRange(i, i, c); }
+    void setRange(pixidx_t i, pixidx_t i2, uint32_t c);
+    void apply(void) const;       // one pass over all runs
+  private:
+    struct Run { pixidx_t start, len; uint32_t color; };
+    std::vector<Run> _runs;
+    uint32_t _key = 0;
+    bool _valid = false;
+};
 void handleOverlayDraw();
-void _overlayAnalogCountdown();
-void _overlayAnalogClock();
+void _overlayAnalogCountdown(OverlayLayer &layer);
+void _overlayAnalogClock(OverlayLayer &layer);
+uint16_t getOverlayDrawTime(); // WLEDMM us per frame (smoothed)
 
 //playlist.cpp
 void suspendPlaylist(); // WLEDMM support function for auto playlist usermod
@@ -239,11 +262,14 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=tru
 
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false, uint16_t universe=1, uint8_t *sequence=nullptr);
+uint16_t realtimePacketCount(uint8_t type, uint16_t length, bool isRGBW);
+uint8_t realtimeSendPacket(uint8_t type, IPAddress client, uint16_t length, const uint8_t *buffer, uint8_t bri, bool isRGBW, uint16_t packet, bool push=true, uint16_t universe=1, uint8_t *sequence=nullptr);
+uint8_t realtimeSendSync(uint8_t type, IPAddress client, const uint8_t *sequence=nullptr);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
-void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixel(pixidx_t i, byte r, byte g, byte b, byte w);
 void refreshNodeList();
 void sendSysInfoUDP();
 
@@ -373,7 +399,7 @@ uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLe
 uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxLen, uint8_t *var = nullptr);
 int16_t extractModeDefaults(uint8_t mode, const char *segVar);
 void checkSettingsPIN(const char *pin);
-uint16_t  __attribute__((pure)) crc16(const unsigned char* data_p, size_t length);   // WLEDMM: added attribute pure
+uint16_t  __attribute__((pure)) crc16(const unsigned char* data_p, size_t length, uint16_t crc = 0xFFFF);   // WLEDMM: added attribute pure, crc = previous result
 um_data_t* simulateSound(uint8_t simulationId);
 // WLEDMM enumerateLedmaps(); moved to FX.h
 uint8_t get_random_wheel_index(uint8_t pos);
@@ -404,12 +430,29 @@ void deEEPSettings();
 void clearEEPROM();
 #endif
 
+//wled.cpp
+#ifdef WLEDMM_IDLE_GOVERNOR
+void idleWakeup();  // WLEDMM leave idle mode immediately - safe to call from async_tcp context
+#else
+inline void idleWakeup() {}
+#endif
+
 //wled_math.cpp
+int16_t  sin16_t(uint16_t theta);           // WLEDMM fast math: angle 0..65535 = full circle, result Q15 (-32767..32767)
+int16_t  cos16_t(uint16_t theta);
+uint16_t atan2_16_t(int32_t y, int32_t x);  // angle 0..65535 = full circle
+uint32_t sqrt32_t(uint32_t x);              // integer square root
+uint32_t hypot_t(int32_t dx, int32_t dy);   // integer vector length, dx and dy within +/-32767
+#ifdef WLEDMM_MATH_SELFTEST
+void mathSelfTest();
+#endif
 #ifndef WLED_USE_REAL_MATH
   template <typename T> T atan_t(T x);
   float cos_t(float phi);
   float sin_t(float x);
   float tan_t(float x);
+  float atan2_t(float y, float x);
+  float exp_t(float x);
   float acos_t(float x);
   float asin_t(float x);
   float floor_t(float x);
@@ -419,6 +462,8 @@ void clearEEPROM();
   #define sin_t sinf
   #define cos_t cosf
   #define tan_t tanf
+  #define atan2_t atan2f
+  #define exp_t expf
   #define asin_t asinf
   #define acos_t acosf
   #define atan_t atanf
@@ -0,0 +1,258 @@
+#ifndef GIF_DECODER_H
+#define GIF_DECODER_H
+
+/*
+ * WLEDMM GIF decoding for image playback (image_loader.cpp): header and frame parsing, LZW decoding with clipping,
+ * and a cache of composited frames that replays an animation once it has been decoded completely.
+ * Bytes come from any reader with int read() (next byte or -1 at the end), pixels go to a plot(x, y, rgb) callback,
+ * so the same code decodes from a File on the device and from memory on the host (see test/test_gif_decoder).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GIF_MAX_CODES 4096  // 12 bit LZW codes
+
+typedef struct GifLzwTables {
+  uint16_t prefix[GIF_MAX_CODES];
+  uint8_t  suffix[GIF_MAX_CODES];
+  uint8_t  stack[GIF_MAX_CODES + 1];
+} gif_lzw_t;  // 16 KB, allocated once per image
+
+// image descriptor and the graphic control extension in front of it
+typedef struct GifFrame {
+  uint16_t x, y, w, h;    // position and size within the logical screen
+  bool     interlaced;
+  uint8_t  disposal;      // what happens to this frame before the next one is drawn
+  int16_t  transparent;   // color index, -1 = none
+  uint16_t delay;         // 1/100 s
+  uint16_t numColors;     // entries of the local color table, 0 = use the global one
+} gif_frame_t;
+
+// part of the logical screen that is drawn: screen pixel (x, y) is plotted at (x - left, y - top) if within width x height
+typedef struct GifClip {
+  uint16_t left, top, width, height;
+} gif_clip_t;
+
+// results of gifReadFrame()
+#define GIF_FRAME    1  // image descriptor read, reader is at the image data
+#define GIF_TRAILER  0  // end of the animation (trailer or end of file)
+#define GIF_ERROR   -1
+
+template <class READER>
+bool gifRead(READER &r, uint8_t *dest, size_t n) {
+  for (size_t i = 0; i < n; i++) { int c = r.read(); if (c < 0) return false; dest[i] = c; }
+  return true;
+}
+
+template <class READER>
+bool gifSkipSubBlocks(READER &r) {
+  int n;
+  while ((n = r.read()) > 0) for (int i = 0; i < n; i++) if (r.read() < 0) return false;
+  return n == 0;
+}
+
+// header and global color table (gct needs room for 256 colors); gctSize is 0 without global color table
+template <class READER>
+bool gifReadHeader(READER &r, uint16_t &width, uint16_t &height, uint8_t *gct, uint16_t &gctSize) {
+  uint8_t hdr[13];
+  if (!gifRead(r, hdr, sizeof(hdr))) return false;
+  if (memcmp(hdr, "GIF8", 4) != 0) return false;
+  width   = hdr[6] | (hdr[7] << 8);
+  height  = hdr[8] | (hdr[9] << 8);
+  gctSize = (hdr[10] & 0x80) ? (2 << (hdr[10] & 0x07)) : 0;
+  return gctSize == 0 || gifRead(r, gct, 3 * gctSize);
+}
+
+// reads up to and including the next image descriptor and its local color table (into lct, room for 256 colors)
+template <class READER>
+int gifReadFrame(READER &r, gif_frame_t &f, uint8_t *lct) {
+  f.disposal = 0;
+  f.transparent = -1;
+  f.delay = 10;
+  for (;;) {
+    int block = r.read();
+    if (block == 0x21) { // extension
+      int label = r.read();
+      if (label == 0xF9) { // graphic control extension: size, packed, delay (2), transparent index, terminator
+        uint8_t gce[6];
+        if (!gifRead(r, gce, sizeof(gce))) return GIF_ERROR;
+        f.disposal = (gce[1] >> 2) & 0x07;
+        f.delay = gce[2] | (gce[3] << 8);
+        f.transparent = (gce[1] & 0x01) ? gce[4] : -1;
+      } else if (label < 0 || !gifSkipSubBlocks(r)) return GIF_ERROR;
+    } else if (block == 0x2C) { // image descriptor
+      uint8_t desc[9];
+      if (!gifRead(r, desc, sizeof(desc))) return GIF_ERROR;
+      f.x = desc[0] | (desc[1] << 8); f.y = desc[2] | (desc[3] << 8);
+      f.w = desc[4] | (desc[5] << 8); f.h = desc[6] | (desc[7] << 8);
+      f.interlaced = desc[8] & 0x40;
+      f.numColors = (desc[8] & 0x80) ? (2 << (desc[8] & 0x07)) : 0;
+      if (f.numColors && !gifRead(r, lct, 3 * f.numColors)) return GIF_ERROR;
+      return GIF_FRAME;
+    } else if (block == 0x3B || block < 0) {
+      return GIF_TRAILER;
+    } else
+      return GIF_ERROR;
+  }
+}
+
+// decodes the image data following gifReadFrame() and plots its visible, non transparent pixels.
+// Stops decoding once the last row inside the clip area is done and skips the rest, so the reader ends up behind the image.
+template <class READER, class PLOT>
+bool gifDecodeImage(READER &r, gif_lzw_t &t, const gif_frame_t &f, const gif_clip_t &clip,
+                    const uint8_t *colors, uint16_t numColors, PLOT plot) {
+  int minCodeSize = r.read();
+  if (minCodeSize < 2 || minCodeSize > 11) return false;
+  for (int i = 0; i < (1 << minCodeSize); i++) t.suffix[i] = i;
+
+  // rows of the frame up to the end of the clip area, nothing to do if the frame is outside of it
+  const uint32_t clipRight = uint32_t(clip.left) + clip.width, clipBottom = uint32_t(clip.top) + clip.height;
+  const bool visible = f.w && f.h && f.x < clipRight && uint32_t(f.x) + f.w > clip.left && f.y < clipBottom && uint32_t(f.y) + f.h > clip.top;
+  const uint32_t lastRow = visible ? (clipBottom - f.y < f.h ? clipBottom - f.y : f.h) : 0; // exclusive
+  const int clearCode = 1 << minCodeSize;
+  const int eoiCode   = clearCode + 1;
+  int codeSize = minCodeSize + 1;
+  int nextCode = clearCode + 2;
+  int oldCode  = -1;
+  uint8_t first = 0;
+
+  // bit reader over data sub-blocks
+  int blockLeft = 0;
+  uint32_t bits = 0;
+  int nBits = 0;
+  bool streamEnd = false;
+
+  // output position within the frame
+  uint32_t pixel = 0, total = uint32_t(f.w) * f.h;
+  uint16_t px = 0, py = 0;
+  uint8_t  pass = 0;
+  static const uint8_t interlaceStart[] = {0, 4, 2, 1};
+  static const uint8_t interlaceStep[]  = {8, 8, 4, 2};
+
+  bool ok = true;
+  while (pixel < total && ((f.interlaced && pass < 3) || py < lastRow)) {
+    // fetch next code
+    while (nBits < codeSize && !streamEnd) {
+      if (blockLeft == 0) {
+        blockLeft = r.read();
+        if (blockLeft <= 0) { streamEnd = true; ok = blockLeft == 0; break; }
+      }
+      int c = r.read();
+      if (c < 0) { streamEnd = true; ok = false; break; }
+      blockLeft--;
+      bits |= uint32_t(c) << nBits;
+      nBits += 8;
+    }
+    if (nBits < codeSize) break;
+    int code = bits & ((1 << codeSize) - 1);
+    bits >>= codeSize;
+    nBits -= codeSize;
+
+    if (code == clearCode) { codeSize = minCodeSize + 1; nextCode = clearCode + 2; oldCode = -1; continue; }
+    if (code == eoiCode) break;
+
+    int sp = 0;
+    if (oldCode < 0) {
+      if (code >= clearCode) { ok = false; break; } // first code after clear must be a root
+      first = code;
+      t.stack[sp++] = first;
+    } else {
+      int in = code;
+      if (code > nextCode) { ok = false; break; } // corrupt stream
+      if (code == nextCode) { t.stack[sp++] = first; code = oldCode; } // KwKwK case
+      while (code >= clearCode && sp < GIF_MAX_CODES) { t.stack[sp++] = t.suffix[code]; code = t.prefix[code]; }
+      first = t.suffix[code];
+      t.stack[sp++] = first;
+      if (nextCode < GIF_MAX_CODES) { // a full table stays as it is until the encoder sends a clear code
+        t.prefix[nextCode] = oldCode;
+        t.suffix[nextCode] = first;
+        nextCode++;
+        if (nextCode == (1 << codeSize) && codeSize < 12) codeSize++;
+      }
+      code = in;
+    }
+    oldCode = code;
+
+    // plot decoded run (stack holds it in reverse order)
+    while (sp > 0 && pixel < total) {
+      uint8_t idx = t.stack[--sp];
+      uint32_t x = uint32_t(f.x) + px, y = uint32_t(f.y) + py;
+      if (idx != f.transparent && idx < numColors && x >= clip.left && x < clipRight && y >= clip.top && y < clipBottom)
+        plot(uint16_t(x - clip.left), uint16_t(y - clip.top), colors + 3*idx);
+      pixel++;
+      if (++px >= f.w) { // next row
+        px = 0;
+        if (!f.interlaced) py++;
+        else {
+          py += interlaceStep[pass];
+          while (py >= f.h && pass < 3) py = interlaceStart[++pass];
+        }
+      }
+    }
+  }
+  if (!streamEnd) { // skip rest of image data (incl. block terminator)
+    while (blockLeft-- > 0) if (r.read() < 0) return false;
+    if (!gifSkipSubBlocks(r)) ok = false;
+  }
+  return ok;
+}
+
+#define GIF_CACHE_MAX_FRAMES 64
+
+// composited frames (RGB, frameLen bytes each) of one loop of an animation. Filled while the loop is decoded;
+// once the loop is complete the animation is replayed from here without decoding. Gives up (and frees everything)
+// as soon as the frames do not fit into the budget.
+class GifFrameCache {
+  public:
+    void* (*allocFn)(size_t) = malloc;   // e.g. PSRAM on the device
+
+    GifFrameCache() {}
+    GifFrameCache(const GifFrameCache&) = delete;
+    GifFrameCache& operator=(const GifFrameCache&) = delete;
+    ~GifFrameCache() { clear(); }
+
+    void clear() {
+      for (uint16_t i = 0; i < _count; i++) free(_frames[i]);
+      _count = 0;
+      _bytes = 0;
+      _state = CACHE_OFF;
+    }
+    // start caching a new loop of frames of frameLen bytes each
+    void start(size_t budget, size_t frameLen) {
+      clear();
+      _budget = budget;
+      _frameLen = frameLen;
+      if (frameLen && budget >= frameLen) _state = CACHE_FILLING;
+    }
+    // memory for the next frame of the loop, nullptr if it does not fit (the cache is dropped)
+    uint8_t* append(uint16_t delay) {
+      if (_state != CACHE_FILLING) return nullptr;
+      uint8_t *frame = (_count < GIF_CACHE_MAX_FRAMES && _bytes + _frameLen <= _budget) ? (uint8_t*) allocFn(_frameLen) : nullptr;
+      if (!frame) { clear(); return nullptr; }
+      _frames[_count] = frame;
+      _delays[_count++] = delay;
+      _bytes += _frameLen;
+      return frame;
+    }
+    // the loop is complete: replay from now on
+    void complete() { if (_state == CACHE_FILLING && _count) _state = CACHE_READY; }
+
+    bool     filling() const { return _state == CACHE_FILLING; }
+    bool     ready() const { return _state == CACHE_READY; }
+    uint16_t frames() const { return _count; }
+    size_t   frameLen() const { return _frameLen; }
+    size_t   bytes() const { return _bytes; }
+    const uint8_t* frame(uint16_t i, uint16_t &delay) const { delay = _delays[i]; return _frames[i]; }
+
+  private:
+    enum { CACHE_OFF, CACHE_FILLING, CACHE_READY } _state = CACHE_OFF;
+    uint8_t *_frames[GIF_CACHE_MAX_FRAMES];
+    uint16_t _delays[GIF_CACHE_MAX_FRAMES];
+    uint16_t _count = 0;
+    size_t   _bytes = 0, _budget = 0, _frameLen = 0;
+};
+
+#endif
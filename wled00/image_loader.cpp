@@ -0,0 +1,327 @@
+#include "wled.h"
+
+#ifndef WLED_DISABLE_2D
+
+/*
+ * WLEDMM image playback: plays animated GIF files from LittleFS (or SD card, see usermods/sd_card) on a 2D segment.
+ *
+ * Decoding is done by gif_decoder.h. The playback position, color tables and frame timing are kept in the segment data;
+ * the open file, the LZW tables (16 KB) and the frame cache belong to one of a few players that live as long as the
+ * image plays and are released by WS2812FX::service() once nobody asked for them for a while.
+ * Decoded pixels are written to the segment, so the segment itself holds the composited frame
+ * (GIF frames usually only update a part of the image). Once one loop of an animation has been composited, the frames
+ * are copied into the frame cache and replayed from memory, the file is closed.
+ *
+ * With "Sprite sheet" checked, the GIF is a single image with the frames stacked vertically (square frames of the
+ * image width) or side by side (square frames of the image height), e.g. exported from a pixel art editor.
+ */
+
+#if defined(WLED_USE_SD_MMC)
+  #include "SD_MMC.h"
+  #define IMAGE_SD SD_MMC
+#elif defined(WLED_USE_SD_SPI)
+  #include "SD.h"
+  #define IMAGE_SD SD
+#endif
+
+#include "gif_decoder.h"
+
+#define IMAGE_NAME_LEN 40      // "/" + segment name (at most 32 characters) + ".gif"
+#define IMAGE_PLAYERS  2       // images that keep their file and memory between frames
+#define IMAGE_TIMEOUT  2000    // ms - players that were not used for this long close their file and free their memory
+#define IMAGE_IN_USE   1000    // ms - players used more recently belong to a playing segment and are not taken over
+
+// memory for cached frames (RGB) per image; 0 disables the frame cache
+#ifndef IMAGE_CACHE_BYTES
+  #ifdef ARDUINO_ARCH_ESP32
+    #define IMAGE_CACHE_BYTES (24*1024)   // e.g. 10 frames of 32x24
+  #else
+    #define IMAGE_CACHE_BYTES 0
+  #endif
+#endif
+#ifndef IMAGE_CACHE_BYTES_PSRAM
+  #define IMAGE_CACHE_BYTES_PSRAM (512*1024)
+#endif
+
+// playback state, kept in SEGENV.data
+typedef struct ImageState {
+  char     fileName[IMAGE_NAME_LEN]; // currently playing file
+  bool     valid;               // header parsed
+  bool     sheet;               // played as sprite sheet
+  uint8_t  disposal;            // disposal method of the previous frame
+  uint8_t  loops;               // completed loops (saturating)
+  uint16_t frameNo;             // frame within the loop (sprite within the sheet)
+  uint16_t cols, rows;          // segment size the state was built for
+  uint16_t width, height;       // logical screen
+  uint32_t firstFrameOfs;       // file offset after header and global color table
+  uint32_t nextFrameOfs;        // file offset of the next frame (image data of the sheet)
+  unsigned long nextFrameTime;  // millis() when the next frame is due
+  uint16_t prevX, prevY, prevW, prevH; // area of the previous frame (disposal 2)
+  gif_frame_t sheetFrame;       // image descriptor of the sprite sheet
+  uint16_t sheetTile, sheetFrames; // sprite size and count
+  uint32_t decodeUs;            // decode time of the last frame
+  uint16_t gctSize;             // entries in global color table
+  uint8_t  gct[3*256];          // global color table
+  uint8_t  lct[3*256];          // local color table
+} image_state_t;
+
+// buffered sequential reader
+class GifReader {
+  public:
+    File     f;
+    uint32_t ofs = 0;
+    void seek(uint32_t pos) { f.seek(pos); ofs = pos; _len = _pos = 0; }
+    int read() {
+      if (_pos >= _len) {
+        _len = f.read(_buf, sizeof(_buf));
+        _pos = 0;
+        if (_len == 0) return -1;
+      }
+      ofs++;
+      return _buf[_pos++];
+    }
+  private:
+    uint8_t  _buf[256];
+    uint16_t _len = 0, _pos = 0;
+};
+
+#if defined(BOARD_HAS_PSRAM) && (defined(WLED_USE_PSRAM) || defined(WLED_USE_PSRAM_JSON))
+static void* cacheAlloc(size_t len) { return psramFound() ? ps_malloc(len) : malloc(len); }
+static size_t cacheBudget() { return psramFound() ? IMAGE_CACHE_BYTES_PSRAM : IMAGE_CACHE_BYTES; }
+#else
+static void* cacheAlloc(size_t len) { return malloc(len); }
+static size_t cacheBudget() { return IMAGE_CACHE_BYTES; }
+#endif
+
+class ImagePlayer {
+  public:
+    char          fileName[IMAGE_NAME_LEN] = ""; // empty = slot unused
+    uint8_t       segId = 0;
+    unsigned long lastUsed = 0;
+    GifReader     reader;              // file stays open until the frame cache is ready
+    gif_lzw_t    *lzw = nullptr;
+    GifFrameCache cache;
+    bool          noCache = false;     // frames did not fit, do not try again
+
+    ImagePlayer() { cache.allocFn = cacheAlloc; }
+    void closeFile() {
+      if (reader.f) reader.f.close();
+      free(lzw);
+      lzw = nullptr;
+    }
+    void close() {
+      closeFile();
+      cache.clear();
+      noCache = false;
+      fileName[0] = '\0';
+    }
+};
+
+static ImagePlayer players[IMAGE_PLAYERS];
+static ImagePlayer spare; // used for one call when all players are busy
+
+static uint32_t lastDecodeUs = 0; // decode time of the last frame of any segment
+
+uint32_t getImageDecodeTime() { return lastDecodeUs; }
+
+static File openImage(const char *fileName) {
+  #ifdef IMAGE_SD
+  if (IMAGE_SD.cardType() != CARD_NONE && IMAGE_SD.exists(fileName)) return IMAGE_SD.open(fileName, "r");
+  #endif
+  if (WLED_FS.exists(fileName)) return WLED_FS.open(fileName, "r");
+  return File();
+}
+
+// player of fileName for segment segId, opens the file if needed; restart drops what the player had
+static ImagePlayer* getImagePlayer(uint8_t segId, const char *fileName, bool restart) {
+  unsigned long nowMs = millis();
+  ImagePlayer *slot = nullptr;
+  for (ImagePlayer &p : players) {
+    if (p.fileName[0] && p.segId == segId) {
+      if (!restart && strcmp(p.fileName, fileName) == 0) { p.lastUsed = nowMs; return &p; }
+      p.close(); // segment plays something else now
+    }
+    if (!slot || !p.fileName[0] || (slot->fileName[0] && p.lastUsed < slot->lastUsed)) slot = &p; // free or least recently used slot
+  }
+  // all players still in use: taking one over would reopen files every frame, play from a temporary one instead
+  if (slot->fileName[0] && nowMs - slot->lastUsed < IMAGE_IN_USE) slot = &spare;
+  slot->close();
+  slot->reader.f = openImage(fileName);
+  if (!slot->reader.f) return nullptr;
+  slot->reader.seek(0);
+  strlcpy(slot->fileName, fileName, sizeof(slot->fileName));
+  slot->segId = segId;
+  slot->lastUsed = nowMs;
+  return slot;
+}
+
+// keeps the player of a segment that waits for its next frame
+static void touchImagePlayer(uint8_t segId, const char *fileName) {
+  for (ImagePlayer &p : players) if (p.segId == segId && strcmp(p.fileName, fileName) == 0) p.lastUsed = millis();
+}
+
+void releaseImagePlayers(bool all) {
+  unsigned long nowMs = millis();
+  for (ImagePlayer &p : players) {
+    if (p.fileName[0] && (all || nowMs - p.lastUsed > IMAGE_TIMEOUT)) p.close();
+  }
+}
+
+// copies the segment (composited frame) to the cache while a loop is being cached
+static void cacheFrame(ImagePlayer *p, Segment &seg, uint16_t delay) {
+  if (!p->cache.filling()) return;
+  uint8_t *px = p->cache.append(delay);
+  if (!px) { p->noCache = true; return; }
+  const uint16_t cols = seg.virtualWidth(), rows = seg.virtualHeight();
+  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
+    uint32_t c = seg.getPixelColorXY(x, y);
+    *px++ = R(c); *px++ = G(c); *px++ = B(c);
+  }
+}
+
+// starts caching at the beginning of a loop
+static void startCache(ImagePlayer *p, Segment &seg) {
+  size_t budget = cacheBudget();
+  if (p->noCache || !budget || p->cache.filling() || p->cache.ready()) return;
+  p->cache.start(budget, size_t(seg.virtualWidth()) * seg.virtualHeight() * 3);
+}
+
+static bool readHeader(ImagePlayer *p, image_state_t *st) {
+  if (!gifReadHeader(p->reader, st->width, st->height, st->gct, st->gctSize)) return false;
+  st->firstFrameOfs = st->nextFrameOfs = p->reader.ofs;
+  if (!st->sheet) return true;
+  // sprite sheet: one image of square frames
+  if (gifReadFrame(p->reader, st->sheetFrame, st->lct) != GIF_FRAME) return false;
+  st->nextFrameOfs = p->reader.ofs;
+  const bool vertical = st->height >= st->width;
+  st->sheetTile   = vertical ? st->width : st->height;
+  st->sheetFrames = st->sheetTile ? (vertical ? st->height : st->width) / st->sheetTile : 0;
+  return st->sheetFrames > 0;
+}
+
+// decodes the next frame of the animation into the segment, returns its delay, 0 at the end of a cached loop, -1 on errors
+static int decodeFrame(ImagePlayer *p, image_state_t *st, Segment &seg) {
+  const uint16_t cols = seg.virtualWidth(), rows = seg.virtualHeight();
+  auto plot = [&seg](uint16_t x, uint16_t y, const uint8_t *rgb) { seg.setPixelColorXY(int(x), int(y), RGBW32(rgb[0], rgb[1], rgb[2], 0)); };
+  gif_frame_t f;
+
+  if (st->sheet) {
+    const gif_frame_t &s = st->sheetFrame;
+    const bool vertical = st->height >= st->width;
+    const uint16_t ofs = st->frameNo * st->sheetTile;
+    const gif_clip_t clip = {uint16_t(vertical ? 0 : ofs), uint16_t(vertical ? ofs : 0), min(st->sheetTile, cols), min(st->sheetTile, rows)};
+    if (st->frameNo == 0) startCache(p, seg);
+    if (p->reader.ofs != st->nextFrameOfs) p->reader.seek(st->nextFrameOfs);
+    seg.fill(BLACK);
+    if (!gifDecodeImage(p->reader, *p->lzw, s, clip, s.numColors ? st->lct : st->gct, s.numColors ? s.numColors : st->gctSize, plot)) return -1;
+    cacheFrame(p, seg, s.delay);
+    if (++st->frameNo >= st->sheetFrames) { st->frameNo = 0; p->cache.complete(); }
+    return s.delay < 2 ? 10 : s.delay;
+  }
+
+  int res = gifReadFrame(p->reader, f, st->lct);
+  if (res == GIF_TRAILER) { // end of loop: start over
+    p->cache.complete();
+    if (st->loops < 255) st->loops++;
+    st->frameNo = 0;
+    p->reader.seek(st->firstFrameOfs);
+    if (p->cache.ready()) return 0; // caller replays the cache from here on
+    res = gifReadFrame(p->reader, f, st->lct);
+  }
+  if (res != GIF_FRAME) return -1; // also: no image in file
+  // the first loop is composited on whatever was there before, cache the second one
+  if (st->frameNo == 0 && st->loops > 0) startCache(p, seg);
+
+  // previous frame asked to be cleared to background (area is clipped to the segment, see below)
+  if (st->disposal == 2) {
+    for (int y = st->prevY; y < st->prevY + st->prevH; y++)
+      for (int x = st->prevX; x < st->prevX + st->prevW; x++) seg.setPixelColorXY(x, y, BLACK);
+  }
+  const gif_clip_t clip = {0, 0, cols, rows};
+  if (!gifDecodeImage(p->reader, *p->lzw, f, clip, f.numColors ? st->lct : st->gct, f.numColors ? f.numColors : st->gctSize, plot)) return -1;
+  // remember the visible part only, the descriptor comes straight from the file
+  st->prevX = min(f.x, cols); st->prevY = min(f.y, rows);
+  st->prevW = min(f.w, uint16_t(cols - st->prevX)); st->prevH = min(f.h, uint16_t(rows - st->prevY));
+  st->disposal = f.disposal;
+  st->nextFrameOfs = p->reader.ofs;
+  cacheFrame(p, seg, f.delay);
+  st->frameNo++;
+  return f.delay < 2 ? 10 : f.delay; // like browsers, treat 0/1 as 100ms
+}
+
+// shows the next frame from the frame cache, returns its delay
+static uint16_t replayFrame(ImagePlayer *p, image_state_t *st, Segment &seg) {
+  if (st->frameNo >= p->cache.frames()) st->frameNo = 0;
+  uint16_t delay;
+  const uint8_t *px = p->cache.frame(st->frameNo++, delay);
+  const uint16_t cols = seg.virtualWidth(), rows = seg.virtualHeight();
+  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++, px += 3) seg.setPixelColorXY(x, y, RGBW32(px[0], px[1], px[2], 0));
+  return delay < 2 ? 10 : delay;
+}
+
+// show the next frame of the GIF named after the segment (default "/image.gif") if it is due
+// returns false if the name is too long or the file is missing or invalid
+bool renderImageToSegment(Segment &seg) {
+  char fileName[IMAGE_NAME_LEN];
+  const char *name = (seg.name && seg.name[0]) ? seg.name : "image";
+  const size_t nameLen = strlen(name);
+  const bool hasExt = nameLen > 4 && strcmp_P(name + nameLen - 4, PSTR(".gif")) == 0;
+  int len = snprintf_P(fileName, sizeof(fileName), PSTR("%s%s%s"), name[0] == '/' ? "" : "/", name, hasExt ? "" : ".gif");
+  if (len < 0 || len >= int(sizeof(fileName))) { // would open a different (truncated) file
+    if (seg.call == 0) USER_PRINTF("image: segment name \"%s\" is too long for a file name.\n", name);
+    return false;
+  }
+
+  if (!seg.allocateData(sizeof(image_state_t))) return false;
+  image_state_t *st = reinterpret_cast<image_state_t*>(seg.data);
+  const uint8_t segId = strip.getCurrSegmentId();
+  const uint16_t cols = seg.virtualWidth(), rows = seg.virtualHeight();
+  const bool restart = seg.call == 0 || strncmp(st->fileName, fileName, sizeof(st->fileName)) != 0
+                    || st->sheet != bool(seg.check1) || st->cols != cols || st->rows != rows;
+  if (restart) { // new file or layout: start over
+    memset(st, 0, sizeof(image_state_t));
+    strlcpy(st->fileName, fileName, sizeof(st->fileName));
+    st->sheet = seg.check1;
+    st->cols = cols; st->rows = rows;
+    seg.fill(BLACK);
+  }
+  if (strip.now < st->nextFrameTime) { touchImagePlayer(segId, fileName); return true; } // keep current frame
+
+  ImagePlayer *p = getImagePlayer(segId, fileName, restart);
+  if (!p) return false;
+  unsigned long decodeStart = micros();
+
+  int delay = -1; // 1/100 s
+  if (p->cache.ready()) delay = replayFrame(p, st, seg);
+  else {
+    if (!p->lzw) p->lzw = (gif_lzw_t*) malloc(sizeof(gif_lzw_t));
+    if (!p->lzw) {
+      errorFlag = ERR_LOW_MEM;
+      USER_PRINTF("image: out of memory for %u bytes of LZW tables.\n", unsigned(sizeof(gif_lzw_t)));
+    } else {
+      if (!st->valid) {
+        p->reader.seek(0);
+        st->valid = readHeader(p, st);
+      } else if (!st->sheet && p->reader.ofs != st->nextFrameOfs) p->reader.seek(st->nextFrameOfs); // new player
+      if (st->valid) delay = decodeFrame(p, st, seg);
+      if (delay == 0) delay = replayFrame(p, st, seg);
+    }
+    if (p->cache.ready()) { // whole loop in memory: file and LZW tables are no longer needed
+      p->closeFile();
+      if (!st->sheet) st->nextFrameOfs = st->firstFrameOfs; // a new player decodes from the start of the loop
+      DEBUG_PRINTF("image: %s cached, %u frames in %u bytes\n", fileName, p->cache.frames(), unsigned(p->cache.bytes()));
+    }
+  }
+  if (p == &spare) spare.close();
+  if (delay < 0) { st->valid = false; return false; }
+
+  st->decodeUs = micros() - decodeStart;
+  lastDecodeUs = st->decodeUs;
+  // speed slider: 128 = GIF timing, 0 = half speed, 255 = 1.5x speed
+  uint32_t frameMs = (uint32_t(delay) * 10 * 256) / (128 + seg.speed);
+  st->nextFrameTime = strip.now + frameMs;
+  DEBUG_PRINTF("image: %s frame %u shown in %uus\n", fileName, st->frameNo, (unsigned)st->decodeUs);
+  return true;
+}
+
+#endif // WLED_DISABLE_2D
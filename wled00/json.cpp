@@ -69,7 +69,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   #ifndef WLED_DISABLE_2D
     // Serial.printf("before %d: %s %s %s %s\n", id, elem["start"].as<std::string>().c_str(), elem["stop"].as<std::string>().c_str(), elem["startY"].as<std::string>().c_str(), elem["stopY"].as<std::string>().c_str());
   if (strip.isMatrix && !elem["start"].isNull() && !elem["stop"].isNull() && elem["startY"].isNull() && elem["stopY"].isNull()) {
-    uint16_t start1=elem["start"], stop1=elem["stop"];
+    pixidx_t start1=elem["start"], stop1=elem["stop"];
     elem["start"] = start1%Segment::maxWidth;
     elem["startY"]= Segment::maxWidth?(start1 / Segment::maxWidth):0;
     elem["stop"] = (stop1-1)%Segment::maxWidth + 1;
@@ -102,9 +102,9 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   }
 
   Segment& seg = strip.getSegment(id);
-  Segment prev = seg; //make a backup so we can tell if something changed // WLEDMM fixMe: copy constructor = waste of memory
+  const Segment::Snapshot prev = seg.snapshot(); // WLEDMM remember compared fields only, so we can tell if something changed (a full copy would duplicate data and leds)
 
-  uint16_t start = elem["start"] | seg.start;
+  pixidx_t start = elem["start"] | seg.start;
   if (stop < 0) {
     int len = elem["len"]; // WLEDMM bugfix for broken presets with len < 0
     stop = (len > 0) ? start + len : seg.stop;
@@ -119,7 +119,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
     elem.remove("id");  // remove for recursive call
     elem.remove("rpt"); // remove for recursive call
     elem.remove("n");   // remove for recursive call
-    uint16_t len = (stop >= start) ? (stop - start) : 0;  // WLEDMM stop < 1 is allowed, so we need to avoid underflow
+    pixidx_t len = (stop >= int(start)) ? (stop - start) : 0;  // WLEDMM stop < 1 is allowed, so we need to avoid underflow
     for (size_t i=id+1; i<strip.getMaxSegments(); i++) {
       start = start + len;
       if (start >= strip.getLengthTotal()) break;
@@ -165,6 +165,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   uint16_t of  = seg.offset;
   uint8_t  soundSim = elem["si"] | seg.soundSim;
   uint8_t  map1D2D  = elem["m12"] | seg.map1D2D;
+  uint8_t  renderScale = elem[F("rs")] | seg.renderScale; // WLEDMM
 
   //WLEDMM jMap
   if (map1D2D == M12_jMap && !seg.jMap)
@@ -172,16 +173,18 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   if (map1D2D != M12_jMap && seg.jMap)
     seg.deletejMap();
 
-  if ((spc>0 && spc!=seg.spacing) || seg.map1D2D!=map1D2D) seg.fill(BLACK); // clear spacing gaps // WLEDMM softhack007: this line sometimes crashes with "Stack canary watchpoint triggered (async_tcp)"
+  if ((spc>0 && spc!=seg.spacing) || seg.map1D2D!=map1D2D || seg.renderScale!=renderScale) seg.fill(BLACK); // clear spacing gaps // WLEDMM softhack007: this line sometimes crashes with "Stack canary watchpoint triggered (async_tcp)"
 
   seg.map1D2D  = constrain(map1D2D, 0, 7);
   seg.soundSim = constrain(soundSim, 0, 1);
+  seg.renderScale = min(renderScale, uint8_t(2)); // WLEDMM 0 = full, 1 = 1/2, 2 = 1/4 resolution (2D only)
+  seg.refreshGeometry(); // WLEDMM setUp() below may return early
 
   uint8_t set = elem[F("set")] | seg.set;
   seg.set = constrain(set, 0, 3);
 
-  uint16_t len = 1;
-  if (stop > start) len = stop - start;
+  pixidx_t len = 1;
+  if (stop > int(start)) len = stop - start;
   int offset = elem[F("of")] | INT32_MAX;
   if (offset != INT32_MAX) {
     int offsetAbs = abs(offset);
@@ -289,6 +292,9 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   seg.reverse_y  = elem["rY"]  | seg.reverse_y;
   seg.mirror_y   = elem["mY"]  | seg.mirror_y;
   seg.transpose  = elem[F("tp")] | seg.transpose;
+  #endif
+  seg.refreshGeometry(); // WLEDMM mirror/transpose may have changed
+  #ifndef WLED_DISABLE_2D
   if (seg.is2D() && (seg.map1D2D == M12_pArc || seg.map1D2D == M12_sCircle) && (reverse != seg.reverse || reverse_y != seg.reverse_y || mirror != seg.mirror || mirror_y != seg.mirror_y)) seg.fill(BLACK); // clear entire segment (in case of Arc 1D to 2D expansion) WLEDMM: also Circle
   #endif
 
@@ -328,6 +334,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   if (!iarr.isNull()) {
     uint8_t oldMap1D2D = seg.map1D2D;
     seg.map1D2D = M12_Pixels; // no mapping
+    seg.refreshGeometry(); // WLEDMM
 
     // set brightness immediately and disable transition
     transitionDelayTemp = 0;
@@ -373,12 +380,19 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
       }
     }
     seg.map1D2D = oldMap1D2D; // restore mapping
+    seg.refreshGeometry(); // WLEDMM
     strip.trigger(); // force segment update
   }
   // send UDP/WS if segment options changed (except selection; will also deselect current preset)
   if (seg.differs(prev) & 0x7F) {
     stateChanged = true;
-    if ((seg.on == false) && (prev.on == true) && (prev.freeze == false)) prev.fill(BLACK); // WLEDMM: force BLACK if segment was turned off
+    const bool prevOn     = prev.options & (0x01 << SEG_OPTION_ON);
+    const bool prevFrozen = prev.options & (0x01 << SEG_OPTION_FREEZE);
+    if ((seg.on == false) && prevOn && !prevFrozen && seg.isActive()) { // WLEDMM: force BLACK if segment was turned off
+      seg.on = true;  // fill() skips segments that are off; strip service is suspended here
+      seg.fill(BLACK);
+      seg.on = false;
+    }
   }
 
   if (iAmGroot) suspendStripService = false; // WLEDMM release lock
@@ -593,6 +607,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
       char fileName[32];
       sprintf_P(fileName, PSTR("/palette%d.json"), strip.customPalettes.size()-1);
       if (WLED_FS.exists(fileName)) WLED_FS.remove(fileName);
+      WS2812FX::removeCustomPaletteBin(fileName); // WLEDMM
       strip.loadCustomPalettes();
     }
   }
@@ -667,6 +682,7 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
     root["rY"] = seg.reverse_y;
     root["mY"] = seg.mirror_y;
     root[F("tp")] = seg.transpose;
+    root[F("rs")] = seg.renderScale; // WLEDMM
   }
   #endif
   root["o1"]  = seg.check1;
@@ -909,6 +925,22 @@ void serializeInfo(JsonObject root)
   leds[F("pwr")] = strip.currentMilliamps;
   leds["fps"] = strip.getFps();
   leds[F("maxpwr")] = (strip.currentMilliamps)? strip.ablMilliampsMax : 0;
+  leds[F("ablus")] = strip.getAblTime(); // WLEDMM smoothed ABL estimation time (us)
+  JsonArray bwait = leds.createNestedArray(F("buswait")); // WLEDMM per bus: waiting for previous transfer (us)
+  JsonArray bshow = leds.createNestedArray(F("busshow")); // WLEDMM per bus: starting the transfer (us)
+  JsonArray nets = leds.createNestedArray(F("net")); // WLEDMM send statistics per network bus
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
+    bwait.add(busses.getBusWaitTime(b));
+    bshow.add(busses.getBusShowTime(b));
+    Bus *bus = busses.getBus(b);
+    if (bus->getType() < TYPE_NET_DDP_RGB || bus->getType() >= 96) continue;
+    BusNetwork *nb = static_cast<BusNetwork*>(bus);
+    JsonObject net = nets.createNestedObject();
+    net["ip"]  = nb->getClient().toString();
+    net["pk"]  = nb->getPacketsSent();
+    net["err"] = nb->getSendErrors();
+    net["ms"]  = nb->getFrameSendTime();
+  }
   leds[F("maxseg")] = strip.getMaxSegments();
   //leds[F("actseg")] = strip.getActiveSegmentsNum();
   //leds[F("seglock")] = false; //might be used in the future to prevent modifications to segment config
@@ -923,15 +955,24 @@ void serializeInfo(JsonObject root)
 
   uint8_t totalLC = 0;
   JsonArray lcarr = leds.createNestedArray(F("seglc"));
+  JsonArray qarr  = leds.createNestedArray(F("segq"));  // WLEDMM quality level per active segment (0 = full)
+  JsonArray tarr  = leds.createNestedArray(F("segus")); // WLEDMM smoothed render time per active segment (us)
   size_t nSegs = strip.getSegmentsNum();
   for (size_t s = 0; s < nSegs; s++) {
-    if (!strip.getSegment(s).isActive()) continue;
-    uint8_t lc = strip.getSegment(s).getLightCapabilities();
+    Segment &seg = strip.getSegment(s);
+    if (!seg.isActive()) continue;
+    uint8_t lc = seg.getLightCapabilities();
     totalLC |= lc;
     lcarr.add(lc);
+    qarr.add(seg.qualityLevel());
+    tarr.add(seg.renderCost());
   }
 
   leds["lc"] = totalLC;
+  leds[F("ovus")] = getOverlayDrawTime(); // WLEDMM smoothed overlay draw time (us)
+  #ifndef WLED_DISABLE_2D
+  leds[F("imgus")] = getImageDecodeTime(); // WLEDMM decode time of the last image (GIF) frame (us)
+  #endif
 
   leds[F("rgbw")] = strip.hasRGBWBus(); // deprecated, use info.leds.lc
   leds[F("wv")]   = totalLC & 0x02;     // deprecated, true if white slider should be displayed for any segment
@@ -1119,6 +1160,12 @@ void serializeInfo(JsonObject root)
   // end WLEDMM
 
   root[F("uptime")] = millis()/1000 + rolloverMillis*4294967;
+  #ifdef WLEDMM_IDLE_GOVERNOR
+  JsonObject idle = root.createNestedObject(F("idle")); // WLEDMM idle governor statistics
+  idle[F("on")]   = idleActive;
+  idle[F("time")] = (idleTimeTotal + (idleActive ? millis() - idleSince : 0)) / 1000; // seconds spent in idle mode
+  idle[F("cnt")]  = idleCount;
+  #endif
 
   usermods.addToJsonInfo(root);
 
@@ -1380,12 +1427,11 @@ void serializeModeData(JsonArray fxdata)
 {
   char lineBuffer[128];
   for (size_t i = 0; i < strip.getModeCount(); i++) {
-    strncpy_P(lineBuffer, strip.getModeData(i), 127);
-    if (lineBuffer[0] != 0) {
-      char* dataPtr = strchr(lineBuffer,'@');
-      if (dataPtr) fxdata.add(dataPtr+1);
-      else         fxdata.add("");
-    }
+    const mode_meta_t &meta = strip.getModeMeta(i); // WLEDMM data starts right after the name
+    if (!(meta.flags & MODE_META_SLIDERS)) { fxdata.add(""); continue; }
+    strncpy_P(lineBuffer, strip.getModeData(i) + meta.nameLen + 1, sizeof(lineBuffer)-1);
+    lineBuffer[sizeof(lineBuffer)-1] = '\0';
+    fxdata.add(lineBuffer);
   }
 }
 
@@ -1394,12 +1440,10 @@ void serializeModeData(JsonArray fxdata)
 void serializeModeNames(JsonArray arr) {
   char lineBuffer[128];
   for (size_t i = 0; i < strip.getModeCount(); i++) {
-    strncpy_P(lineBuffer, strip.getModeData(i), 127);
-    if (lineBuffer[0] != 0) {
-      char* dataPtr = strchr(lineBuffer,'@');
-      if (dataPtr) *dataPtr = 0; // terminate mode data after name
-      arr.add(lineBuffer);
-    }
+    size_t len = min(size_t(strip.getModeMeta(i).nameLen), sizeof(lineBuffer)-1); // WLEDMM name length known from addEffect()
+    strncpy_P(lineBuffer, strip.getModeData(i), len);
+    lineBuffer[len] = '\0'; // terminate mode data after name
+    if (lineBuffer[0] != 0) arr.add(lineBuffer);
   }
 }
 
@@ -1429,6 +1473,7 @@ class LockedJsonResponse: public AsyncJsonResponse {
 
 void serveJson(AsyncWebServerRequest* request)
 {
+  idleWakeup(); // WLEDMM UI or API activity
   byte subJson = 0;
   const String& url = request->url();
   if      (url.indexOf("state") > 0) subJson = JSON_PATH_STATE;
@@ -1531,8 +1576,8 @@ bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
   }
   #endif
 
-  uint16_t used = strip.getLengthTotal();
-  uint16_t n = (used -1) /MAX_LIVE_LEDS +1; //only serve every n'th LED if count over MAX_LIVE_LEDS
+  pixidx_t used = strip.getLengthTotal();
+  pixidx_t n = (used -1) /MAX_LIVE_LEDS +1; //only serve every n'th LED if count over MAX_LIVE_LEDS
   char buffer[2000];
   strcpy_P(buffer, PSTR("{\"leds\":["));
   obuf = buffer;
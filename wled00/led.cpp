@@ -99,6 +99,7 @@ void applyFinalBri() {
 void stateUpdated(byte callMode) {
   //call for notifier -> 0: init 1: direct change 2: button 3: notification 4: nightlight 5: other (No notification)
   //                     6: fx changed 7: hue 8: preset cycle 9: blynk 10: alexa 11: ws send only 12: button preset
+  idleWakeup(); // WLEDMM
   setValuesFromFirstSelectedSeg();
 
   if (bri != briOld || stateChanged) {
@@ -0,0 +1,144 @@
+#ifndef NET_PACKETS_H
+#define NET_PACKETS_H
+
+/*
+ * WLEDMM packet layouts of the realtime network outputs (udp.cpp, used by the network busses).
+ * Only builds bytes in a caller supplied buffer; sending stays in udp.cpp.
+ * Plain C++ without Arduino dependencies, checked on the host by a listener that parses the packets (see test/test_net_packets)
+ * and benchmarked over UDP loopback (test/test_ddp_throughput).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+static inline void putU16(uint8_t *p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; }
+static inline void putU32(uint8_t *p, uint32_t v) { putU16(p, v >> 16); putU16(p + 2, v & 0xFFFF); }
+
+// copy channel data with brightness applied (same result as FastLED scale8() with FASTLED_SCALE8_FIXED)
+static inline void netFillChannels(uint8_t *dest, const uint8_t *src, size_t len, uint8_t bri) {
+  if (bri == 255) { memcpy(dest, src, len); return; }
+  for (size_t i = 0; i < len; i++) dest[i] = (uint16_t(src[i]) * (uint16_t(bri) + 1)) >> 8;
+}
+
+// DDP (http://www.3waylabs.com/ddp/)
+#define DDP_HEADER_LEN 10
+#define DDP_SYNCPACKET_LEN 10
+
+#define DDP_FLAGS1_VER 0xc0  // version mask
+#define DDP_FLAGS1_VER1 0x40 // version=1
+#define DDP_FLAGS1_PUSH 0x01
+#define DDP_FLAGS1_QUERY 0x02
+#define DDP_FLAGS1_REPLY 0x04
+#define DDP_FLAGS1_STORAGE 0x08
+#define DDP_FLAGS1_TIME 0x10
+
+#define DDP_ID_DISPLAY 1
+#define DDP_ID_CONFIG 250
+#define DDP_ID_STATUS 251
+
+// 1440 channels per packet
+#define DDP_CHANNELS_PER_PACKET 1440 // 480 leds
+
+#ifndef DDP_TYPE_RGB24 // same as ESPAsyncE131.h
+  #define DDP_TYPE_RGB24  0x0B // 00 001 011 (RGB , 8 bits per channel, 3 channels)
+  #define DDP_TYPE_RGBW32 0x1B // 00 011 011 (RGBW, 8 bits per channel, 4 channels)
+#endif
+
+// header of a DDP data packet carrying len channels from byte offset; the channels follow the header
+static inline size_t ddpDataHeader(uint8_t *p, bool push, uint8_t sequence, bool rgbw, uint32_t offset, uint16_t len) {
+  p[0] = push ? DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH : DDP_FLAGS1_VER1;
+  p[1] = sequence & 0x0F;
+  p[2] = rgbw ? DDP_TYPE_RGBW32 : DDP_TYPE_RGB24;
+  p[3] = DDP_ID_DISPLAY;
+  putU32(p + 4, offset); // data offset in bytes, MSB first
+  putU16(p + 8, len);    // data length in bytes, MSB first
+  return DDP_HEADER_LEN;
+}
+
+// push without data: displays what was sent before
+static inline size_t ddpPushPacket(uint8_t *p) {
+  memset(p, 0, DDP_SYNCPACKET_LEN);
+  p[0] = DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH;
+  p[3] = DDP_ID_DISPLAY;
+  return DDP_SYNCPACKET_LEN;
+}
+
+// E1.31 (sACN) packet offsets, same as ESPAsyncE131.h
+#ifndef E131_ROOT_FLENGTH
+  #define E131_ROOT_ID 4
+  #define E131_ROOT_FLENGTH 16
+  #define E131_ROOT_VECTOR 18
+  #define E131_ROOT_CID 22
+  #define E131_FRAME_FLENGTH 38
+  #define E131_FRAME_VECTOR 40
+  #define E131_FRAME_SOURCE 44
+  #define E131_FRAME_PRIORITY 108
+  #define E131_FRAME_RESERVED 109
+  #define E131_FRAME_SEQ 111
+  #define E131_FRAME_OPT 112
+  #define E131_FRAME_UNIVERSE 113
+  #define E131_DMP_FLENGTH 115
+  #define E131_DMP_VECTOR 117
+  #define E131_DMP_TYPE 118
+  #define E131_DMP_ADDR_FIRST 119
+  #define E131_DMP_ADDR_INC 121
+  #define E131_DMP_COUNT 123
+  #define E131_DMP_DATA 125
+#endif
+#define E131_OUT_HEADER_LEN  126  // incl. DMX start code
+#define E131_SYNC_PACKET_LEN 49
+#define E131_SYNC_SEQ        44   // sync packet: sequence number and synchronization address
+#define E131_SYNC_UNIVERSE   45
+#define E131_CID_LEN         16
+#define E131_SOURCE_LEN      64
+#define E131_MAX_UNIVERSE    63999
+
+// root layer shared by data and sync packets (lengths are patched in per packet)
+static inline void e131RootLayer(uint8_t *p, uint32_t vector, const uint8_t *cid) {
+  putU16(p, 0x0010);                                      // preamble size
+  putU16(p + 2, 0x0000);                                  // postamble size
+  memcpy(p + E131_ROOT_ID, "ASC-E1.17\0\0\0", 12);        // ACN packet identifier
+  putU32(p + E131_ROOT_VECTOR, vector);
+  memcpy(p + E131_ROOT_CID, cid, E131_CID_LEN);
+}
+
+// everything of a data packet that stays the same within a frame; syncUniverse 0 = no synchronization
+static inline void e131DataHeader(uint8_t *p, const uint8_t *cid, const char *source, uint8_t priority, uint16_t syncUniverse) {
+  memset(p, 0, E131_OUT_HEADER_LEN);
+  e131RootLayer(p, 0x00000004, cid);                      // VECTOR_ROOT_E131_DATA
+  putU32(p + E131_FRAME_VECTOR, 0x00000002);              // VECTOR_E131_DATA_PACKET
+  for (size_t i = 0; i < E131_SOURCE_LEN - 1 && source[i]; i++) p[E131_FRAME_SOURCE + i] = source[i]; // null terminated
+  p[E131_FRAME_PRIORITY] = priority;
+  putU16(p + E131_FRAME_RESERVED, syncUniverse);          // synchronization address
+  p[E131_DMP_VECTOR] = 0x02;                              // VECTOR_DMP_SET_PROPERTY
+  p[E131_DMP_TYPE]   = 0xA1;                              // address & data type
+  putU16(p + E131_DMP_ADDR_INC, 1);
+}
+
+// per packet part of a data packet whose header was copied from e131DataHeader(); channels follow the header
+// (at most 512). Returns the packet length.
+static inline size_t e131DataPacket(uint8_t *p, uint16_t universe, uint8_t sequence, size_t channels) {
+  size_t len = E131_OUT_HEADER_LEN + channels;
+  putU16(p + E131_ROOT_FLENGTH,  0x7000 | (len - E131_ROOT_FLENGTH));
+  putU16(p + E131_FRAME_FLENGTH, 0x7000 | (len - E131_FRAME_FLENGTH));
+  p[E131_FRAME_SEQ] = sequence;
+  putU16(p + E131_FRAME_UNIVERSE, universe);
+  putU16(p + E131_DMP_FLENGTH,   0x7000 | (len - E131_DMP_FLENGTH));
+  putU16(p + E131_DMP_COUNT, channels + 1);               // incl. start code
+  return len;
+}
+
+// universe synchronization packet, returns the packet length
+static inline size_t e131SyncPacket(uint8_t *p, const uint8_t *cid, uint8_t sequence, uint16_t syncUniverse) {
+  memset(p, 0, E131_SYNC_PACKET_LEN);
+  e131RootLayer(p, 0x00000008, cid);                      // VECTOR_ROOT_E131_EXTENDED
+  putU16(p + E131_ROOT_FLENGTH,  0x7000 | (E131_SYNC_PACKET_LEN - E131_ROOT_FLENGTH));
+  putU16(p + E131_FRAME_FLENGTH, 0x7000 | (E131_SYNC_PACKET_LEN - E131_FRAME_FLENGTH));
+  putU32(p + E131_FRAME_VECTOR, 0x00000001);              // VECTOR_E131_EXTENDED_SYNCHRONIZATION
+  p[E131_SYNC_SEQ] = sequence;
+  putU16(p + E131_SYNC_UNIVERSE, syncUniverse);
+  return E131_SYNC_PACKET_LEN;
+}
+
+#endif
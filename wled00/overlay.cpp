@@ -4,12 +4,39 @@
  * Used to draw clock overlays over the strip
  */
 
-void _overlayAnalogClock()
+static OverlayLayer clockLayer; // WLEDMM analog clock is redrawn once per second only
+static uint16_t overlayDrawUs = 0;
+
+bool OverlayLayer::changed(uint32_t key) {
+  if (_valid && key == _key) return false;
+  _key = key;
+  _valid = true;
+  _runs.clear();
+  return true;
+}
+
+void OverlayLayer::setRange(pixidx_t i, pixidx_t i2, uint32_t c) {
+  if (i2 < i) std::swap(i, i2);
+  if (!_runs.empty()) { // extend previous run if adjacent with same color
+    Run &last = _runs.back();
+    if (last.color == c && last.start + last.len == i) { last.len += i2 - i + 1; return; }
+  }
+  _runs.push_back({i, pixidx_t(i2 - i + 1), c});
+}
+
+void OverlayLayer::apply(void) const {
+  for (const Run &r : _runs)
+    for (pixidx_t i = r.start; i < r.start + r.len; i++) strip.setPixelColor(i, r.color);
+}
+
+uint16_t getOverlayDrawTime() { return overlayDrawUs; }
+
+void _overlayAnalogClock(OverlayLayer &layer)
 {
   int overlaySize = overlayMax - overlayMin +1;
   if (countdownMode)
   {
-    _overlayAnalogCountdown(); return;
+    _overlayAnalogCountdown(layer); return;
   }
   float hourP = ((float)(hour(localTime)%12))/12.0f;
   float minuteP = ((float)minute(localTime))/60.0f;
@@ -25,11 +52,11 @@ void _overlayAnalogClock()
   {
     if (secondPixel < analogClock12pixel)
     {
-      strip.setRange(analogClock12pixel, overlayMax, 0xFF0000);
-      strip.setRange(overlayMin, secondPixel, 0xFF0000);
+      layer.setRange(analogClock12pixel, overlayMax, 0xFF0000);
+      layer.setRange(overlayMin, secondPixel, 0xFF0000);
     } else
     {
-      strip.setRange(analogClock12pixel, secondPixel, 0xFF0000);
+      layer.setRange(analogClock12pixel, secondPixel, 0xFF0000);
     }
   }
   if (analogClock5MinuteMarks)
@@ -38,16 +65,16 @@ void _overlayAnalogClock()
     {
       int pix = analogClock12pixel + roundf((overlaySize / 12.0f) *i);
       if (pix > overlayMax) pix -= overlaySize;
-      strip.setPixelColor(pix, 0x00FFAA);
+      layer.setPixelColor(pix, 0x00FFAA);
     }
   }
-  if (!analogClockSecondsTrail) strip.setPixelColor(secondPixel, 0xFF0000);
-  strip.setPixelColor(minutePixel, 0x00FF00);
-  strip.setPixelColor(hourPixel, 0x0000FF);
+  if (!analogClockSecondsTrail) layer.setPixelColor(secondPixel, 0xFF0000);
+  layer.setPixelColor(minutePixel, 0x00FF00);
+  layer.setPixelColor(hourPixel, 0x0000FF);
 }
 
 
-void _overlayAnalogCountdown()
+void _overlayAnalogCountdown(OverlayLayer &layer)
 {
   if ((unsigned long)toki.second() < countdownTime)
   {
@@ -78,18 +105,26 @@ void _overlayAnalogCountdown()
     byte pixelCnt = perc*overlaySize;
     if (analogClock12pixel + pixelCnt > overlayMax)
     {
-      strip.setRange(analogClock12pixel, overlayMax, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
-      strip.setRange(overlayMin, overlayMin +pixelCnt -(1+ overlayMax -analogClock12pixel), ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
+      layer.setRange(analogClock12pixel, overlayMax, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
+      layer.setRange(overlayMin, overlayMin +pixelCnt -(1+ overlayMax -analogClock12pixel), ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
     } else
     {
-      strip.setRange(analogClock12pixel, analogClock12pixel + pixelCnt, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
+      layer.setRange(analogClock12pixel, analogClock12pixel + pixelCnt, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
     }
   }
 }
 
 void handleOverlayDraw() {
+  unsigned long drawStart = micros(); // WLEDMM
   usermods.handleOverlayDraw();
-  if (overlayCurrent == 1) _overlayAnalogClock();
+  if (overlayCurrent == 1) {
+    // WLEDMM clock face only changes with time (seconds) or settings
+    uint32_t key = (countdownMode ? toki.second() : localTime) ^ (uint32_t(overlayMin) << 8) ^ (uint32_t(overlayMax) << 16) ^ (uint32_t(analogClock12pixel) << 24)
+                 ^ (analogClockSecondsTrail << 1) ^ (analogClock5MinuteMarks << 2) ^ (countdownMode << 3);
+    if (clockLayer.changed(key)) _overlayAnalogClock(clockLayer);
+    clockLayer.apply();
+  } else clockLayer.invalidate();
+  overlayDrawUs = (uint32_t(overlayDrawUs) * 7 + min(micros() - drawStart, 65535UL)) >> 3;
 }
 
 /*
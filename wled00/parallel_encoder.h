@@ -0,0 +1,91 @@
+#ifndef PARALLEL_ENCODER_H
+#define PARALLEL_ENCODER_H
+
+/*
+ * WLEDMM bit-transpose encoder for parallel LED output: up to 8 or 16 strips (lanes) on one parallel data bus
+ * (ESP32 I2S or ESP32-S3 LCD peripheral in 8/16 bit mode). Each sample of the bus holds one bit per lane, so the
+ * wire bytes of all lanes are transposed (8 x 8 bit blocks) and every bit is spread over three samples:
+ * high, data, low. At a sample clock of 2.4 MHz this is WS281x timing (0 = 417/833ns, 1 = 833/417ns).
+ * Lanes hold wire bytes (color order and brightness already applied), RGB and RGBW lanes can be mixed.
+ * Plain C++ without Arduino or IDF dependencies, tested against a reference encoder and benchmarked on the host
+ * (see test/test_parallel_encoder).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PAR_SLOTS_PER_BIT 3        // samples per bit on the wire
+#define PAR_SAMPLE_HZ     2400000  // sample clock for 800 kbps
+
+// 8 x 8 bit matrix transpose: bit c of byte r ends up as bit r of byte c
+static inline uint64_t parTranspose8(uint64_t x) {
+  uint64_t t;
+  t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL; x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x ^= t ^ (t << 28);
+  return x;
+}
+
+// WORD: uint8_t for 8 lanes, uint16_t for 16 lanes (one bus sample, bit n = lane n)
+template <typename WORD>
+class ParallelEncoder {
+  public:
+    static const uint8_t LANES = sizeof(WORD) * 8;
+
+    // wire bytes of a lane (len = LEDs * 3 or 4); nullptr or len 0 leaves the lane low
+    bool setLane(uint8_t lane, const uint8_t *data, size_t len) {
+      if (lane >= LANES) return false;
+      _data[lane] = len ? data : nullptr;
+      _len[lane]  = data ? len : 0;
+      _size = 0; _minLen = SIZE_MAX; _used = 0;
+      for (uint8_t i = 0; i < LANES; i++) {
+        if (!_data[i]) continue;
+        _used |= WORD(1) << i;
+        if (_len[i] > _size) _size = _len[i];
+        if (_len[i] < _minLen) _minLen = _len[i];
+      }
+      if (!_used) _minLen = 0;
+      return true;
+    }
+
+    size_t size() const { return _size; }  // wire bytes of the longest lane
+    static size_t samples(size_t bytes) { return bytes * 8 * PAR_SLOTS_PER_BIT; }
+
+    // encodes wire bytes [ofs, ofs+count) of all lanes into samples(count) words (e.g. one DMA buffer),
+    // returns the number of bytes encoded. Lanes that are shorter stay low once their data ends.
+    size_t encode(size_t ofs, size_t count, WORD *out) const {
+      if (ofs >= _size) return 0;
+      if (count > _size - ofs) count = _size - ofs;
+      for (size_t pos = ofs; pos < ofs + count; pos++) {
+        const bool all = pos < _minLen;   // every used lane has a byte here
+        WORD active = all ? _used : 0;
+        uint64_t bits[LANES / 8];
+        for (uint8_t g = 0; g < LANES / 8; g++) {
+          uint64_t x = 0;
+          for (uint8_t l = 0; l < 8; l++) {
+            const uint8_t lane = g * 8 + l;
+            if (all ? !_data[lane] : pos >= _len[lane]) continue;
+            x |= uint64_t(_data[lane][pos]) << (8 * l);
+            if (!all) active |= WORD(1) << lane;
+          }
+          bits[g] = parTranspose8(x);   // byte b = bit b of every lane of the group
+        }
+        for (int b = 7; b >= 0; b--) {  // MSB first
+          WORD data = 0;
+          for (uint8_t g = 0; g < LANES / 8; g++) data |= WORD(uint8_t(bits[g] >> (8 * b))) << (8 * g);
+          *out++ = active;
+          *out++ = data;
+          *out++ = 0;
+        }
+      }
+      return count;
+    }
+
+  private:
+    const uint8_t *_data[LANES] = {};
+    size_t _len[LANES] = {};
+    size_t _size = 0, _minLen = 0;
+    WORD   _used = 0;
+};
+
+#endif
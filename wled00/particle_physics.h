@@ -0,0 +1,125 @@
+#ifndef PARTICLE_PHYSICS_H
+#define PARTICLE_PHYSICS_H
+
+/*
+ * WLEDMM physics of the shared particle engine for effects (popcorn, drip, exploding fireworks, ...).
+ * Fixed-point positions and velocities, particles live in a caller supplied pool (SEGENV.data in effects).
+ * Allocation and drawing are in ParticleSystem (FX.h), which adds the Segment dependent parts.
+ * Plain C++ without Arduino dependencies, tested and benchmarked on the host (see test/test_particle_physics).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Positions and velocities are in 1/PS_ONE pixel (per frame). 1D effects use x only; gravity and friction are applied in batch by update().
+#define PS_SHIFT 14  // 1/16384 pixel, keeps gravity of short strips within 1% (positions up to 65535 pixels fit int32_t)
+#define PS_ONE   (1 << PS_SHIFT)
+// particle states: values >= PS_STATE_MOVING are free for effects to use (e.g. falling/bouncing)
+#define PS_STATE_FREE    0  // unused slot
+#define PS_STATE_RESTING 1  // alive, but not moved by update()
+#define PS_STATE_MOVING  2
+// what update() does when a particle leaves the segment
+#define PS_EDGE_FREE   0    // release the particle
+#define PS_EDGE_CLAMP  1    // stop at the edge (velocity kept, effect decides)
+#define PS_EDGE_BOUNCE 2    // reflect, velocity scaled by bounce/256
+#define PS_EDGE_NONE   3    // keep moving outside (not drawn, may come back)
+
+// pixels (or pixels per frame) to fixed point, rounded: truncating would bias slow gravity by up to one step
+static inline int32_t psFixed(float v) { return int32_t(v * PS_ONE + (v < 0.0f ? -0.5f : 0.5f)); }
+
+typedef struct PSParticle {
+  int32_t x, y;       // position
+  int32_t vx, vy;     // velocity
+  uint8_t state;      // PS_STATE_*
+  uint8_t colIndex;   // palette index or color slot
+  uint8_t bri;        // brightness (used by effects, e.g. swelling drops)
+  uint8_t aux;        // effect defined
+} ps_particle_t;      // 20 bytes
+
+class ParticlePhysics {
+  public:
+    ps_particle_t *particles;
+    uint16_t count;
+    int32_t  gravityX = 0, gravityY = 0; // added to velocity each frame
+    uint8_t  friction = 0;               // velocity loss per frame (x/256)
+    uint8_t  edge     = PS_EDGE_FREE;
+    uint8_t  bounce   = 255;             // velocity kept on PS_EDGE_BOUNCE (x/256)
+    int32_t  maxX, maxY;                 // exclusive bounds (PS_ONE per pixel)
+
+    ParticlePhysics(ps_particle_t *p, uint16_t n, uint16_t w, uint16_t h = 1) : particles(p), count(n), maxX(int32_t(w) << PS_SHIFT), maxY(int32_t(h) << PS_SHIFT) {}
+
+    // particle pool size for a segment: one particle per pixelsPer pixels, within [minCount, maxCount]
+    static uint16_t capacityFor(uint32_t pixels, uint16_t pixelsPer, uint16_t minCount, uint16_t maxCount) {
+      uint32_t n = pixels / (pixelsPer > 0 ? pixelsPer : 1);
+      return n < minCount ? minCount : (n > maxCount ? maxCount : n);
+    }
+
+    // first free slot below maxUsed, nullptr if none
+    ps_particle_t* emit(int32_t x, int32_t y, int32_t vx, int32_t vy, uint8_t colIndex, uint16_t maxUsed = UINT16_MAX) {
+      const uint16_t n = count < maxUsed ? count : maxUsed;
+      for (size_t i = 0; i < n; i++) {
+        ps_particle_t &p = particles[i];
+        if (p.state != PS_STATE_FREE) continue;
+        p.x = x; p.y = y; p.vx = vx; p.vy = vy;
+        p.state = PS_STATE_MOVING;
+        p.colIndex = colIndex;
+        p.bri = 255;
+        p.aux = 0;
+        return &p;
+      }
+      return nullptr;
+    }
+
+    // one pass over the pool below maxUsed: movement, then gravity and friction, then edge handling.
+    // Moving before accelerating is the order of the float code the effects used before (pos += vel; vel += gravity).
+    void update(uint16_t maxUsed = UINT16_MAX) {
+      const uint16_t n = count < maxUsed ? count : maxUsed;
+      if (maxY <= PS_ONE) { // 1D: x only
+        for (size_t i = 0; i < n; i++) {
+          ps_particle_t &p = particles[i];
+          if (p.state < PS_STATE_MOVING) continue;
+          p.x += p.vx;
+          p.vx += gravityX;
+          if (friction) p.vx -= (p.vx * friction) >> 8;
+          if (uint32_t(p.x) >= uint32_t(maxX)) edgeHit(p, true, false); // also catches x < 0
+        }
+        return;
+      }
+      for (size_t i = 0; i < n; i++) {
+        ps_particle_t &p = particles[i];
+        if (p.state < PS_STATE_MOVING) continue;
+        p.x += p.vx;
+        p.y += p.vy;
+        p.vx += gravityX;
+        p.vy += gravityY;
+        if (friction) {
+          p.vx -= (p.vx * friction) >> 8;
+          p.vy -= (p.vy * friction) >> 8;
+        }
+        bool outX = uint32_t(p.x) >= uint32_t(maxX);
+        bool outY = uint32_t(p.y) >= uint32_t(maxY);
+        if (outX || outY) edgeHit(p, outX, outY);
+      }
+    }
+
+  private:
+    void edgeHit(ps_particle_t &p, bool outX, bool outY) const {
+      switch (edge) {
+        case PS_EDGE_NONE:
+          break;
+        case PS_EDGE_FREE:
+          p.state = PS_STATE_FREE;
+          break;
+        case PS_EDGE_BOUNCE:
+          if (outX) p.vx = -((p.vx * bounce) >> 8);
+          if (outY) p.vy = -((p.vy * bounce) >> 8);
+          // fall through
+        default: // PS_EDGE_CLAMP
+          if (outX) p.x = p.x < 0 ? 0 : maxX - 1;
+          if (outY) p.y = p.y < 0 ? 0 : maxY - 1;
+          break;
+      }
+    }
+};
+
+#endif
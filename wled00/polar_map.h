@@ -0,0 +1,45 @@
+#ifndef POLAR_MAP_H
+#define POLAR_MAP_H
+
+/*
+ * WLEDMM polar coordinates of each pixel of a 2D canvas relative to a centre (see WS2812FX::getPolarMap()).
+ * 2 bytes per pixel, same size as the per-segment map Octopus used to keep in SEGENV.data.
+ * Plain C++ on top of the fast math in wled_math.cpp, tested on the host (see test/test_polar_map).
+ */
+
+#include <stdint.h>
+
+#define POLAR_RADIUS_SCALE 128  // radius unit: longest canvas side / 128 (max. radius sqrt(2)*128 = 181 fits 8 bit)
+#define POLAR_MAX_DIM      2047 // larger canvases overflow the squared distance
+
+typedef struct PolarCoord {
+  uint8_t angle;   // atan2(y - cy, x - cx), 256 = full turn
+  uint8_t radius;  // distance to centre, in units of max(cols, rows) / POLAR_RADIUS_SCALE
+} polar_t;
+
+uint16_t atan2_16_t(int32_t y, int32_t x); // wled_math.cpp
+uint32_t sqrt32_t(uint32_t x);
+
+// fills cols*rows entries, index x + y*cols
+static inline void fillPolarMap(polar_t *p, uint16_t cols, uint16_t rows, int16_t cx, int16_t cy) {
+  const uint32_t maxDim = (cols > rows) ? cols : rows;
+  for (int y = 0; y < rows; y++) {
+    const int dy = y - cy;
+    for (int x = 0; x < cols; x++, p++) {
+      const int dx = x - cx;
+      p->angle = (atan2_16_t(dy, dx) + 128) >> 8;                        // rounded, 256 wraps to 0
+      const uint32_t d2 = uint32_t(dx*dx + dy*dy) << 8;                   // squared distance in 1/16 pixel
+      uint32_t h = sqrt32_t(d2);
+      if (d2 - h*h > h) h++;                                              // rounded instead of truncated
+      uint32_t r = (h * (POLAR_RADIUS_SCALE / 16) + maxDim/2) / maxDim;
+      p->radius = (r > 255) ? 255 : r;                                    // only if the centre is outside the canvas
+    }
+  }
+}
+
+// radius in pixels * scale (i.e. scale = 1 for pixels), from a map of a canvas whose longest side is maxDim
+static inline uint32_t polarRadius(const polar_t &p, uint16_t maxDim, uint16_t scale) {
+  return (uint32_t(p.radius) * maxDim * scale + POLAR_RADIUS_SCALE/2) / POLAR_RADIUS_SCALE;
+}
+
+#endif
@@ -96,7 +96,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     }
 
     uint8_t colorOrder, type, skip, awmode, channelSwap;
-    uint16_t length, start;
+    uint16_t length;
+    pixidx_t start;
     uint8_t pins[5] = {255, 255, 255, 255, 255};
 
     autoSegments = request->hasArg(F("MS"));
@@ -107,6 +108,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     Bus::setGlobalAWMode(request->arg(F("AW")).toInt());
     strip.setTargetFps(request->arg(F("FR")).toInt());
     strip.useLedsArray = request->hasArg(F("LD"));
+    strip.adaptiveQuality = request->hasArg(F("AQ")); // WLEDMM
 
     bool busesChanged = false;
     for (uint8_t s = 0; s < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; s++) {
@@ -121,6 +123,9 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       char aw[4] = "AW"; aw[2] = 48+s; aw[3] = 0; //auto white mode
       char wo[4] = "WO"; wo[2] = 48+s; wo[3] = 0; //channel swap
       char sp[4] = "SP"; sp[2] = 48+s; sp[3] = 0; //bus clock speed (DotStar & PWM)
+      char ma[4] = "MA"; ma[2] = 48+s; ma[3] = 0; //WLEDMM own current budget of this bus
+      char il[4] = "IL"; il[2] = 48+s; il[3] = 0; //WLEDMM LEDs per power injection group
+      char un[4] = "UN"; un[2] = 48+s; un[3] = 0; //WLEDMM E1.31 start universe
       if (!request->hasArg(lp)) {
         DEBUG_PRINT(F("No data for "));
         DEBUG_PRINTLN(s);
@@ -169,6 +174,9 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       // this may happen even before this loop is finished so we do "doInitBusses" after the loop
       if (busConfigs[s] != nullptr) delete busConfigs[s];
       busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder | (channelSwap<<4), request->hasArg(cv), skip, awmode, freqHz);
+      busConfigs[s]->milliAmpsMax = request->arg(ma).toInt(); // WLEDMM submitted with the bus it belongs to
+      busConfigs[s]->injectLen    = request->arg(il).toInt();
+      busConfigs[s]->universe     = request->hasArg(un) ? request->arg(un).toInt() : 1;
       busesChanged = true;
     }
     //doInitBusses = busesChanged; // we will do that below to ensure all input data is processed
@@ -243,6 +251,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     touchThreshold = request->arg(F("TT")).toInt();
 
     strip.ablMilliampsMax = request->arg(F("MA")).toInt();
+    t = request->arg(F("SY")).toInt();  // WLEDMM E1.31 output sync universe
+    e131OutSyncUniverse = (t > 0 && t <= E131_MAX_UNIVERSE) ? t : 0;
     strip.milliampsPerLed = request->arg(F("LA")).toInt();
 
     briS = request->arg(F("CA")).toInt();
@@ -858,8 +868,8 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   byte check1In    = selseg.check1;
   byte check2In    = selseg.check2;
   byte check3In    = selseg.check3;
-  uint16_t startI  = selseg.start;
-  uint16_t stopI   = selseg.stop;
+  pixidx_t startI  = selseg.start;
+  pixidx_t stopI   = selseg.stop;
   uint16_t startY  = selseg.startY;
   uint16_t stopY   = selseg.stopY;
   uint8_t  grpI    = selseg.grouping;
@@ -888,6 +898,7 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
 
   pos = req.indexOf(F("MI=")); //Segment mirror
   if (pos > 0) selseg.mirror = req.charAt(pos+3) != '0';
+  selseg.refreshGeometry(); // WLEDMM
 
   pos = req.indexOf(F("SB=")); //Segment brightness/opacity
   if (pos > 0) {
@@ -1,4 +1,5 @@
 #include "wled.h"
+#include "net_packets.h"  // WLEDMM DDP and E1.31 packet layouts
 
 /*
  * UDP sync notifier / Realtime / Hyperion / TPM2.NET
@@ -282,7 +283,7 @@ void handleNotifications()
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) {return;}
 #endif
       uint16_t id = 0;
-      uint16_t totalLen = strip.getLengthTotal();
+      pixidx_t totalLen = strip.getLengthTotal();
       for (int i = 0; i < packetSize -2; i += 3)
       {
         setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
@@ -443,6 +444,7 @@ void handleNotifications()
           } else {
             selseg.setUp(selseg.start, selseg.stop, udpIn[5+ofs], udpIn[6+ofs], selseg.offset, selseg.startY, selseg.stopY);
           }
+          selseg.refreshGeometry(); // WLEDMM options were changed directly
         }
         stateChanged = true;
       }
@@ -529,7 +531,7 @@ void handleNotifications()
     byte numPackets = udpIn[5];
 
     uint16_t id = (tpmPayloadFrameSize/3)*(packetNum-1); //start LED
-    uint16_t totalLen = strip.getLengthTotal();
+    pixidx_t totalLen = strip.getLengthTotal();
     for (size_t i = 6; i < tpmPayloadFrameSize + 4U; i += 3)
     {
       if (id < totalLen)
@@ -563,7 +565,7 @@ void handleNotifications()
     }
     if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
-    uint16_t totalLen = strip.getLengthTotal();
+    pixidx_t totalLen = strip.getLengthTotal();
     if (udpIn[0] == 1 && packetSize > 5) //warls
     {
       for (int i = 2; i < packetSize -3; i += 4)
@@ -629,9 +631,9 @@ void handleNotifications()
 }
 
 
-void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
+void setRealtimePixel(pixidx_t i, byte r, byte g, byte b, byte w)
 {
-  uint16_t pix = i + arlsOffset;
+  pixidx_t pix = i + arlsOffset;
   if (pix < strip.getLengthTotal()) {
     if (!arlsDisableGammaCorrection && gammaCorrectCol) {
       r = gamma8(r);
@@ -731,165 +733,169 @@ void sendSysInfoUDP()
  * Art-Net, DDP, E131 output - work in progress
 \*********************************************************************************************/
 
-#define DDP_HEADER_LEN 10
-#define DDP_SYNCPACKET_LEN 10
+static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
+static const size_t ART_NET_HEADER_SIZE = 12;
+static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
+
+// WLEDMM packets are built in one preallocated buffer and sent with a single write over a persistent socket
+// (a WiFiUDP object per call opened and closed a socket per frame, and byte-wise write() dominated the send time)
+static const size_t ART_NET_PACKET_HEADER = ART_NET_HEADER_SIZE + 6;
+static WiFiUDP netUdp;
+static uint8_t netPacket[DDP_HEADER_LEN + DDP_CHANNELS_PER_PACKET];  // also fits Art-Net (18 + 512)
 
-#define DDP_FLAGS1_VER 0xc0  // version mask
-#define DDP_FLAGS1_VER1 0x40 // version=1
-#define DDP_FLAGS1_PUSH 0x01
-#define DDP_FLAGS1_QUERY 0x02
-#define DDP_FLAGS1_REPLY 0x04
-#define DDP_FLAGS1_STORAGE 0x08
-#define DDP_FLAGS1_TIME 0x10
+static bool sendPacket(IPAddress client, uint16_t port, size_t len) {
+  if (!netUdp.beginPacket(client, port)) return false;
+  netUdp.write(netPacket, len);
+  return netUdp.endPacket();
+}
+
+// E1.31 (sACN) output. The root, framing and DMP headers are built once per frame; per packet only universe,
+// lengths and sequence number are patched in (net_packets.h). Each network bus has its own start universe and
+// sequence counter, each universe carries up to 510 (RGB) or 512 (RGBW) channels.
+// With e131OutSyncUniverse != 0 receivers hold the data until the sync packet sent after the last universe.
+static uint8_t e131Header[E131_OUT_HEADER_LEN];
+static uint8_t e131Cid[E131_CID_LEN];
+static uint8_t e131Sequence = 0;  // for callers without their own sequence counter
+
+// CID is "WLED" followed by the MAC address
+static void e131BuildCid() {
+  memcpy_P(e131Cid, PSTR("WLED"), 4);
+  memset(e131Cid + 4, '0', 12);
+  memcpy(e131Cid + 4, escapedMac.c_str(), min(escapedMac.length(), 12U));
+}
 
-#define DDP_ID_DISPLAY 1
-#define DDP_ID_CONFIG 250
-#define DDP_ID_STATUS 251
+static void e131BuildHeader() {
+  e131BuildCid();
+  e131DataHeader(e131Header, e131Cid, serverDescription, e131Priority ? e131Priority : 100, e131OutSyncUniverse);
+}
 
-// 1440 channels per packet
-#define DDP_CHANNELS_PER_PACKET 1440 // 480 leds
+static bool e131SendUniverse(IPAddress client, uint16_t universe, uint8_t sequence, const uint8_t *data, size_t channels, uint8_t bri) {
+  memcpy(netPacket, e131Header, E131_OUT_HEADER_LEN);
+  size_t len = e131DataPacket(netPacket, universe, sequence, channels);
+  netFillChannels(netPacket + E131_OUT_HEADER_LEN, data, channels, bri);
+  return sendPacket(client, E131_DEFAULT_PORT, len);
+}
+
+static bool e131SendSync(IPAddress client, uint8_t sequence) {
+  e131BuildCid();
+  return sendPacket(client, E131_DEFAULT_PORT, e131SyncPacket(netPacket, e131Cid, sequence, e131OutSyncUniverse));
+}
+
+static size_t channelsPerPacket(uint8_t type, bool isRGBW) {
+  if (type == 0) return DDP_CHANNELS_PER_PACKET;
+  return isRGBW ? 512 : 510; // E1.31 / Art-Net: whole pixels per universe, 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
+}
+
+// number of UDP packets needed for one frame
+uint16_t realtimePacketCount(uint8_t type, uint16_t length, bool isRGBW) {
+  size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B,(W?) value
+  if (channelCount == 0) return 0;
+  return ((channelCount-1) / channelsPerPacket(type, isRGBW)) +1;
+}
 
 //
-// Send real time UDP updates to the specified client
+// Send one real time UDP packet of a frame to the specified client
 //
 // type   - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
 // client - the IP address to send to
 // length - the number of pixels
 // buffer - a buffer of at least length*4 bytes long
 // isRGBW - true if the buffer contains 4 components per pixel
-
-static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
-static const size_t ART_NET_HEADER_SIZE = 12;
-static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
-
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
+// packet - packet number within the frame (0 starts a new frame)
+// push   - DDP: set the push flag on the last packet (false if realtimeSendSync() follows)
+// universe - E1.31: universe of the first packet
+// sequence - E1.31: sequence counter of the destination, advanced on packet 0 (nullptr = shared counter)
+uint8_t realtimeSendPacket(uint8_t type, IPAddress client, uint16_t length, const uint8_t *buffer, uint8_t bri, bool isRGBW, uint16_t packet, bool push, uint16_t universe, uint8_t *sequence)  {
   if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
 
-  WiFiUDP ddpUdp;
+  const size_t channelCount = length * (isRGBW? 4:3);
+  const size_t perPacket = channelsPerPacket(type, isRGBW);
+  const size_t channel = size_t(packet) * perPacket;
+  if (channel >= channelCount) return 1;
+  const size_t packetSize = min(perPacket, channelCount - channel); // the amount of data is AFTER the header in the current packet
+  const bool lastPacket = channel + packetSize >= channelCount;
 
   switch (type) {
     case 0: // DDP
     {
-      // calculate the number of UDP packets we need to send
-      size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
-      size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
-
-      // there are 3 channels per RGB pixel
-      uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer
-      size_t bufferOffset = 0;
-
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-        if (sequenceNumber > 15) sequenceNumber = 0;
-
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          DEBUG_PRINTLN(F("DDP WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
-
-        // the amount of data is AFTER the header in the current packet
-        size_t packetSize = DDP_CHANNELS_PER_PACKET;
-
-        uint8_t flags = DDP_FLAGS1_VER1;
-        if (currentPacket == (packetCount - 1U)) {
-          // last packet, set the push flag
-          // TODO: determine if we want to send an empty push packet to each destination after sending the pixel data
-          flags = DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH;
-          if (channelCount % DDP_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % DDP_CHANNELS_PER_PACKET;
-          }
-        }
-
-        // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
-        // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
-        // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
-
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("DDP WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
-
-        channel += packetSize;
+      if (sequenceNumber > 15) sequenceNumber = 0;
+      // push flag on the last packet; sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+      // TODO: allow specifying the start channel
+      ddpDataHeader(netPacket, lastPacket && push, sequenceNumber++, isRGBW, channel, packetSize);
+      netFillChannels(netPacket + DDP_HEADER_LEN, buffer + channel, packetSize, bri);
+
+      if (!sendPacket(client, DDP_DEFAULT_PORT, DDP_HEADER_LEN + packetSize)) {  // port defined in ESPAsyncE131.h
+        DEBUG_PRINTLN(F("DDP WiFiUDP send returned an error"));
+        return 1; // problem
       }
     } break;
 
     case 1: //E1.31
     {
+      if (!sequence) sequence = &e131Sequence;
+      if (packet == 0) {
+        e131BuildHeader(); // once per frame, picks up name, priority and sync universe changes
+        (*sequence)++;
+      }
+      if (universe == 0 || universe + packet > E131_MAX_UNIVERSE) return 1;
+      if (!e131SendUniverse(client, universe + packet, *sequence, buffer + channel, packetSize, bri)) {
+        DEBUG_PRINTLN(F("E1.31 WiFiUDP send returned an error"));
+        return 1;
+      }
     } break;
 
     case 2: //ArtNet
     {
-      // calculate the number of UDP packets we need to send
-      const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
-      const size_t ARTNET_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
-      const size_t packetCount = ((channelCount-1)/ARTNET_CHANNELS_PER_PACKET)+1;
-
-      uint32_t channel = 0; 
-      size_t bufferOffset = 0;
-
-      sequenceNumber++;
-
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-
-        if (sequenceNumber > 255) sequenceNumber = 0;
-
-        if (!ddpUdp.beginPacket(client, ARTNET_DEFAULT_PORT)) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.beginPacket returned an error"));
-          return 1; // borked
-        }
-
-        size_t packetSize = ARTNET_CHANNELS_PER_PACKET;
-
-        if (currentPacket == (packetCount - 1U)) {
-          // last packet
-          if (channelCount % ARTNET_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % ARTNET_CHANNELS_PER_PACKET;
-          }
-        }
-
-        byte header_buffer[ART_NET_HEADER_SIZE];
-        memcpy_P(header_buffer, ART_NET_HEADER, ART_NET_HEADER_SIZE);
-        ddpUdp.write(header_buffer, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
-        ddpUdp.write(sequenceNumber & 0xFF); // sequence number. 1..255
-        ddpUdp.write(0x00); // physical - more an FYI, not really used for anything. 0..3
-        ddpUdp.write((currentPacket) & 0xFF); // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
-        ddpUdp.write(0x00); // Universe MSB, unused.
-        ddpUdp.write(0xFF & (packetSize >> 8)); // 16-bit length of channel data, MSB
-        ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
-
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
-
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.endPacket returned an error"));
-          return 1; // borked
-        }
-        channel += packetSize;
+      if (packet == 0) sequenceNumber++;
+      if (sequenceNumber > 255) sequenceNumber = 0;
+
+      memcpy_P(netPacket, ART_NET_HEADER, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
+      netPacket[12] = sequenceNumber & 0xFF; // sequence number. 1..255
+      netPacket[13] = 0x00; // physical - more an FYI, not really used for anything. 0..3
+      netPacket[14] = packet & 0xFF; // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
+      netPacket[15] = 0x00; // Universe MSB, unused.
+      putU16(netPacket + 16, packetSize); // 16-bit length of channel data, MSB first
+      netFillChannels(netPacket + ART_NET_PACKET_HEADER, buffer + channel, packetSize, bri);
+
+      if (!sendPacket(client, ARTNET_DEFAULT_PORT, ART_NET_PACKET_HEADER + packetSize)) {
+        DEBUG_PRINTLN(F("Art-Net WiFiUDP send returned an error"));
+        return 1; // borked
       }
     } break;
+
+    default: return 1;
   }
   return 0;
 }
+
+// WLEDMM latch a frame that was sent in several steps: DDP push, E1.31 universe sync (if enabled), ArtSync
+// returns 0 if a sync packet was sent, 1 on error, 2 if the protocol has nothing to send (E1.31 sync disabled)
+// sequence - E1.31: same counter as passed to realtimeSendPacket() (nullptr = shared counter)
+uint8_t realtimeSendSync(uint8_t type, IPAddress client, const uint8_t *sequence) {
+  if (!(apActive || interfacesInited) || !client[0]) return 1;
+  switch (type) {
+    case 0: // DDP push without data
+      return sendPacket(client, DDP_DEFAULT_PORT, ddpPushPacket(netPacket)) ? 0 : 1;
+    case 1:
+      if (!e131OutSyncUniverse) return 2;
+      return e131SendSync(client, sequence ? *sequence : e131Sequence) ? 0 : 1;
+    case 2: // OpSync: ID, OpCode 0x5200 (little endian), protocol version, 2 aux bytes
+      memcpy_P(netPacket, ART_NET_HEADER, ART_NET_HEADER_SIZE);
+      netPacket[8] = 0x00; netPacket[9] = 0x52;
+      netPacket[12] = 0; netPacket[13] = 0;
+      return sendPacket(client, ARTNET_DEFAULT_PORT, ART_NET_HEADER_SIZE + 2) ? 0 : 1;
+  }
+  return 1;
+}
+
+//
+// Send real time UDP updates to the specified client, all packets of a frame at once
+//
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW, uint16_t universe, uint8_t *sequence)  {
+  uint16_t packetCount = realtimePacketCount(type, length, isRGBW);
+  for (uint16_t packet = 0; packet < packetCount; packet++) {
+    if (realtimeSendPacket(type, client, length, buffer, bri, isRGBW, packet, true, universe, sequence)) return 1;
+  }
+  if (type == 1 && realtimeSendSync(type, client, sequence) == 1) return 1;
+  return packetCount ? 0 : 1;
+}
@@ -239,16 +239,9 @@ uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLe
 {
   if (src == JSON_mode_names || src == nullptr) {
     if (mode < strip.getModeCount()) {
-      char lineBuffer[256] = { '\0' };
-      //strcpy_P(lineBuffer, (const char*)pgm_read_dword(&(WS2812FX::_modeData[mode])));
-      strncpy_P(lineBuffer, strip.getModeData(mode), sizeof(lineBuffer)/sizeof(char)-1);
-      lineBuffer[sizeof(lineBuffer)/sizeof(char)-1] = '\0'; // terminate string
-      size_t len = strlen(lineBuffer);
-      size_t j = 0;
-      for (; j < maxLen && j < len; j++) {
-        if (lineBuffer[j] == '\0' || lineBuffer[j] == '@') break;
-        dest[j] = lineBuffer[j];
-      }
+      // WLEDMM name length is known from addEffect(), copy just the name
+      size_t j = min(size_t(strip.getModeMeta(mode).nameLen), size_t(maxLen));
+      strncpy_P(dest, strip.getModeData(mode), j);
       dest[j] = 0; // terminate string
       return strlen(dest);
     } else return 0;
@@ -370,14 +363,23 @@ uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxL
 int16_t extractModeDefaults(uint8_t mode, const char *segVar)
 {
   if (mode < strip.getModeCount()) {
-    char lineBuffer[256] = { '\0' };
-    strncpy_P(lineBuffer, strip.getModeData(mode), sizeof(lineBuffer)/sizeof(char)-1);
+    // WLEDMM use metadata parsed in addEffect(): skip effects without this default, and only copy the defaults section
+    const mode_meta_t &meta = strip.getModeMeta(mode);
+    int8_t key = WS2812FX::modeDefaultKeyIndex(segVar);
+    if (key >= 0 && (meta.defaultsOfs == 0 || !(meta.defaultsMask & (1 << key)))) return -1;
+    char lineBuffer[64] = { '\0' };
+    if (key >= 0) strncpy_P(lineBuffer, strip.getModeData(mode) + meta.defaultsOfs, sizeof(lineBuffer)/sizeof(char)-1);
+    else {
+      char fullBuffer[256] = { '\0' }; // unknown key: scan whole string as before
+      strncpy_P(fullBuffer, strip.getModeData(mode), sizeof(fullBuffer)/sizeof(char)-1);
+      fullBuffer[sizeof(fullBuffer)/sizeof(char)-1] = '\0';
+      char* startPtr = strrchr(fullBuffer, ';'); // last ";" in FX data
+      if (!startPtr) return -1;
+      strlcpy(lineBuffer, startPtr, sizeof(lineBuffer));
+    }
     lineBuffer[sizeof(lineBuffer)/sizeof(char)-1] = '\0'; // terminate string
     if (lineBuffer[0] != 0) {
-      char* startPtr = strrchr(lineBuffer, ';'); // last ";" in FX data
-      if (!startPtr) return -1;
-
-      char* stopPtr = strstr(startPtr, segVar);
+      char* stopPtr = strstr(lineBuffer, segVar);
       if (!stopPtr) return -1;
 
       stopPtr += strlen(segVar) +1; // skip "="
@@ -398,10 +400,10 @@ void checkSettingsPIN(const char* pin) {
 }
 
 
-uint16_t crc16(const unsigned char* data_p, size_t length) {
+// WLEDMM crc can continue a previous result, to checksum data read in chunks
+uint16_t crc16(const unsigned char* data_p, size_t length, uint16_t crc) {
   uint8_t x;
-  uint16_t crc = 0xFFFF;
-  if (!length) return 0x1D0F;
+  if (!length) return (crc == 0xFFFF) ? 0x1D0F : crc;
   while (length--) {
     x = crc >> 8 ^ *data_p++;
     x ^= x>>4;
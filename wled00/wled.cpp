@@ -14,6 +14,10 @@
 #include "../tools/ESP32-Chip_info.hpp"
 #endif
 
+#if defined(WLEDMM_IDLE_GOVERNOR) && defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_PM_ENABLE)
+#include "esp_pm.h"
+#endif
+
 
 // WLEDMM some buildenv sanity checks
 
@@ -243,6 +247,7 @@ void WLED::loop()
     if (stripMillis > maxStripMillis) maxStripMillis = stripMillis;
     #endif
   }
+  busses.handleNetworkOutput(); // WLEDMM paced network output: also finish a started frame while realtime mode blocks the strip
 
   yield();
 #ifdef ESP8266
@@ -282,16 +287,27 @@ void WLED::loop()
     doInitBusses = false;
     DEBUG_PRINTLN(F("Re-init busses."));
     bool aligned = strip.checkSegmentAlignment(); //see if old segments match old bus(ses)
-    busses.removeAll();
+    unsigned long initStart = micros();  // WLEDMM measure re-init latency and heap churn
+    uint32_t heapBefore = ESP.getFreeHeap();
+    BusConfig *fitting[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES]; // configs that fit into MAX_LED_MEMORY, in order
+    uint8_t numConfigs = 0;
     uint32_t mem = 0;
     for (uint8_t i = 0; i < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; i++) {
       if (busConfigs[i] == nullptr) break;
-      mem += BusManager::memUsage(*busConfigs[i]);
-      if (mem <= MAX_LED_MEMORY) {
-        busses.add(*busConfigs[i]);
+      uint32_t busMem = BusManager::memUsage(*busConfigs[i]);
+      if (mem + busMem > MAX_LED_MEMORY) {
+        USER_PRINTF("Bus %u skipped: needs %u bytes, %u of %u left.\n", i, unsigned(busMem), unsigned(MAX_LED_MEMORY - mem), unsigned(MAX_LED_MEMORY));
+        continue; // a smaller bus further down may still fit
       }
+      mem += busMem;
+      fitting[numConfigs++] = busConfigs[i];
+    }
+    uint8_t created = busses.reconfigure(fitting, numConfigs); // WLEDMM only re-create busses that have changed
+    for (uint8_t i = 0; i < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; i++) {
+      if (busConfigs[i] == nullptr) break;
       delete busConfigs[i]; busConfigs[i] = nullptr;
     }
+    USER_PRINTF("Busses reconfigured: %u of %u re-created in %luus, heap %d bytes.\n", created, numConfigs, micros() - initStart, int(ESP.getFreeHeap()) - int(heapBefore));
     strip.finalizeInit();
     loadLedmap = true;
     if (aligned) strip.makeAutoSegments();
@@ -353,6 +369,9 @@ void WLED::loop()
       DEBUG_PRINT(F("UM time[ms]: "));     DEBUG_PRINT(avgUsermodMillis/loops); DEBUG_PRINT("/");DEBUG_PRINTLN(maxUsermodMillis);
       DEBUG_PRINT(F("Strip time[ms]: "));  DEBUG_PRINT(avgStripMillis/loops); DEBUG_PRINT("/"); DEBUG_PRINTLN(maxStripMillis);
     }
+    #ifdef WLEDMM_IDLE_GOVERNOR
+    DEBUG_PRINT(F("Idle time[s]: "));    DEBUG_PRINT((idleTimeTotal + (idleActive ? millis() - idleSince : 0)) / 1000); DEBUG_PRINT(F(" in ")); DEBUG_PRINT(idleCount); DEBUG_PRINTLN(idleActive ? F(" periods (idle now)") : F(" periods"));
+    #endif
     strip.printSize();
     loops = 0;
     maxUsermodMillis = 0;
@@ -378,6 +397,10 @@ void WLED::loop()
 #endif        // WLED_DEBUG_HEAP
   toki.resetTick();
 
+#ifdef WLEDMM_IDLE_GOVERNOR
+  handleIdle();
+#endif
+
 #if WLED_WATCHDOG_TIMEOUT > 0
   // we finished our mainloop, reset the watchdog timer
   if (!strip.isUpdating())
@@ -410,6 +433,107 @@ void WLED::loop()
 #undef yield  // WLEDMM restore yield()
 #endif
 
+#ifdef WLEDMM_IDLE_GOVERNOR
+// WLEDMM idle governor: when the LEDs show static content (or are off) and nobody is talking to us,
+// loop() slows down and the CPU is allowed to clock down / light-sleep. Any state change, UI or API access ends idle mode.
+#ifndef WLEDMM_IDLE_DELAY_MS
+#define WLEDMM_IDLE_DELAY_MS   25    // max time to wait per loop() in idle mode - buttons and IR are still polled 40 times per second
+#endif
+#ifndef WLEDMM_IDLE_HOLDOFF_MS
+#define WLEDMM_IDLE_HOLDOFF_MS 5000  // nothing must happen for this long before idle mode is entered
+#endif
+#ifndef WLEDMM_IDLE_CPU_MHZ
+#define WLEDMM_IDLE_CPU_MHZ    80    // CPU frequency in idle mode (ESP32 only). 80 keeps APB (RMT, I2S, UART) clocks unchanged.
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+static TaskHandle_t idleLoopTask = nullptr;  // loop() task, woken up by idleWakeup()
+#endif
+
+void idleWakeup() {
+  idleLastActivity = millis();
+  #ifdef ARDUINO_ARCH_ESP32
+  if (idleActive && idleLoopTask) xTaskNotifyGive(idleLoopTask); // cut short the wait in handleIdle()
+  #endif
+}
+
+static void idlePowerSave(bool enable) {
+#ifdef ARDUINO_ARCH_ESP32
+  static uint32_t normalCpuMhz = 0;
+  #if defined(CONFIG_PM_ENABLE)
+    // power management available in this framework build: use DFS and automatic light sleep
+    #if defined(CONFIG_IDF_TARGET_ESP32S3)
+    esp_pm_config_esp32s3_t pm_config;
+    #elif defined(CONFIG_IDF_TARGET_ESP32S2)
+    esp_pm_config_esp32s2_t pm_config;
+    #elif defined(CONFIG_IDF_TARGET_ESP32C3)
+    esp_pm_config_esp32c3_t pm_config;
+    #else
+    esp_pm_config_esp32_t pm_config;
+    #endif
+    if (normalCpuMhz == 0) normalCpuMhz = getCpuFrequencyMhz();
+    pm_config.max_freq_mhz = normalCpuMhz;
+    pm_config.min_freq_mhz = enable ? WLEDMM_IDLE_CPU_MHZ : normalCpuMhz;
+    #if defined(CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+    pm_config.light_sleep_enable = enable && noWifiSleep == false; // light sleep needs WiFi modem sleep
+    #else
+    pm_config.light_sleep_enable = false;
+    #endif
+    esp_err_t err = esp_pm_configure(&pm_config);
+    if (err != ESP_OK) { DEBUG_PRINTF("esp_pm_configure failed (%d)\n", err); }
+  #else
+    // no power management in framework: simple frequency scaling
+    if (enable) {
+      normalCpuMhz = getCpuFrequencyMhz();
+      if (normalCpuMhz > WLEDMM_IDLE_CPU_MHZ) setCpuFrequencyMhz(WLEDMM_IDLE_CPU_MHZ);
+    } else if (normalCpuMhz > 0 && getCpuFrequencyMhz() != normalCpuMhz) {
+      setCpuFrequencyMhz(normalCpuMhz);
+    }
+  #endif
+#endif
+}
+
+// true if the LED output will not change on its own
+bool WLED::isIdle() {
+  if (realtimeMode || transitionActive || nightlightActive || currentPlaylist >= 0) return false;
+  if (doInitBusses || loadLedmap || doSerializeConfig || doReboot || doCloseFile || suspendStripService || OTAisRunning) return false;
+  if (apActive || improvActive || presetsActionPending()) return false;
+  if (offMode) return !strip.isOffRefreshRequired();
+  for (size_t i = 0; i < strip.getSegmentsNum(); i++) {
+    Segment &seg = strip.getSegment(i);
+    if (!seg.isActive() || !seg.on || seg.opacity == 0 || seg.freeze) continue; // segment output does not change
+    if (seg.mode != FX_MODE_STATIC || seg.transitional) return false;
+  }
+  return true;
+}
+
+void WLED::handleIdle() {
+  unsigned long now = millis();
+  if (!isIdle()) idleLastActivity = now;
+  bool idle = (now - idleLastActivity) > WLEDMM_IDLE_HOLDOFF_MS;
+
+  if (idle != idleActive) {
+    if (idle) {
+      idleSince = now;
+      idleCount++;
+    } else {
+      idleTimeTotal += now - idleSince;
+    }
+    idleActive = idle;
+    idlePowerSave(idle);
+    DEBUG_PRINTLN(idle ? F("Idle mode entered.") : F("Idle mode left."));
+  }
+  if (!idleActive) return;
+
+  #ifdef ARDUINO_ARCH_ESP32
+  if (idleLoopTask == nullptr) idleLoopTask = xTaskGetCurrentTaskHandle();
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WLEDMM_IDLE_DELAY_MS)); // blocks loop task, so FreeRTOS idle task can sleep; idleWakeup() ends the wait early
+  #else
+  delay(WLEDMM_IDLE_DELAY_MS); // also lets ESP8266 enter modem sleep
+  #endif
+}
+#endif
+
 void WLED::enableWatchdog() {
 #if WLED_WATCHDOG_TIMEOUT > 0
 #ifdef ARDUINO_ARCH_ESP32
@@ -498,6 +622,9 @@ void WLED::setup()
   #ifdef WLED_RELEASE_NAME
   USER_PRINTF(" WLEDMM_%s %s, build %s.\n", versionString, releaseString, TOSTRING(VERSION)); // WLEDMM specific
   #endif
+  #ifdef WLEDMM_MATH_SELFTEST
+  mathSelfTest(); // WLEDMM fast math accuracy and speed
+  #endif
 
 #ifdef ARDUINO_ARCH_ESP32
   DEBUG_PRINT(F("esp32 "));
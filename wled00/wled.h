@@ -464,6 +464,10 @@ WLED_GLOBAL uint16_t DMXSegmentSpacing _INIT(0);                  // Number of v
 WLED_GLOBAL byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT]; // to detect packet loss
 WLED_GLOBAL bool e131Multicast _INIT(false);                      // multicast or unicast
 WLED_GLOBAL bool e131SkipOutOfSequence _INIT(false);              // freeze instead of flickering
+#ifndef E131_OUTPUT_SYNC_UNIVERSE
+  #define E131_OUTPUT_SYNC_UNIVERSE 0
+#endif
+WLED_GLOBAL uint16_t e131OutSyncUniverse _INIT(E131_OUTPUT_SYNC_UNIVERSE); // WLEDMM E1.31 output: receivers hold the data until a sync on this universe (0 = no sync)
 WLED_GLOBAL uint16_t pollReplyCount _INIT(0);                     // count number of replies for ArtPoll node report
 
 // mqtt
@@ -750,6 +754,14 @@ WLED_GLOBAL volatile bool loadLedmap _INIT(false);          // WLEDMM use as boo
 WLED_GLOBAL volatile uint8_t loadedLedmap _INIT(0);         // WLEDMM default 0
 WLED_GLOBAL volatile bool suspendStripService _INIT(false); // WLEDMM temporarily prevent running strip.service, when strip or segments are "under update" and inconsistent
 WLED_GLOBAL volatile bool OTAisRunning _INIT(false);        // WLEDMM temporarily stop led updates during OTA
+#ifdef WLEDMM_IDLE_GOVERNOR
+// WLEDMM idle governor (see WLED::handleIdle())
+WLED_GLOBAL volatile unsigned long idleLastActivity _INIT(0); // last time something happened that prevents idle mode
+WLED_GLOBAL volatile bool idleActive _INIT(false);          // main loop is running in idle (power save) mode
+WLED_GLOBAL unsigned long idleSince _INIT(0);               // time when idle mode was entered
+WLED_GLOBAL unsigned long idleTimeTotal _INIT(0);           // accumulated time spent in idle mode [ms], excluding current idle period
+WLED_GLOBAL uint32_t idleCount _INIT(0);                    // how often idle mode was entered
+#endif
 #ifndef ESP8266
 WLED_GLOBAL char  *ledmapNames[WLED_MAX_LEDMAPS-1] _INIT_N(({nullptr}));
 #endif
@@ -929,5 +941,9 @@ public:
   void handleStatusLED();
   void enableWatchdog();
   void disableWatchdog();
+  #ifdef WLEDMM_IDLE_GOVERNOR
+  bool isIdle();      // WLEDMM true if LED output will not change without some external event
+  void handleIdle();  // WLEDMM slows down loop() and lowers CPU power when idle
+  #endif
 };
 #endif        // WLED_H
@@ -1,9 +1,14 @@
 /*
  * Contains some trigonometric functions.
  * The ANSI C equivalents are likely faster, but using any sin/cos/tan function incurs a memory penalty of 460 bytes on ESP8266, likely for lookup tables.
- * This implementation has no extra static memory usage.
+ * This implementation uses two small lookup tables (~1KB flash) and no extra RAM.
  *
- * Source of the cos_t() function: https://web.eecs.utk.edu/~azh/blog/cosine.html (cos_taylor_literal_6terms)
+ * WLEDMM fast math: table-driven fixed-point sin/cos and atan2, integer sqrt/hypot and an exp approximation.
+ * Fixed-point angles are uint16_t with 65536 = full circle (same as FastLED sin16), results are Q15 (32767 = 1.0).
+ * sin_t(), cos_t() and atan2_t() are float wrappers around the same tables.
+ *
+ * Max. abs. error vs. libm (checked on the host by test/test_wled_math, on-device with WLEDMM_MATH_SELFTEST):
+ *   sin16_t/cos16_t: 1 LSB (3.2e-5), sin_t/cos_t: 8e-5, atan2_16_t: 1 unit (1e-4 rad), atan2_t: 5e-5 rad, exp_t: rel. 1.2e-4
  */
 
 #include <Arduino.h> //PI constant
@@ -12,33 +17,164 @@
 
 #define modd(x, y) ((x) - (int)((x) / (y)) * (y))
 
-float cos_t(float phi)
-{
-  float x = modd(phi, TWO_PI);
-  if (x < 0) x = -1 * x;
-  int8_t sign = 1;
-  if (x > PI)
-  {
-      x -= PI;
-      sign = -1;
+// quarter sine wave in Q15, 256 steps + 1 for interpolation
+static const int16_t sinQuarterLUT[257] PROGMEM = {
+  0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210, 2410, 2611, 2811, 3012,
+  3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195,
+  6393, 6590, 6786, 6983, 7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+  9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605, 11793, 11980, 12167, 12353,
+  12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828, 14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+  15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+  18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631,
+  20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856, 22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027,
+  23170, 23311, 23452, 23592, 23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+  25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+  27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001, 28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803,
+  28898, 28992, 29085, 29177, 29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+  30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297,
+  31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736, 31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098,
+  32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766,
+  32767,
+};
+
+// atan(i/256) for i = 0..256, in 1/65536 of a full circle (atan(1) = 8192)
+static const uint16_t atanLUT[257] PROGMEM = {
+  0, 41, 81, 122, 163, 204, 244, 285, 326, 367, 407, 448, 489, 529, 570, 610,
+  651, 692, 732, 773, 813, 854, 894, 935, 975, 1015, 1056, 1096, 1136, 1177, 1217, 1257,
+  1297, 1337, 1377, 1417, 1457, 1497, 1537, 1577, 1617, 1656, 1696, 1736, 1775, 1815, 1854, 1894,
+  1933, 1973, 2012, 2051, 2090, 2129, 2168, 2207, 2246, 2285, 2324, 2363, 2401, 2440, 2478, 2517,
+  2555, 2594, 2632, 2670, 2708, 2746, 2784, 2822, 2860, 2897, 2935, 2973, 3010, 3047, 3085, 3122,
+  3159, 3196, 3233, 3270, 3307, 3344, 3380, 3417, 3453, 3490, 3526, 3562, 3599, 3635, 3670, 3706,
+  3742, 3778, 3813, 3849, 3884, 3920, 3955, 3990, 4025, 4060, 4095, 4129, 4164, 4199, 4233, 4267,
+  4302, 4336, 4370, 4404, 4438, 4471, 4505, 4539, 4572, 4605, 4639, 4672, 4705, 4738, 4771, 4803,
+  4836, 4869, 4901, 4933, 4966, 4998, 5030, 5062, 5094, 5125, 5157, 5188, 5220, 5251, 5282, 5313,
+  5344, 5375, 5406, 5437, 5467, 5498, 5528, 5559, 5589, 5619, 5649, 5679, 5708, 5738, 5768, 5797,
+  5826, 5856, 5885, 5914, 5943, 5972, 6000, 6029, 6058, 6086, 6114, 6142, 6171, 6199, 6227, 6254,
+  6282, 6310, 6337, 6365, 6392, 6419, 6446, 6473, 6500, 6527, 6554, 6580, 6607, 6633, 6660, 6686,
+  6712, 6738, 6764, 6790, 6815, 6841, 6867, 6892, 6917, 6943, 6968, 6993, 7018, 7043, 7068, 7092,
+  7117, 7141, 7166, 7190, 7214, 7238, 7262, 7286, 7310, 7334, 7358, 7381, 7405, 7428, 7451, 7475,
+  7498, 7521, 7544, 7566, 7589, 7612, 7635, 7657, 7679, 7702, 7724, 7746, 7768, 7790, 7812, 7834,
+  7856, 7877, 7899, 7920, 7942, 7963, 7984, 8005, 8026, 8047, 8068, 8089, 8110, 8131, 8151, 8172,
+  8192,
+};
+
+// sin(theta) with theta in 1/65536 of a full circle, result -32767..32767
+int16_t sin16_t(uint16_t theta) {
+  uint_fast16_t idx = theta & 0x3FFF;           // position inside quarter wave
+  if (theta & 0x4000) idx = 0x4000 - idx;       // 2nd and 4th quarter: mirror
+  uint_fast16_t i    = idx >> 6;                // table index 0..256
+  uint_fast16_t frac = idx & 0x3F;              // 6 bit interpolation
+  int_fast32_t res = (int16_t)pgm_read_word(&sinQuarterLUT[i]);
+  if (frac) {
+    int_fast32_t next = (int16_t)pgm_read_word(&sinQuarterLUT[i+1]);
+    res += ((next - res) * frac + 32) >> 6;
   }
-  float xx = x * x;
+  return (theta & 0x8000) ? -res : res;         // 3rd and 4th quarter: negative
+}
 
-  float res = sign * (1 - ((xx) / (2)) + ((xx * xx) / (24)) - ((xx * xx * xx) / (720)) + ((xx * xx * xx * xx) / (40320)) - ((xx * xx * xx * xx * xx) / (3628800)) + ((xx * xx * xx * xx * xx * xx) / (479001600)));
-  #ifdef WLED_DEBUG_MATH
-  Serial.printf("cos: %f,%f,%f,(%f)\n",phi,res,cos(x),res-cos(x));
-  #endif
+int16_t cos16_t(uint16_t theta) {
+  return sin16_t(theta + 16384);
+}
+
+// angle of vector (x,y) in 1/65536 of a full circle, counter-clockwise from x axis (atan2(y,x) = 0..2*PI)
+uint16_t atan2_16_t(int32_t y, int32_t x) {
+  if (x == 0 && y == 0) return 0;
+  uint32_t ax = (x < 0) ? -x : x;
+  uint32_t ay = (y < 0) ? -y : y;
+  bool swapped = ay > ax;
+  uint32_t num = swapped ? ax : ay;
+  uint32_t den = swapped ? ay : ax;
+  while (den > 0x7FFF) { num >>= 1; den >>= 1; } // keep (num << 16) within 32 bits
+  uint32_t ratio = (num << 16) / den;           // Q16, 0..65536
+  uint_fast16_t i    = ratio >> 8;
+  uint_fast16_t frac = ratio & 0xFF;
+  uint32_t angle = pgm_read_word(&atanLUT[i]);
+  if (frac) {
+    uint32_t next = pgm_read_word(&atanLUT[i+1]);
+    angle += ((next - angle) * frac + 128) >> 8;
+  }
+  if (swapped) angle = 16384 - angle;           // 45..90 deg
+  if (x < 0)   angle = 32768 - angle;           // 2nd quadrant
+  if (y < 0)   angle = 65536 - angle;           // 3rd and 4th quadrant
+  return angle;                                 // 65536 wraps to 0
+}
+
+// integer square root, rounded down
+uint32_t sqrt32_t(uint32_t x) {
+  uint32_t res = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > x) bit >>= 2;
+  while (bit) {
+    if (x >= res + bit) {
+      x -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
   return res;
 }
 
+// length of vector (dx,dy); dx and dy must be within +/-32767
+uint32_t hypot_t(int32_t dx, int32_t dy) {
+  return sqrt32_t(uint32_t(dx*dx) + uint32_t(dy*dy));
+}
+
+// radians to 1/65536 of a full circle
+static inline uint16_t rad2angle16(float rad) {
+  if (fabsf(rad) > 100000.0f) rad = modd(rad, TWO_PI); // avoid int overflow
+  float a = rad * (65536.0f / TWO_PI);
+  return uint16_t(int32_t(a + ((a < 0) ? -0.5f : 0.5f))); // round to nearest
+}
+
 float sin_t(float x) {
-  float res =  cos_t(HALF_PI - x);
+  float res = sin16_t(rad2angle16(x)) * (1.0f / 32767.0f);
   #ifdef WLED_DEBUG_MATH
   Serial.printf("sin: %f,%f,%f,(%f)\n",x,res,sin(x),res-sin(x));
   #endif
   return res;
 }
 
+float cos_t(float phi) {
+  float res = cos16_t(rad2angle16(phi)) * (1.0f / 32767.0f);
+  #ifdef WLED_DEBUG_MATH
+  Serial.printf("cos: %f,%f,%f,(%f)\n",phi,res,cos(phi),res-cos(phi));
+  #endif
+  return res;
+}
+
+// same range as atan2f(): -PI..PI
+float atan2_t(float y, float x) {
+  float ax = fabsf(x);
+  float ay = fabsf(y);
+  if (ax == 0.0f && ay == 0.0f) return 0.0f;
+  bool swapped = ay > ax;
+  float pos = (swapped ? ax / ay : ay / ax) * 256.0f; // 0..256
+  unsigned i = pos;
+  float res = pgm_read_word(&atanLUT[i]);
+  if (i < 256) res += (float(pgm_read_word(&atanLUT[i+1])) - res) * (pos - i);
+  res *= (TWO_PI / 65536.0f);                   // to radians
+  if (swapped) res = HALF_PI - res;
+  if (x < 0)   res = PI - res;
+  if (y < 0)   res = -res;
+  return res;
+}
+
+// e^x, using 2^(x*log2(e)): integer part goes into the float exponent, fractional part by polynomial
+float exp_t(float x) {
+  if (x < -87.0f) return 0.0f;
+  if (x >  88.0f) x = 88.0f;                    // avoid overflow to inf
+  float t = x * 1.44269504f;                    // log2(e)
+  int_fast32_t ipart = (t < 0) ? int_fast32_t(t) - 1 : int_fast32_t(t); // floor
+  float f = t - ipart;                          // 0..1
+  float p = 1.0f + f * (0.695556856f + f * (0.226173572f + f * 0.0781455737f)); // 2^f
+  union { float f; int32_t i; } u = { p };
+  u.i += int32_t(uint32_t(ipart) << 23);        // * 2^ipart (shift unsigned, ipart may be negative)
+  return u.f;
+}
+
 float tan_t(float x) {
   float c = cos_t(x);
   if (c==0.0f) return 0;
@@ -137,3 +273,48 @@ float fmod_t(float num, float denom) {
   #endif
   return res;
 }
+
+#ifdef WLEDMM_MATH_SELFTEST
+// WLEDMM compare fast math against libm, and measure CPU cycles per call. Prints results to Serial.
+static float mathTestSink = 0; // prevents the compiler from optimizing away the benchmark loops
+
+#define MATH_BENCH(name, expr) { \
+    uint32_t cycles = ESP.getCycleCount(); \
+    for (int n = 0; n < 1000; n++) { float x = n * 0.0123f - 6.0f; (void)x; mathTestSink += (expr); } \
+    cycles = ESP.getCycleCount() - cycles; \
+    Serial.printf("  %-12s %5u cycles/call\n", name, (unsigned)(cycles / 1000)); \
+  }
+
+void mathSelfTest() {
+  float errSin = 0, errAtan = 0, errExp = 0;
+  for (float x = -10.0f; x < 10.0f; x += 0.001f) {
+    errSin = max(errSin, fabsf(sin_t(x) - sinf(x)));
+    errSin = max(errSin, fabsf(cos_t(x) - cosf(x)));
+  }
+  for (float y = -20.0f; y <= 20.0f; y += 0.37f)
+    for (float x = -20.0f; x <= 20.0f; x += 0.29f) {
+      float d = fabsf(atan2_t(y, x) - atan2f(y, x));
+      if (d > PI) d = TWO_PI - d;
+      errAtan = max(errAtan, d);
+    }
+  for (float x = -20.0f; x < 20.0f; x += 0.01f) errExp = max(errExp, fabsf(exp_t(x) / expf(x) - 1.0f));
+  uint32_t sqrtFail = 0;
+  for (uint32_t x = 0; x < 100000; x++) { uint32_t r = sqrt32_t(x); if (r*r > x || (r+1)*(r+1) <= x) sqrtFail++; }
+
+  Serial.println(F("Fast math self test - max error vs. libm:"));
+  Serial.printf("  sin_t/cos_t %.6f, atan2_t %.6f rad, exp_t %.6f (rel), sqrt32_t %u failures\n", errSin, errAtan, errExp, (unsigned)sqrtFail);
+  Serial.println(F("Fast math self test - speed:"));
+  MATH_BENCH("sinf",       sinf(x));
+  MATH_BENCH("sin_t",      sin_t(x));
+  MATH_BENCH("sin16_t",    sin16_t(n * 65));
+  MATH_BENCH("atan2f",     atan2f(x, 1.5f));
+  MATH_BENCH("atan2_t",    atan2_t(x, 1.5f));
+  MATH_BENCH("atan2_16_t", atan2_16_t(n - 500, 300));
+  MATH_BENCH("sqrtf",      sqrtf(n * 17.0f));
+  MATH_BENCH("sqrt32_t",   sqrt32_t(n * 17));
+  MATH_BENCH("expf",       expf(x));
+  MATH_BENCH("exp_t",      exp_t(x));
+  if (mathTestSink == 42.0f) Serial.println(); // use the sink
+}
+#undef MATH_BENCH
+#endif
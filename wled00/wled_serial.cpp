@@ -42,9 +42,9 @@ void updateBaudRate(uint32_t rate){
 // RGB LED data return as JSON array. Slow, but easy to use on the other end.
 void sendJSON(){
   if (!pinManager.isPinAllocated(hardwareTX) || pinManager.getPinOwner(hardwareTX) == PinOwner::DebugOut) {
-    uint16_t used = strip.getLengthTotal();
+    pixidx_t used = strip.getLengthTotal();
     Serial.write('[');
-    for (uint16_t i=0; i<used; i++) {
+    for (pixidx_t i=0; i<used; i++) {
       Serial.print(strip.getPixelColor(i));
       if (i != used-1) Serial.write(',');
     }
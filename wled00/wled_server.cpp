@@ -50,6 +50,7 @@ void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t
     DEBUG_PRINT(F("Uploading "));
     DEBUG_PRINTLN(finalname);
     if (finalname.equals("/presets.json")) presetsModifiedTime = toki.second();
+    if (finalname.startsWith(F("/palette"))) WS2812FX::removeCustomPaletteBin(finalname.c_str()); // WLEDMM binary copy is outdated
   }
   if (len) {
     request->_tempFile.write(data,len);
@@ -17,6 +17,7 @@ static volatile unsigned long wsLastLiveTime = 0;   // WLEDMM
 
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
+  idleWakeup(); // WLEDMM UI activity
   if(type == WS_EVT_CONNECT){
     //client connected
     DEBUG_PRINTLN(F("WS client connected."));
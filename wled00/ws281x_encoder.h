@@ -0,0 +1,100 @@
+#ifndef WS281X_ENCODER_H
+#define WS281X_ENCODER_H
+
+/*
+ * WLEDMM WS281x bit encoder: turns a buffer of RGB pixels into RMT items (one 32 bit item per bit on the wire),
+ * applying color order, brightness and direction on the fly. Used by BusRmtDirect (bus_manager.cpp) from the RMT
+ * driver's translator callback, so the pixels are stored only once and never copied into an intermediate buffer.
+ * Plain C++ without Arduino or IDF dependencies, tested on the host (see test/test_ws281x_encoder).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+// bit timing in RMT ticks: high and low time of a 0 bit and a 1 bit
+typedef struct WS281xTiming {
+  uint16_t t0h, t0l, t1h, t1l;
+} ws281x_timing_t;
+
+#define WS281X_RMT_CLK_DIV 2  // 80MHz APB clock / 2 = 25ns per tick
+static const ws281x_timing_t WS2812X_TIMING = {16, 34, 32, 18}; // 400/850ns and 800/450ns, same as NeoPixelBus Ws2812x
+
+#define WS281X_MAX_ORDER_RANGES 10 // same as WLED_MAX_COLOR_ORDER_MAPPINGS
+
+class WS281xEncoder {
+  public:
+    // pixels: len * 3 bytes in R,G,B order; colorOrder: COL_ORDER_* (const.h); bri: scaled like NeoPixelBusLg luminance
+    void begin(const uint8_t *pixels, uint16_t len, uint8_t colorOrder, uint8_t bri, bool reversed, const ws281x_timing_t &timing) {
+      _pixels = pixels; _len = len; _bri = bri; _reversed = reversed;
+      _bit0 = item(timing.t0h, timing.t0l);
+      _bit1 = item(timing.t1h, timing.t1l);
+      _colorOrder = colorOrder & 0x0F;
+      _numRanges = 0;
+    }
+
+    // different color order for LEDs [start, start+len) counted on the wire (see ColorOrderMap); first match wins
+    bool addColorOrderRange(uint16_t start, uint16_t len, uint8_t colorOrder) {
+      if (_numRanges >= WS281X_MAX_ORDER_RANGES || len == 0) return false;
+      _ranges[_numRanges++] = {start, uint16_t(start + len), uint8_t(colorOrder & 0x0F)};
+      return true;
+    }
+
+    size_t size() const { return size_t(_len) * 3; } // bytes on the wire
+
+    // ofs-th byte sent on the wire
+    uint8_t wireByte(size_t ofs) const {
+      uint16_t wirePix = ofs / 3;
+      uint16_t pix = _reversed ? _len - 1 - wirePix : wirePix;
+      uint8_t  c = _pixels[size_t(pix) * 3 + componentAt(orderAt(wirePix), ofs % 3)];
+      return (uint16_t(c) * (uint16_t(_bri) + 1)) >> 8; // same as NeoPixelBusLg Dim()
+    }
+
+    // encodes count wire bytes starting at ofs into count*8 items (MSB first), returns the number of bytes encoded
+    size_t encode(size_t ofs, size_t count, uint32_t *items) const {
+      if (ofs >= size()) return 0;
+      if (count > size() - ofs) count = size() - ofs;
+      for (size_t i = 0; i < count; i++) {
+        uint8_t b = wireByte(ofs + i);
+        for (uint8_t mask = 0x80; mask; mask >>= 1) *items++ = (b & mask) ? _bit1 : _bit0;
+      }
+      return count;
+    }
+
+    // RMT item: level 1 for high ticks, then level 0 for low ticks (rmt_item32_t layout)
+    static uint32_t item(uint16_t high, uint16_t low) {
+      return uint32_t(high & 0x7FFF) | 0x8000u | (uint32_t(low & 0x7FFF) << 16);
+    }
+
+  private:
+    struct Range { uint16_t start, end; uint8_t colorOrder; };
+
+    const uint8_t *_pixels = nullptr;
+    uint16_t _len = 0;
+    uint8_t  _bri = 255;
+    bool     _reversed = false;
+    uint8_t  _colorOrder = 0;
+    uint32_t _bit0 = 0, _bit1 = 0;
+    Range    _ranges[WS281X_MAX_ORDER_RANGES];
+    uint8_t  _numRanges = 0;
+
+    uint8_t orderAt(uint16_t wirePix) const {
+      for (uint8_t i = 0; i < _numRanges; i++)
+        if (wirePix >= _ranges[i].start && wirePix < _ranges[i].end) return _ranges[i].colorOrder;
+      return _colorOrder;
+    }
+
+    // index into R,G,B of the n-th byte sent for a color order
+    static uint8_t componentAt(uint8_t colorOrder, uint8_t n) {
+      static const uint8_t orders[6][3] = {
+        {1, 0, 2}, // COL_ORDER_GRB
+        {0, 1, 2}, // COL_ORDER_RGB
+        {2, 0, 1}, // COL_ORDER_BRG
+        {0, 2, 1}, // COL_ORDER_RBG
+        {2, 1, 0}, // COL_ORDER_BGR
+        {1, 2, 0}, // COL_ORDER_GBR
+      };
+      return orders[colorOrder < 6 ? colorOrder : 0][n];
+    }
+};
+
+#endif
@@ -416,6 +416,7 @@ void getSettingsJS(AsyncWebServerRequest* request, byte subPage, char* dest) //W
     sappend('v',SET_F("FR"),strip.getTargetFps());
     sappend('v',SET_F("AW"),Bus::getGlobalAWMode());
     sappend('c',SET_F("LD"),strip.useLedsArray);
+    sappend('c',SET_F("AQ"),strip.adaptiveQuality); // WLEDMM
 
     for (uint8_t s=0; s < busses.getNumBusses(); s++) {
       Bus* bus = busses.getBus(s);
@@ -431,6 +432,9 @@ void getSettingsJS(AsyncWebServerRequest* request, byte subPage, char* dest) //W
       char aw[4] = "AW"; aw[2] = 48+s; aw[3] = 0; //auto white mode
       char wo[4] = "WO"; wo[2] = 48+s; wo[3] = 0; //swap channels
       char sp[4] = "SP"; sp[2] = 48+s; sp[3] = 0; //bus clock speed
+      char ma[4] = "MA"; ma[2] = 48+s; ma[3] = 0; //WLEDMM own current budget
+      char il[4] = "IL"; il[2] = 48+s; il[3] = 0; //WLEDMM LEDs per power injection group
+      char un[4] = "UN"; un[2] = 48+s; un[3] = 0; //WLEDMM E1.31 start universe
       oappend(SET_F("addLEDs(1);"));
       uint8_t pins[5];
       uint8_t nPins = bus->getPins(pins);
@@ -447,6 +451,9 @@ void getSettingsJS(AsyncWebServerRequest* request, byte subPage, char* dest) //W
       sappend('c',rf,bus->isOffRefreshRequired());
       sappend('v',aw,bus->getAutoWhiteMode());
       sappend('v',wo,bus->getColorOrder() >> 4);
+      sappend('v',ma,bus->getMaxCurrent());
+      sappend('v',il,bus->getInjectLength());
+      if (bus->getStartUniverse()) sappend('v',un,bus->getStartUniverse());
       uint16_t speed = bus->getFrequency();
       if (bus->getType() > TYPE_ONOFF && bus->getType() < 48) {
         switch (speed) {
@@ -475,6 +482,7 @@ void getSettingsJS(AsyncWebServerRequest* request, byte subPage, char* dest) //W
 
     }
     sappend('v',SET_F("MA"),strip.ablMilliampsMax);
+    sappend('v',SET_F("SY"),e131OutSyncUniverse); // WLEDMM
     sappend('v',SET_F("LA"),strip.milliampsPerLed);
     if (strip.currentMilliamps)
     {